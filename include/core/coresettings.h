@@ -41,6 +41,12 @@ enum CoreSettings : uint32_t
     GaplessPlayback     = 10 | Type::Bool,
     Language            = 11 | Type::String,
     BufferLength        = 12 | Type::Int,
+    NextTrackPreload    = 13 | Type::Int,
+    CrossfadeLength     = 14 | Type::Int,
+    FadeLength          = 15 | Type::Int,
+    ReplayGainMode      = 16 | Type::Int,
+    ReplayGainPreamp    = 17 | Type::Double,
+    ReplayGainNoClip    = 18 | Type::Bool,
 };
 Q_ENUM_NS(CoreSettings)
 } // namespace Fooyin::Settings::Core
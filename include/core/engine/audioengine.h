@@ -24,6 +24,7 @@
 #include <core/engine/outputplugin.h>
 
 namespace Fooyin {
+class AudioBuffer;
 class Track;
 
 enum class PlaybackState
@@ -58,6 +59,12 @@ public:
     virtual void changeTrack(const Track& track) = 0;
     virtual void setState(PlaybackState state)   = 0;
 
+    /*!
+     * Opens @p track ahead of time, off the engine thread, so it can follow the current track without a gap.
+     * Called in response to trackAboutToFinish with the track scheduled to play next.
+     */
+    virtual void prepareNextTrack(const Track& track) = 0;
+
     virtual void play()  = 0;
     virtual void pause() = 0;
     virtual void stop()  = 0;
@@ -67,10 +74,16 @@ public:
     virtual void setAudioOutput(const OutputCreator& output) = 0;
     virtual void setOutputDevice(const QString& device)      = 0;
 
+    /** Enables or disables emitting decoded buffers through pcmDecoded. */
+    virtual void setPcmTapEnabled(bool enabled) = 0;
+
 signals:
     void stateChanged(PlaybackState state);
     void trackStatusChanged(TrackStatus status);
     void positionChanged(uint64_t ms);
     void trackAboutToFinish();
+
+    void pcmDecoded(const Fooyin::Track& track, const Fooyin::AudioBuffer& buffer);
+    void pcmTapInterrupted(const Fooyin::Track& track);
 };
 } // namespace Fooyin
@@ -28,11 +28,14 @@
 #include <QString>
 
 namespace Fooyin {
+// Sample counts here and in AudioOutput are per channel, i.e. frames
 struct OutputState
 {
     int freeSamples{0};
     int queuedSamples{0};
     double delay{0.0};
+    // Number of times the driver ran out of audio since init
+    int underruns{0};
 };
 
 struct OutputDevice
@@ -109,7 +112,7 @@ public:
      * Writes the audio data contained in the @p buffer to the audio driver.
      * @note this will only be called if @fn initialised returns @c true.
      * @note this may be called before @fn start to prefill the buffer.
-     * @returns the number of samples written.
+     * @returns the number of frames written, which may be less than the buffer if the driver is full.
      */
     virtual int write(const AudioBuffer& buffer) = 0;
     virtual void setPaused(bool pause)           = 0;
@@ -0,0 +1,56 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fycore_export.h"
+
+#include <span>
+
+namespace Fooyin {
+class AudioFormat;
+
+/*!
+ * A processing stage run by the renderer on each block of audio before it is written to the output.
+ * Blocks are interleaved float samples, nominally in the range [-1, 1].
+ */
+class FYCORE_EXPORT DspNode
+{
+public:
+    virtual ~DspNode() = default;
+
+    /*!
+     * Called when the renderer is initialised for @p format.
+     * Blocks passed to process will hold at most @p maxFrames frames, so any buffers should be allocated here.
+     */
+    virtual void prepare(const AudioFormat& format, int maxFrames) = 0;
+
+    /** Returns @c true if the node would change the next block. Inactive nodes are skipped. */
+    [[nodiscard]] virtual bool isActive() const = 0;
+
+    /*!
+     * Processes a block of @p samples in place.
+     * @note this is called on the audio path, so must not allocate, lock or block.
+     */
+    virtual void process(std::span<float> samples) = 0;
+
+    /** Clears any state carried between blocks. */
+    virtual void reset() = 0;
+};
+} // namespace Fooyin
@@ -28,7 +28,10 @@
 
 namespace Fooyin {
 struct AudioOutputBuilder;
+class AudioBuffer;
 class AudioDecoder;
+class Track;
+struct EngineMetrics;
 
 using OutputNames = std::vector<QString>;
 
@@ -55,10 +58,35 @@ public:
 
     virtual std::unique_ptr<AudioDecoder> createDecoder() = 0;
 
+    /** Opens @p track ahead of time so it can follow the current track without a gap. */
+    virtual void prepareNextTrack(const Track& track) = 0;
+
+    /*!
+     * Registers a consumer of the audio decoded for playback.
+     * pcmDecoded is only emitted while at least one consumer is registered.
+     * @note each call must be balanced by a call to unregisterPcmTap.
+     */
+    virtual void registerPcmTap()   = 0;
+    virtual void unregisterPcmTap() = 0;
+
+    /** Returns the playback pipeline metrics. These are updated live from the engine thread. */
+    [[nodiscard]] virtual const EngineMetrics& metrics() const = 0;
+    /** Clears all collected metrics. */
+    virtual void resetMetrics() = 0;
+
 signals:
     void outputChanged(const QString& output);
     void deviceChanged(const QString& device);
     void trackStatusChanged(TrackStatus status);
     void trackAboutToFinish();
+
+    /*!
+     * Emitted with each buffer decoded for playback of @p track, if playback started from the beginning.
+     * An invalid @p buffer marks the end of the track.
+     * @note this is emitted from the engine thread.
+     */
+    void pcmDecoded(const Fooyin::Track& track, const Fooyin::AudioBuffer& buffer);
+    /** Emitted if decoding of @p track stops before reaching the end (seek, stop or track change). */
+    void pcmTapInterrupted(const Fooyin::Track& track);
 };
 } // namespace Fooyin
@@ -0,0 +1,131 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fycore_export.h"
+
+#include <QJsonObject>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+
+namespace Fooyin {
+/*!
+ * A lock-free histogram with power-of-two buckets.
+ * Bucket 0 holds zero, bucket n holds values in [2^(n-1), 2^n).
+ */
+class FYCORE_EXPORT MetricHistogram
+{
+public:
+    static constexpr size_t BucketCount = 40;
+
+    struct Snapshot
+    {
+        uint64_t count{0};
+        uint64_t sum{0};
+        uint64_t max{0};
+        std::array<uint64_t, BucketCount> buckets{};
+
+        [[nodiscard]] double mean() const;
+        /** Returns the upper bound of the bucket containing the @p percentile (0-100) value. */
+        [[nodiscard]] uint64_t percentile(double percentile) const;
+
+        [[nodiscard]] QJsonObject toJson() const;
+    };
+
+    void record(uint64_t value);
+    void reset();
+
+    [[nodiscard]] Snapshot snapshot() const;
+
+private:
+    std::array<std::atomic<uint64_t>, BucketCount> m_buckets{};
+    std::atomic<uint64_t> m_count{0};
+    std::atomic<uint64_t> m_sum{0};
+    std::atomic<uint64_t> m_max{0};
+};
+
+/*!
+ * Always-on counters for the playback pipeline.
+ * All members may be updated from any thread without locking.
+ */
+struct FYCORE_EXPORT EngineMetrics
+{
+    struct Snapshot
+    {
+        MetricHistogram::Snapshot decodeTime;
+        MetricHistogram::Snapshot queueDepth;
+        MetricHistogram::Snapshot outputDelay;
+        MetricHistogram::Snapshot clockDrift;
+        MetricHistogram::Snapshot trackOpenTime;
+
+        uint64_t buffersDecoded{0};
+        uint64_t outputFull{0};
+        uint64_t queueUnderruns{0};
+        uint64_t outputUnderruns{0};
+        uint64_t preopenedTracks{0};
+        uint64_t gaplessTransitions{0};
+
+        uint64_t currentQueueDepth{0};
+        uint64_t currentOutputDelay{0};
+        int64_t currentClockDrift{0};
+
+        [[nodiscard]] QJsonObject toJson() const;
+    };
+
+    /** Time spent in AudioDecoder::readBuffer, in microseconds. */
+    MetricHistogram decodeTime;
+    /** Audio queued in the renderer waiting for the output, in milliseconds. */
+    MetricHistogram queueDepth;
+    /** Delay reported by the output, in microseconds. */
+    MetricHistogram outputDelay;
+    /** Absolute difference between the playback clock and the position heard from the output, in milliseconds. */
+    MetricHistogram clockDrift;
+    /** Time spent opening a track in the decoder, in microseconds. */
+    MetricHistogram trackOpenTime;
+
+    std::atomic<uint64_t> buffersDecoded{0};
+    /** Number of renderer writes which found the output had no free space. */
+    std::atomic<uint64_t> outputFull{0};
+    /** Number of times the renderer ran out of decoded audio while playing. */
+    std::atomic<uint64_t> queueUnderruns{0};
+    /** Underruns reported by the output since it was initialised. */
+    std::atomic<uint64_t> outputUnderruns{0};
+    /** Number of track changes which used a decoder opened ahead of time. */
+    std::atomic<uint64_t> preopenedTracks{0};
+    /** Number of track changes where the next track's audio was queued directly after the previous. */
+    std::atomic<uint64_t> gaplessTransitions{0};
+
+    std::atomic<uint64_t> currentQueueDepth{0};
+    std::atomic<uint64_t> currentOutputDelay{0};
+    std::atomic<int64_t> currentClockDrift{0};
+
+    void recordDecode(std::chrono::nanoseconds time);
+    void recordQueueDepth(uint64_t ms);
+    void recordOutputDelay(double seconds);
+    void recordClockDrift(int64_t drift);
+    void recordTrackOpen(std::chrono::nanoseconds time);
+
+    void reset();
+
+    [[nodiscard]] Snapshot snapshot() const;
+};
+} // namespace Fooyin
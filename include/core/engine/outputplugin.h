@@ -44,6 +44,15 @@ public:
      * returns a unique_ptr to an AudioOutput subclass.
      */
     virtual AudioOutputBuilder registerOutput() = 0;
+
+    /*!
+     * Returns every output this plugin provides.
+     * By default, this is just the output returned by registerOutput.
+     */
+    virtual std::vector<AudioOutputBuilder> registerOutputs()
+    {
+        return {registerOutput()};
+    }
 };
 } // namespace Fooyin
 
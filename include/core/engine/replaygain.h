@@ -0,0 +1,48 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fycore_export.h"
+
+#include <core/trackfwd.h>
+
+namespace Fooyin::ReplayGain {
+enum class Mode
+{
+    None = 0,
+    Track,
+    Album,
+};
+
+constexpr auto TrackGainTag = "REPLAYGAIN_TRACK_GAIN";
+constexpr auto TrackPeakTag = "REPLAYGAIN_TRACK_PEAK";
+constexpr auto AlbumGainTag = "REPLAYGAIN_ALBUM_GAIN";
+constexpr auto AlbumPeakTag = "REPLAYGAIN_ALBUM_PEAK";
+
+/** Loudness tracks are normalised to, in LUFS (ReplayGain 2.0). */
+constexpr double ReferenceLoudness = -18.0;
+
+/*!
+ * Returns the linear gain to play @p track at, from its ReplayGain tags.
+ * Falls back to the other gain type if the preferred one is missing, and returns 1.0 if the track has neither.
+ * If @p preventClipping is set, the gain is limited so the tagged peak doesn't exceed full scale.
+ */
+FYCORE_EXPORT float playbackGain(const Track& track, Mode mode, double preampDb, bool preventClipping);
+} // namespace Fooyin::ReplayGain
@@ -0,0 +1,64 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fycore_export.h"
+
+#include <core/trackfwd.h>
+
+#include <QObject>
+
+#include <memory>
+
+class QThreadPool;
+
+namespace Fooyin {
+/*!
+ * Analyses the loudness of tracks in parallel and sets their ReplayGain tags.
+ * Tracks sharing an album are given album gain and peak from their combined audio.
+ * The tags are not written to file; pass the returned tracks to MusicLibrary::updateTrackMetadata.
+ */
+class FYCORE_EXPORT ReplayGainScanner : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ReplayGainScanner(QObject* parent = nullptr);
+    ~ReplayGainScanner() override;
+
+    [[nodiscard]] bool isScanning() const;
+
+    /** Starts scanning @p tracks on the global thread pool. Any scan in progress is cancelled. */
+    void scan(const TrackList& tracks);
+    void cancel();
+
+    /** Scans @p tracks on @p pool, blocking until finished. */
+    static TrackList scanBlocking(const TrackList& tracks, QThreadPool* pool);
+
+signals:
+    void progressChanged(int scanned, int total);
+    /** Emitted with the tracks that could be analysed, with their ReplayGain tags set. */
+    void finished(const TrackList& tracks);
+
+private:
+    struct Private;
+    std::unique_ptr<Private> p;
+};
+} // namespace Fooyin
@@ -27,6 +27,7 @@
 
 namespace Fooyin {
 struct LibraryInfo;
+class TrackSearchIndex;
 
 /*!
  * There are two types of scan request:
@@ -47,6 +48,18 @@ struct ScanRequest
     std::function<void()> cancel;
 };
 
+/*!
+ * A queued request to write metadata to files and the database.
+ * Progress is reported through writeProgress. Written tracks are emitted together through tracksUpdated,
+ * followed by writeFinished once the request has finished or been cancelled.
+ * Tracks not yet written when cancel() is called are left untouched.
+ */
+struct WriteRequest
+{
+    int id{-1};
+    std::function<void()> cancel;
+};
+
 /*!
  * Represents a music library containing Track objects.
  * Acts as a unified library view for all tracks in all libraries,
@@ -89,14 +102,22 @@ public:
     /** Returns a TrackList containing each track (if) found with an id from @p ids  */
     [[nodiscard]] virtual TrackList tracksForIds(const TrackIds& ids) const = 0;
 
-    /** Updates the metdata in the database for @p tracks and writes metdata to files  */
-    virtual void updateTrackMetadata(const TrackList& tracks) = 0;
+    /** Returns the search index of all tracks, kept up to date as tracks are loaded, added, updated and deleted */
+    [[nodiscard]] virtual const TrackSearchIndex& searchIndex() const = 0;
+
+    /*!
+     * Updates the metdata in the database for @p tracks and writes metdata to files.
+     * @returns a WriteRequest representing the queued write operation.
+     */
+    virtual WriteRequest updateTrackMetadata(const TrackList& tracks) = 0;
 
     /** Updates the statistics (playcount, rating etc) in the database for @p track  */
     virtual void updateTrackStats(const Track& track) = 0;
 
 signals:
     void scanProgress(int id, int percent);
+    void writeProgress(int id, int percent);
+    void writeFinished(int id);
     void tracksScanned(int id, const TrackList& tracks);
 
     void tracksLoaded(const TrackList& tracks);
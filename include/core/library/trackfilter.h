@@ -23,8 +23,14 @@
 
 #include <core/trackfwd.h>
 
+#include <functional>
+
 class QString;
 
+namespace Fooyin {
+class TrackSearchIndex;
+} // namespace Fooyin
+
 namespace Fooyin::Filter {
 /*!
  * Filters @p tracks using the @p search string
@@ -40,4 +46,29 @@ namespace Fooyin::Filter {
  * @returns a new TrackList containing the tracks which match @p search
  */
 FYCORE_EXPORT TrackList filterTracks(const TrackList& tracks, const QString& search);
+
+/*!
+ * Filters @p tracks using the @p search string, periodically checking @p isCancelled
+ * so that a long running filter can be abandoned.
+ * @returns a new TrackList containing the tracks which match @p search, or an empty list if cancelled.
+ */
+FYCORE_EXPORT TrackList filterTracks(const TrackList& tracks, const QString& search,
+                                     const std::function<bool()>& isCancelled);
+
+/*!
+ * Filters @p tracks using the @p search string, only checking the candidates returned by @p index.
+ * Falls back to checking every track if the index can't narrow the search.
+ * @returns a new TrackList containing the tracks which match @p search, or an empty list if cancelled.
+ */
+FYCORE_EXPORT TrackList filterTracks(const TrackList& tracks, const QString& search, const TrackSearchIndex& index,
+                                     const std::function<bool()>& isCancelled = {});
+
+/*!
+ * Filters every track in @p index using the @p search string, checking only the candidates from its posting lists.
+ * Falls back to filtering @p tracks, which should hold every indexed track, if the index can't narrow the search.
+ * @returns a new TrackList, in no particular order, containing the tracks which match @p search,
+ *          or an empty list if cancelled.
+ */
+FYCORE_EXPORT TrackList filterIndexedTracks(const TrackSearchIndex& index, const QString& search,
+                                            const TrackList& tracks, const std::function<bool()>& isCancelled = {});
 } // namespace Fooyin::Filter
@@ -0,0 +1,73 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fycore_export.h"
+
+#include <core/track.h>
+
+#include <memory>
+#include <optional>
+
+namespace Fooyin {
+/*!
+ * An inverted trigram index over the fields searched by Filter::filterTracks.
+ *
+ * Updates are applied in order on a background thread. Tracks with queued updates are
+ * included in every search until they've been indexed, so searches never miss them.
+ * Until the index has been built, candidates() returns std::nullopt so callers fall back to a full scan.
+ */
+class FYCORE_EXPORT TrackSearchIndex
+{
+public:
+    TrackSearchIndex();
+    ~TrackSearchIndex();
+
+    TrackSearchIndex(const TrackSearchIndex&)            = delete;
+    TrackSearchIndex& operator=(const TrackSearchIndex&) = delete;
+
+    /** Replaces the contents of the index with @p tracks */
+    void build(const TrackList& tracks);
+    void addTracks(const TrackList& tracks);
+    void updateTracks(const TrackList& tracks);
+    void removeTracks(const TrackList& tracks);
+
+    /** Blocks until all queued updates have been applied */
+    void waitForUpdates() const;
+
+    /*!
+     * Returns the sorted ids of the tracks which may contain @p search (case-insensitive).
+     * Every matching track is included, but candidates still need to be checked against the search.
+     * @returns std::nullopt if the index is unavailable or @p search is shorter than a trigram.
+     */
+    [[nodiscard]] std::optional<TrackIds> candidates(const QString& search) const;
+
+    /*!
+     * Returns the indexed tracks which may contain @p search (case-insensitive), in no particular order.
+     * Like candidates(), but saves looking up each id in another track list.
+     * @returns std::nullopt if the index is unavailable or @p search is shorter than a trigram.
+     */
+    [[nodiscard]] std::optional<TrackList> candidateTracks(const QString& search) const;
+
+private:
+    struct Private;
+    std::unique_ptr<Private> p;
+};
+} // namespace Fooyin
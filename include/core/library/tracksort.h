@@ -23,14 +23,35 @@
 
 #include <core/trackfwd.h>
 
+#include <QString>
 #include <Qt>
 
-class QString;
+#include <vector>
 
 namespace Fooyin {
 struct ParsedScript;
 
 namespace Sorting {
+using SortKeys = std::vector<QString>;
+
+/*!
+ * Evaluates the @p sort script for each of @p tracks without modifying them.
+ * @returns the sort keys, in the same order as @p tracks
+ */
+SortKeys FYCORE_EXPORT calcSortKeys(const QString& sort, const TrackList& tracks);
+
+/*!
+ * Evaluates the parsed @p sortScript for each of @p tracks without modifying them.
+ * @returns the sort keys, in the same order as @p tracks
+ */
+SortKeys FYCORE_EXPORT calcSortKeys(const ParsedScript& sortScript, const TrackList& tracks);
+
+/*!
+ * Computes a stable permutation which orders @p keys.
+ * @returns the indexes into @p keys in sorted order
+ */
+std::vector<int> FYCORE_EXPORT sortIndexes(const SortKeys& keys, Qt::SortOrder order = Qt::AscendingOrder);
+
 /*!
  * Calculates the sort fields @p tracks using the @p sort script
  * @param sort the sort script as a string
@@ -56,7 +77,8 @@ TrackList FYCORE_EXPORT calcSortFields(const ParsedScript& sortScript, const Tra
 TrackList FYCORE_EXPORT sortTracks(const TrackList& tracks, Qt::SortOrder order = Qt::AscendingOrder);
 
 /*!
- * Calculates the sort fields and then sorts @p tracks
+ * Sorts @p tracks using the @p sort script.
+ * The returned tracks share data with @p tracks and their sort fields are left untouched.
  * @param sort the sort script as a string
  * @param tracks the tracks to sort
  * @param order the order in which to sort the tracks
@@ -66,7 +88,7 @@ TrackList FYCORE_EXPORT calcSortTracks(const QString& sort, const TrackList& tra
                                        Qt::SortOrder order = Qt::AscendingOrder);
 
 /*!
- * Calculates the sort fields and then sorts @p tracks in the given @p indexes.
+ * Sorts @p tracks in the given @p indexes using the @p sort script.
  * @param sort the sort script as a string
  * @param tracks the tracks to sort
  * @param indexes the indexes to sort
@@ -77,7 +99,8 @@ TrackList FYCORE_EXPORT calcSortTracks(const QString& sort, const TrackList& tra
                                        Qt::SortOrder order = Qt::AscendingOrder);
 
 /*!
- * Calculates the sort fields and then sorts @p tracks
+ * Sorts @p tracks using the parsed @p sortScript.
+ * The returned tracks share data with @p tracks and their sort fields are left untouched.
  * @param sortScript the parsed sort script
  * @param tracks the tracks to sort
  * @param order the order in which to sort the tracks
@@ -87,7 +110,7 @@ TrackList FYCORE_EXPORT calcSortTracks(const ParsedScript& sortScript, const Tra
                                        Qt::SortOrder order = Qt::AscendingOrder);
 
 /*!
- * Calculates the sort fields and then sorts @p tracks in the given @p indexes.
+ * Sorts @p tracks in the given @p indexes using the parsed @p sortScript.
  * Tracks not under an index in @p indexes retain their position.
  * @param sortScript the parsed sort script
  * @param tracks the tracks to sort
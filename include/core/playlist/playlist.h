@@ -87,8 +87,14 @@ public:
      * index and the @p mode.
      * @note this will return an invalid track if @p mode is 'Default' and
      * the index +- delta is out of range.
+     * @note this doesn't change which track plays next.
      */
     Track nextTrack(int delta, PlayModes mode);
+    /*!
+     * Schedules and returns the track to be played after the current track based on the @p mode.
+     * @note this will be cancelled if tracks are replaced using @fn replaceTracks.
+     */
+    Track scheduleNextTrack(PlayModes mode);
     /*!
      * Changes to and returns the next track to be played based on the @p delta from the current
      * index and the @p mode.
@@ -99,7 +105,7 @@ public:
 
     void changeCurrentIndex(int index);
 
-    /** Clears the shuffle order history */
+    /** Clears the shuffle order history and any scheduled next track. */
     void reset();
     /** Resets the modified and tracksModified flags. */
     void resetFlags();
@@ -29,6 +29,7 @@
 
 namespace Fooyin {
 class SettingsManager;
+class MusicLibrary;
 class PlayerController;
 
 class FYCORE_EXPORT PlaylistHandler : public QObject
@@ -36,8 +37,8 @@ class FYCORE_EXPORT PlaylistHandler : public QObject
     Q_OBJECT
 
 public:
-    explicit PlaylistHandler(DbConnectionPoolPtr dbPool, PlayerController* playerController, SettingsManager* settings,
-                             QObject* parent = nullptr);
+    explicit PlaylistHandler(DbConnectionPoolPtr dbPool, MusicLibrary* library, PlayerController* playerController,
+                             SettingsManager* settings, QObject* parent = nullptr);
     ~PlaylistHandler() override;
 
     /** Returns the playlist with the @p id if it exists, otherwise nullptr. */
@@ -51,6 +52,13 @@ public:
 
     [[nodiscard]] PlaylistList playlists() const;
 
+    /*!
+     * Loads the tracks of @p playlist in the background if they haven't been loaded yet.
+     * Saved playlists are loaded on demand once the library has loaded, the active playlist first.
+     * playlistTracksChanged is emitted once loaded.
+     */
+    void loadPlaylist(Playlist* playlist);
+
     /** Creates and returns an empty playlist with a default name. */
     Playlist* createEmptyPlaylist();
     /** Creates and returns an empty hidden playlist with a default name. */
@@ -89,6 +97,8 @@ public:
     Track nextTrack();
     /** Returns the previous track to be played, or an invalid track if the playlist will end. */
     Track previousTrack();
+    /** Schedules and returns the track to follow the current one, so it can be opened ahead of time. */
+    Track scheduleNextTrack();
 
     void renamePlaylist(const Id& id, const QString& name);
     void removePlaylist(const Id& id);
@@ -116,13 +126,19 @@ signals:
     void playlistRemoved(Playlist* playlist);
     void playlistRenamed(Playlist* playlist);
     void activePlaylistChanged(Playlist* playlist);
+    /** Emitted in response to prepareNextTrack with the track to follow the current one. */
+    void nextTrackPrepared(const Track& track);
 
 public slots:
-    void populatePlaylists(const TrackList& tracks);
+    void populatePlaylists();
+    /*!
+     * Works out the track to follow the current one, taking the playback queue into account,
+     * and emits nextTrackPrepared so it can be opened ahead of time.
+     */
+    void prepareNextTrack();
     void tracksUpdated(const TrackList& tracks);
     void tracksPlayed(const TrackList& tracks);
     void tracksRemoved(const TrackList& tracks);
-    void trackAboutToFinish();
 
 private:
     struct Private;
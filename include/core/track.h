@@ -64,6 +64,24 @@ public:
         Artist,
     };
 
+    /*!
+     * Where an embedded picture's raw bytes are stored within the file.
+     * Located when a cover is first read, so it can be read again without parsing tags.
+     */
+    struct CoverLocation
+    {
+        Cover type{Cover::Front};
+        uint64_t offset{0};
+        uint64_t size{0};
+        QString hash;
+
+        [[nodiscard]] bool isValid() const
+        {
+            return size > 0 && !hash.isEmpty();
+        }
+    };
+    using CoverLocations = std::vector<CoverLocation>;
+
     using ExtraTags = QMap<QString, QStringList>;
 
     Track();
@@ -123,7 +141,14 @@ public:
     [[nodiscard]] QStringList removedTags() const;
     [[nodiscard]] QByteArray serialiseExtrasTags() const;
 
+    [[nodiscard]] CoverLocations coverLocations() const;
+    [[nodiscard]] CoverLocation coverLocation(Cover type) const;
+    [[nodiscard]] QByteArray serialiseCoverLocations() const;
+
     [[nodiscard]] uint64_t fileSize() const;
+    [[nodiscard]] uint64_t deviceId() const;
+    [[nodiscard]] uint64_t inode() const;
+    [[nodiscard]] QString fingerprint() const;
     [[nodiscard]] int bitrate() const;
     [[nodiscard]] int sampleRate() const;
     [[nodiscard]] int channels() const;
@@ -167,7 +192,13 @@ public:
     void clearExtraTags();
     void storeExtraTags(const QByteArray& json);
 
+    void setCoverLocations(const CoverLocations& locations);
+    void storeCoverLocations(const QByteArray& locations);
+
     void setFileSize(uint64_t fileSize);
+    void setDeviceId(uint64_t id);
+    void setInode(uint64_t inode);
+    void setFingerprint(const QString& fingerprint);
     void setBitrate(int rate);
     void setSampleRate(int rate);
     void setChannels(int channels);
@@ -78,6 +78,7 @@ constexpr auto TrackSelection = "Fooyin.Menu.Tracks";
 constexpr auto TracksPlaylist = "Fooyin.Menu.Tracks.Playlist";
 constexpr auto Playlist       = "Fooyin.Menu.Playlist";
 constexpr auto PlaylistAddTo  = "Fooyin.Menu.Playlist.AddTo";
+constexpr auto ReplayGain     = "Fooyin.Menu.Tracks.ReplayGain";
 } // namespace Context
 } // namespace Menus
 
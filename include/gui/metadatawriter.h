@@ -0,0 +1,36 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fygui_export.h"
+
+#include <core/track.h>
+
+namespace Fooyin {
+class MusicLibrary;
+
+namespace Gui {
+/*!
+ * Writes the metadata of @p tracks using @p library, showing the progress in a dialog which can cancel the write.
+ * The dialog is closed once the write has finished.
+ */
+FYGUI_EXPORT void writeTrackMetadata(MusicLibrary* library, const TrackList& tracks);
+} // namespace Gui
+} // namespace Fooyin
@@ -0,0 +1,160 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+namespace Fooyin {
+/*!
+ * A binary indexed tree over a sequence of non-negative values.
+ * Prefix sums, point updates and searching by cumulative value are O(log n).
+ */
+template <typename T>
+class FenwickTree
+{
+public:
+    FenwickTree() = default;
+
+    /** Replaces the contents with @p values in O(n). */
+    void assign(const std::vector<T>& values)
+    {
+        const int count = static_cast<int>(values.size());
+
+        m_values = values;
+        m_tree.assign(count + 1, T{});
+
+        for(int i{1}; i <= count; ++i) {
+            m_tree[i] += values[i - 1];
+            const int parent = i + (i & -i);
+            if(parent <= count) {
+                m_tree[parent] += m_tree[i];
+            }
+        }
+    }
+
+    void clear()
+    {
+        m_values.clear();
+        m_tree.clear();
+    }
+
+    [[nodiscard]] int size() const
+    {
+        return static_cast<int>(m_values.size());
+    }
+
+    [[nodiscard]] bool empty() const
+    {
+        return m_values.empty();
+    }
+
+    [[nodiscard]] T value(int index) const
+    {
+        return m_values.at(index);
+    }
+
+    void set(int index, T value)
+    {
+        const T delta = value - m_values.at(index);
+        if(delta == T{}) {
+            return;
+        }
+
+        m_values[index] = value;
+
+        const int count = size();
+        for(int i{index + 1}; i <= count; i += i & -i) {
+            m_tree[i] += delta;
+        }
+    }
+
+    /*!
+     * Inserts @p count copies of @p value before @p index.
+     * Only the nodes after @p index are rebuilt, in O(n - index + log² n).
+     */
+    void insert(int index, int count, T value)
+    {
+        if(count <= 0) {
+            return;
+        }
+
+        m_values.insert(m_values.begin() + index, count, value);
+
+        const int total = size();
+        m_tree.resize(total + 1);
+
+        // Nodes up to index only cover values before the insertion, so are unchanged.
+        // Rebuild the rest from running prefix sums, starting from the (still valid) sum before index.
+        std::vector<T> prefixes(total - index + 1);
+        prefixes[0] = prefixSum(index);
+
+        for(int i{index + 1}; i <= total; ++i) {
+            prefixes[i - index] = prefixes[i - index - 1] + m_values[i - 1];
+
+            const int start = i - (i & -i);
+            m_tree[i]       = prefixes[i - index] - (start >= index ? prefixes[start - index] : prefixSum(start));
+        }
+    }
+
+    /** Returns the sum of the first @p count values. */
+    [[nodiscard]] T prefixSum(int count) const
+    {
+        T sum{};
+        for(int i{std::min(count, size())}; i > 0; i -= i & -i) {
+            sum += m_tree[i];
+        }
+        return sum;
+    }
+
+    [[nodiscard]] T total() const
+    {
+        return prefixSum(size());
+    }
+
+    /*!
+     * Returns the index of the first value at which the running total exceeds @p target,
+     * or size() if the total does not exceed it.
+     */
+    [[nodiscard]] int upperBound(T target) const
+    {
+        const int count = size();
+
+        int step{1};
+        while(step * 2 <= count) {
+            step *= 2;
+        }
+
+        int pos{0};
+        for(; step > 0; step /= 2) {
+            if(pos + step <= count && m_tree[pos + step] <= target) {
+                pos += step;
+                target -= m_tree[pos];
+            }
+        }
+
+        return pos;
+    }
+
+private:
+    std::vector<T> m_values;
+    std::vector<T> m_tree; // 1-based
+};
+} // namespace Fooyin
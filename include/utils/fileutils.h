@@ -24,9 +24,26 @@
 #include <QStringList>
 #include <QUrl>
 
+#include <utility>
+
 class QDir;
 
 namespace Fooyin::Utils::File {
+/*!
+ * Identifies a file on disk independently of its path.
+ * Only available on platforms with POSIX file serial numbers, otherwise invalid.
+ */
+struct FileId
+{
+    uint64_t device{0};
+    uint64_t inode{0};
+
+    [[nodiscard]] bool isValid() const
+    {
+        return inode != 0;
+    }
+};
+
 FYUTILS_EXPORT QString cleanPath(const QString& path);
 FYUTILS_EXPORT bool isSamePath(const QString& filename1, const QString& filename2);
 FYUTILS_EXPORT bool isSubdir(const QString& dir, const QString& parentDir);
@@ -42,4 +59,12 @@ FYUTILS_EXPORT QList<QUrl> getUrlsInDirRecursive(const QDir& baseDirectory, cons
 FYUTILS_EXPORT QStringList getFiles(const QStringList& paths, const QStringList& fileExtensions = {});
 FYUTILS_EXPORT QStringList getFiles(const QList<QUrl>& urls, const QStringList& fileExtensions = {});
 FYUTILS_EXPORT QStringList getAllSubdirectories(const QDir& dir);
+
+FYUTILS_EXPORT FileId fileId(const QString& filepath);
+/** Returns a hash of a small block from the middle of the file, or an empty string on failure. */
+FYUTILS_EXPORT QString fingerprint(const QString& filepath);
+/** Returns the offset and length of the block hashed by fingerprint for a file of @p size bytes. */
+FYUTILS_EXPORT std::pair<int64_t, int64_t> fingerprintBlock(int64_t size);
+/** Returns the fingerprint of a file of @p size bytes from the data of its fingerprintBlock. */
+FYUTILS_EXPORT QString fingerprint(int64_t size, const QByteArray& block);
 } // namespace Fooyin::Utils::File
@@ -0,0 +1,163 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace Fooyin {
+/*!
+ * A fixed-capacity, lock-free byte ring buffer for a single producer and a single consumer.
+ *
+ * read() and write() never allocate or block, so the consumer side can safely run on a
+ * real-time audio thread. resize() is not thread-safe and must only be called while neither
+ * side is in use.
+ */
+class RingBuffer
+{
+public:
+    RingBuffer() = default;
+
+    explicit RingBuffer(size_t capacity)
+    {
+        resize(capacity);
+    }
+
+    void resize(size_t capacity)
+    {
+        m_data.assign(capacity, std::byte{0});
+        m_readIndex.store(0, std::memory_order_relaxed);
+        m_writeIndex.store(0, std::memory_order_relaxed);
+        m_clearIndex.store(NoClear, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] size_t capacity() const
+    {
+        return m_data.size();
+    }
+
+    /** Returns the number of bytes the consumer can read. */
+    [[nodiscard]] size_t readAvailable() const
+    {
+        const size_t readIndex = std::max(m_readIndex.load(std::memory_order_acquire),
+                                          pendingClear(m_clearIndex.load(std::memory_order_acquire)));
+        return m_writeIndex.load(std::memory_order_acquire) - readIndex;
+    }
+
+    /** Returns the number of bytes the producer can write. */
+    [[nodiscard]] size_t writeAvailable() const
+    {
+        const size_t used = m_writeIndex.load(std::memory_order_acquire) - m_readIndex.load(std::memory_order_acquire);
+        return capacity() - used;
+    }
+
+    /*!
+     * Copies up to @p size bytes from @p data into the buffer.
+     * @note producer only.
+     * @returns the number of bytes written.
+     */
+    size_t write(const std::byte* data, size_t size)
+    {
+        const size_t writeIndex = m_writeIndex.load(std::memory_order_relaxed);
+        const size_t readIndex  = m_readIndex.load(std::memory_order_acquire);
+
+        size = std::min(size, capacity() - (writeIndex - readIndex));
+        if(size == 0) {
+            return 0;
+        }
+
+        const size_t pos   = writeIndex % capacity();
+        const size_t first = std::min(size, capacity() - pos);
+
+        std::memcpy(m_data.data() + pos, data, first);
+        std::memcpy(m_data.data(), data + first, size - first);
+
+        m_writeIndex.store(writeIndex + size, std::memory_order_release);
+
+        return size;
+    }
+
+    /*!
+     * Copies up to @p size bytes from the buffer into @p data.
+     * @note consumer only.
+     * @returns the number of bytes read.
+     */
+    size_t read(std::byte* data, size_t size)
+    {
+        size_t readIndex        = applyClear();
+        const size_t writeIndex = m_writeIndex.load(std::memory_order_acquire);
+
+        size = std::min(size, writeIndex - readIndex);
+        if(size == 0) {
+            return 0;
+        }
+
+        const size_t pos   = readIndex % capacity();
+        const size_t first = std::min(size, capacity() - pos);
+
+        std::memcpy(data, m_data.data() + pos, first);
+        std::memcpy(data + first, m_data.data(), size - first);
+
+        readIndex += size;
+        m_readIndex.store(readIndex, std::memory_order_release);
+
+        return size;
+    }
+
+    /*!
+     * Discards everything written so far.
+     * @note producer only; the consumer drops the data on its next read.
+     */
+    void clear()
+    {
+        m_clearIndex.store(m_writeIndex.load(std::memory_order_relaxed), std::memory_order_release);
+    }
+
+private:
+    static constexpr size_t NoClear = std::numeric_limits<size_t>::max();
+
+    static size_t pendingClear(size_t clearIndex)
+    {
+        return clearIndex == NoClear ? 0 : clearIndex;
+    }
+
+    size_t applyClear()
+    {
+        size_t readIndex        = m_readIndex.load(std::memory_order_relaxed);
+        const size_t clearIndex = m_clearIndex.exchange(NoClear, std::memory_order_acq_rel);
+
+        if(clearIndex != NoClear && clearIndex > readIndex) {
+            readIndex = clearIndex;
+            m_readIndex.store(readIndex, std::memory_order_release);
+        }
+
+        return readIndex;
+    }
+
+    std::vector<std::byte> m_data;
+    alignas(64) std::atomic<size_t> m_readIndex{0};
+    alignas(64) std::atomic<size_t> m_writeIndex{0};
+    std::atomic<size_t> m_clearIndex{NoClear};
+};
+} // namespace Fooyin
@@ -0,0 +1,58 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fyutils_export.h"
+
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+#include <mutex>
+
+namespace Fooyin {
+/*!
+ * A thread-safe pool of interned strings.
+ * Interned values share a single allocation, so repeated metadata (artists, albums, genres...)
+ * is stored once and equal values compare by pointer.
+ */
+class FYUTILS_EXPORT StringPool
+{
+public:
+    /** Returns the pool shared by track loading and tag reading. */
+    static StringPool& shared();
+
+    /** Returns a copy of @p str which shares storage with any equal string already in the pool. */
+    QString intern(const QString& str);
+    /** Interns each string of @p list, and the list itself. */
+    QStringList intern(const QStringList& list);
+
+    /** Removes values which are no longer referenced outside of the pool. */
+    void prune();
+    void clear();
+
+    [[nodiscard]] qsizetype size() const;
+
+private:
+    mutable std::mutex m_mutex;
+    QSet<QString> m_strings;
+    QSet<QStringList> m_lists;
+};
+} // namespace Fooyin
@@ -19,11 +19,19 @@
 
 #pragma once
 
+#include <algorithm>
 #include <condition_variable>
-#include <deque>
 #include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
 
 namespace Fooyin {
+/*!
+ * A FIFO queue which is safe to use from multiple threads.
+ * Items are kept in a ring which only grows when full, so a queue reserved up front
+ * doesn't allocate as items are added and removed.
+ */
 template <typename QueueItem>
 class ThreadQueue
 {
@@ -35,18 +43,25 @@ public:
     ThreadQueue& operator=(ThreadQueue&& other) noexcept;
 
     void clear();
+    void reserve(std::size_t capacity);
 
     bool empty() const;
     std::size_t size() const;
 
     void enqueue(QueueItem item);
     QueueItem& front();
+    QueueItem& at(std::size_t index);
     QueueItem dequeue();
 
 private:
+    QueueItem& item(std::size_t index);
+    void grow(std::size_t capacity);
+
     mutable std::mutex m_mtx;
     std::condition_variable m_cv;
-    std::deque<QueueItem> m_queue{};
+    std::vector<QueueItem> m_queue;
+    std::size_t m_head{0};
+    std::size_t m_size{0};
     bool m_blocking;
 };
 
@@ -60,6 +75,8 @@ ThreadQueue<QueueItem>::ThreadQueue(ThreadQueue&& other) noexcept
 {
     std::lock_guard lock(other.m_mtx);
     m_queue = std::move(other.m_queue);
+    m_head  = std::exchange(other.m_head, 0);
+    m_size  = std::exchange(other.m_size, 0);
 }
 
 template <typename QueueItem>
@@ -69,6 +86,8 @@ ThreadQueue<QueueItem>& ThreadQueue<QueueItem>::ThreadQueue::operator=(ThreadQue
     std::lock_guard otherLock(other.m_mtx);
 
     m_queue = other.m_queue;
+    m_head  = other.m_head;
+    m_size  = other.m_size;
 
     return *this;
 }
@@ -77,7 +96,21 @@ template <typename QueueItem>
 void ThreadQueue<QueueItem>::clear()
 {
     std::lock_guard lock(m_mtx);
-    m_queue.clear();
+
+    // Keep the capacity, but release the items
+    std::ranges::fill(m_queue, QueueItem{});
+    m_head = 0;
+    m_size = 0;
+}
+
+template <typename QueueItem>
+void ThreadQueue<QueueItem>::reserve(std::size_t capacity)
+{
+    std::lock_guard lock(m_mtx);
+
+    if(capacity > m_queue.size()) {
+        grow(capacity);
+    }
 }
 
 template <typename QueueItem>
@@ -87,6 +120,8 @@ ThreadQueue<QueueItem>& ThreadQueue<QueueItem>::ThreadQueue::operator=(ThreadQue
     std::lock_guard otherLock(other.m_mtx);
 
     m_queue = std::move(other.m_queue);
+    m_head  = std::exchange(other.m_head, 0);
+    m_size  = std::exchange(other.m_size, 0);
 
     return *this;
 }
@@ -95,14 +130,14 @@ template <typename QueueItem>
 bool ThreadQueue<QueueItem>::ThreadQueue::empty() const
 {
     std::lock_guard lock(m_mtx);
-    return m_queue.empty();
+    return m_size == 0;
 }
 
 template <typename QueueItem>
 std::size_t ThreadQueue<QueueItem>::ThreadQueue::size() const
 {
     std::lock_guard lock(m_mtx);
-    return m_queue.size();
+    return m_size;
 }
 
 template <typename QueueItem>
@@ -110,7 +145,12 @@ void ThreadQueue<QueueItem>::ThreadQueue::enqueue(QueueItem item)
 {
     {
         std::lock_guard lock(m_mtx);
-        m_queue.push_back(std::move(item));
+
+        if(m_size == m_queue.size()) {
+            grow(std::max<std::size_t>(m_queue.size() * 2, 16));
+        }
+        m_queue[(m_head + m_size) % m_queue.size()] = std::move(item);
+        ++m_size;
     }
 
     m_cv.notify_one();
@@ -122,12 +162,24 @@ QueueItem& ThreadQueue<QueueItem>::ThreadQueue::front()
     std::unique_lock lock(m_mtx);
 
     if(m_blocking) {
-        while(m_queue.empty()) {
+        while(m_size == 0) {
             m_cv.wait(lock);
         }
     }
 
-    return m_queue.front();
+    return item(0);
+}
+
+template <typename QueueItem>
+QueueItem& ThreadQueue<QueueItem>::ThreadQueue::at(std::size_t index)
+{
+    std::lock_guard lock(m_mtx);
+
+    if(index >= m_size) {
+        throw std::out_of_range("ThreadQueue::at");
+    }
+
+    return item(index);
 }
 
 template <typename QueueItem>
@@ -136,13 +188,31 @@ QueueItem ThreadQueue<QueueItem>::ThreadQueue::dequeue()
     std::unique_lock lock(m_mtx);
 
     if(m_blocking) {
-        while(m_queue.empty()) {
+        while(m_size == 0) {
             m_cv.wait(lock);
         }
     }
 
-    QueueItem item = m_queue.front();
-    m_queue.pop_front();
+    QueueItem item = std::exchange(m_queue[m_head], QueueItem{});
+    m_head         = (m_head + 1) % m_queue.size();
+    --m_size;
     return item;
 }
+
+template <typename QueueItem>
+QueueItem& ThreadQueue<QueueItem>::item(std::size_t index)
+{
+    return m_queue[(m_head + index) % m_queue.size()];
+}
+
+template <typename QueueItem>
+void ThreadQueue<QueueItem>::grow(std::size_t capacity)
+{
+    std::vector<QueueItem> queue(capacity);
+    for(std::size_t i{0}; i < m_size; ++i) {
+        queue[i] = std::move(item(i));
+    }
+    m_queue = std::move(queue);
+    m_head  = 0;
+}
 } // namespace Fooyin
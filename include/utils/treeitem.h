@@ -21,9 +21,14 @@
 
 #include "helpers.h"
 
+#include <algorithm>
 #include <vector>
 
 namespace Fooyin {
+/*!
+ * Base for items of a TreeModel.
+ * Each child's row is kept up to date as children are inserted, removed or moved, so row() is constant time.
+ */
 template <class Item>
 class TreeItem
 {
@@ -40,32 +45,111 @@ public:
 
     virtual bool hasChild(Item* child) const
     {
-        return Utils::contains(m_children, child);
+        if(!child) {
+            return false;
+        }
+        const int row = child->m_row;
+        return row >= 0 && row < childCount() && m_children.at(row) == child;
     }
 
-    virtual std::vector<Item*> children() const
+    [[nodiscard]] virtual const std::vector<Item*>& children() const
     {
         return m_children;
     }
 
     virtual void appendChild(Item* child)
     {
-        m_children.emplace_back(child);
+        child->m_row    = childCount();
         child->m_parent = static_cast<Item*>(this);
+        m_children.emplace_back(child);
     }
 
     virtual void insertChild(int row, Item* child)
     {
+        row = std::clamp(row, 0, childCount());
         m_children.insert(m_children.begin() + row, child);
         child->m_parent = static_cast<Item*>(this);
+        updateChildRows(row);
+    }
+
+    /** Inserts @p children at @p row, updating the rows of later children once. */
+    virtual void insertChildren(int row, const std::vector<Item*>& children)
+    {
+        row = std::clamp(row, 0, childCount());
+        m_children.insert(m_children.begin() + row, children.cbegin(), children.cend());
+        for(Item* child : children) {
+            child->m_parent = static_cast<Item*>(this);
+        }
+        updateChildRows(row);
     }
 
     virtual void removeChild(int index)
     {
-        if(index < 0 && index >= childCount()) {
+        if(index < 0 || index >= childCount()) {
             return;
         }
         m_children.erase(m_children.cbegin() + index);
+        updateChildRows(index);
+    }
+
+    /** Removes @p count children starting at @p index, updating the rows of later children once. */
+    virtual void removeChildren(int index, int count)
+    {
+        if(index < 0 || count <= 0 || index >= childCount()) {
+            return;
+        }
+        count = std::min(count, childCount() - index);
+        m_children.erase(m_children.cbegin() + index, m_children.cbegin() + index + count);
+        updateChildRows(index);
+    }
+
+    /*!
+     * Moves @p children of @p source to @p row of this item, where @p row is the position before the move.
+     * The rows of both parents are updated once, rather than for each moved child.
+     * @returns the row after the last moved child, in terms of the rows before the move.
+     */
+    virtual int moveChildren(Item* source, const std::vector<Item*>& children, int row)
+    {
+        if(!source || children.empty()) {
+            return row;
+        }
+
+        row = std::clamp(row, 0, childCount());
+
+        std::vector<char> moving(source->m_children.size(), 0);
+        int firstMoved{source->childCount()};
+        int movedBefore{0};
+
+        for(Item* child : children) {
+            const int childRow = child->row();
+            moving[childRow]   = 1;
+            firstMoved         = std::min(firstMoved, childRow);
+            if(childRow < row) {
+                ++movedBefore;
+            }
+        }
+
+        int index{0};
+        std::erase_if(source->m_children, [&moving, &index](Item* /*child*/) { return moving[index++] != 0; });
+
+        const bool sameParent = source == this;
+        const int insertRow   = sameParent ? row - movedBefore : row;
+
+        m_children.insert(m_children.begin() + insertRow, children.cbegin(), children.cend());
+        for(Item* child : children) {
+            child->m_parent = static_cast<Item*>(this);
+        }
+
+        if(sameParent) {
+            updateChildRows(std::min(firstMoved, insertRow));
+        }
+        else {
+            source->updateChildRows(firstMoved);
+            updateChildRows(insertRow);
+        }
+
+        const auto count = static_cast<int>(children.size());
+        return row + (sameParent ? count - movedBefore : count);
     }
 
     virtual void clearChildren()
@@ -104,12 +188,24 @@ public:
         m_row = -1;
     }
 
+    /** Recalculates the rows of all descendants. Only needed if children were reordered directly. */
     virtual void resetChildren()
     {
+        updateChildRows();
         for(Item* child : m_children) {
             if(child) {
                 child->resetChildren();
-                child->resetRow();
+            }
+        }
+    }
+
+protected:
+    void updateChildRows(int first = 0)
+    {
+        const int count = childCount();
+        for(int i{first}; i < count; ++i) {
+            if(Item* child = m_children[i]) {
+                child->m_row = i;
             }
         }
     }
@@ -35,6 +35,8 @@
 #include <utils/settings/settingsmanager.h>
 
 #include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
 #include <QProcess>
 
 constexpr auto LastPlaybackPosition = "Player/LastPositon";
@@ -56,6 +58,8 @@ struct Application::Private
     PluginManager pluginManager;
     CorePluginContext corePluginContext;
 
+    QElapsedTimer startupTimer;
+
     explicit Private(QObject* parent)
         : settingsManager{new SettingsManager(Core::settingsPath(), parent)}
         , coreSettings{settingsManager}
@@ -65,13 +69,16 @@ struct Application::Private
         , engine{playerController, settingsManager}
         , libraryManager{new LibraryManager(database->connectionPool(), settingsManager, parent)}
         , library{new UnifiedMusicLibrary(libraryManager, database->connectionPool(), settingsManager, parent)}
-        , playlistHandler{new PlaylistHandler(database->connectionPool(), playerController, settingsManager, parent)}
+        , playlistHandler{
+              new PlaylistHandler(database->connectionPool(), library, playerController, settingsManager, parent)}
         , pluginManager{settingsManager}
         , corePluginContext{&pluginManager, &engine,         playerController, libraryManager,
                             library,        playlistHandler, settingsManager}
     {
+        startupTimer.start();
         registerTypes();
         loadPlugins();
+        qDebug() << "[Startup] Plugins loaded after" << startupTimer.elapsed() << "ms";
     }
 
     static void registerTypes()
@@ -96,8 +103,10 @@ struct Application::Private
             [this](CorePlugin* plugin) { plugin->initialise(corePluginContext); });
 
         pluginManager.initialisePlugins<OutputPlugin>([this](OutputPlugin* plugin) {
-            const AudioOutputBuilder builder = plugin->registerOutput();
-            engine.addOutput(builder);
+            const auto builders = plugin->registerOutputs();
+            for(const AudioOutputBuilder& builder : builders) {
+                engine.addOutput(builder);
+            }
         });
     }
 
@@ -144,8 +153,14 @@ Application::Application(QObject* parent)
     : QObject{parent}
     , p{std::make_unique<Private>(this)}
 {
-    QObject::connect(p->playlistHandler, &PlaylistHandler::playlistsPopulated, this,
-                     [this]() { p->loadPlaybackState(); });
+    QObject::connect(p->playlistHandler, &PlaylistHandler::playlistsPopulated, this, [this]() {
+        qDebug() << "[Startup] Playlists restored after" << p->startupTimer.elapsed() << "ms";
+        p->loadPlaybackState();
+    });
+    QObject::connect(
+        p->library, &MusicLibrary::tracksLoaded, this,
+        [this]() { qDebug() << "[Startup] Library loaded after" << p->startupTimer.elapsed() << "ms"; },
+        Qt::SingleShotConnection);
     QObject::connect(p->playerController, &PlayerController::trackPlayed, p->library,
                      &UnifiedMusicLibrary::trackWasPlayed);
     QObject::connect(p->library, &MusicLibrary::tracksLoaded, p->playlistHandler, &PlaylistHandler::populatePlaylists);
@@ -156,7 +171,9 @@ Application::Application(QObject* parent)
     QObject::connect(p->library, &MusicLibrary::tracksPlayed, p->playlistHandler,
                      [this](const TrackList& tracks) { p->playlistHandler->tracksPlayed(tracks); });
     QObject::connect(&p->engine, &EngineHandler::trackAboutToFinish, p->playlistHandler,
-                     &PlaylistHandler::trackAboutToFinish);
+                     &PlaylistHandler::prepareNextTrack);
+    QObject::connect(p->playlistHandler, &PlaylistHandler::nextTrackPrepared, &p->engine,
+                     &EngineHandler::prepareNextTrack);
 
     p->library->loadAllTracks();
     p->engine.setup();
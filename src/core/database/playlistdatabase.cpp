@@ -49,9 +49,25 @@ std::vector<PlaylistInfo> PlaylistDatabase::getAllPlaylists()
     return playlists;
 }
 
-TrackList PlaylistDatabase::getPlaylistTracks(const Playlist& playlist, const TrackIdMap& tracks)
+TrackIds PlaylistDatabase::getPlaylistTrackIds(int playlistId)
 {
-    return populatePlaylistTracks(playlist, tracks);
+    const auto statement
+        = QStringLiteral("SELECT TrackID FROM PlaylistTracks WHERE PlaylistID=:playlistId ORDER BY TrackIndex;");
+
+    DbQuery query{db(), statement};
+    query.bindValue(QStringLiteral(":playlistId"), playlistId);
+
+    if(!query.exec()) {
+        return {};
+    }
+
+    TrackIds trackIds;
+
+    while(query.next()) {
+        trackIds.push_back(query.value(0).toInt());
+    }
+
+    return trackIds;
 }
 
 int PlaylistDatabase::insertPlaylist(const QString& name, int index)
@@ -177,28 +193,4 @@ bool PlaylistDatabase::insertPlaylistTracks(int playlistId, const TrackList& tra
 
     return true;
 }
-
-TrackList PlaylistDatabase::populatePlaylistTracks(const Playlist& playlist, const TrackIdMap& tracks)
-{
-    const auto statement
-        = QStringLiteral("SELECT TrackID FROM PlaylistTracks WHERE PlaylistID=:playlistId ORDER BY TrackIndex;");
-
-    DbQuery query{db(), statement};
-    query.bindValue(QStringLiteral(":playlistId"), playlist.dbId());
-
-    if(!query.exec()) {
-        return {};
-    }
-
-    TrackList playlistTracks;
-
-    while(query.next()) {
-        const int trackId = query.value(0).toInt();
-        if(tracks.contains(trackId)) {
-            playlistTracks.push_back(tracks.at(trackId));
-        }
-    }
-
-    return playlistTracks;
-}
 } // namespace Fooyin
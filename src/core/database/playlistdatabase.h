@@ -35,7 +35,8 @@ class PlaylistDatabase : public DbModule
 {
 public:
     std::vector<PlaylistInfo> getAllPlaylists();
-    TrackList getPlaylistTracks(const Playlist& playlist, const TrackIdMap& tracks);
+    /** Returns the ids of the tracks in the playlist with @p playlistId, in playlist order. */
+    TrackIds getPlaylistTrackIds(int playlistId);
 
     int insertPlaylist(const QString& name, int index);
 
@@ -47,6 +48,5 @@ public:
 private:
     bool insertPlaylistTrack(int playlistId, const Fooyin::Track& track, int index);
     bool insertPlaylistTracks(int playlistId, const TrackList& tracks);
-    TrackList populatePlaylistTracks(const Playlist& playlist, const TrackIdMap& tracks);
 };
 } // namespace Fooyin
@@ -24,6 +24,7 @@
 #include <utils/database/dbquery.h>
 #include <utils/database/dbtransaction.h>
 #include <utils/fileutils.h>
+#include <utils/stringpool.h>
 
 #include <QFileInfo>
 
@@ -62,7 +63,11 @@ QString fetchTrackColumns()
                                                   "FirstPlayed,"
                                                   "LastPlayed,"
                                                   "PlayCount,"
-                                                  "Rating");
+                                                  "Rating,"
+                                                  "CoverLocations,"
+                                                  "Device,"
+                                                  "Inode,"
+                                                  "Fingerprint");
 
     return columns;
 }
@@ -89,6 +94,10 @@ BindingsMap trackBindings(const Fooyin::Track& track)
             {QStringLiteral(":sampleRate"), track.sampleRate()},
             {QStringLiteral(":channels"), track.channels()},
             {QStringLiteral(":extraTags"), track.serialiseExtrasTags()},
+            {QStringLiteral(":coverLocations"), track.serialiseCoverLocations()},
+            {QStringLiteral(":device"), QVariant::fromValue(track.deviceId())},
+            {QStringLiteral(":inode"), QVariant::fromValue(track.inode())},
+            {QStringLiteral(":fingerprint"), track.fingerprint()},
             {QStringLiteral(":type"), static_cast<int>(track.type())},
             {QStringLiteral(":modifiedDate"), QVariant::fromValue(track.modifiedTime())},
             {QStringLiteral(":trackHash"), track.hash()},
@@ -97,6 +106,8 @@ BindingsMap trackBindings(const Fooyin::Track& track)
 
 Fooyin::Track readToTrack(const Fooyin::DbQuery& q)
 {
+    Fooyin::StringPool& pool = Fooyin::StringPool::shared();
+
     Fooyin::Track track;
 
     track.setId(q.value(0).toInt());
@@ -105,15 +116,15 @@ Fooyin::Track readToTrack(const Fooyin::DbQuery& q)
     track.setTitle(q.value(3).toString());
     track.setTrackNumber(q.value(4).toInt());
     track.setTrackTotal(q.value(5).toInt());
-    track.setArtists(q.value(6).toStringList());
-    track.setAlbumArtists(q.value(7).toStringList());
-    track.setAlbum(q.value(8).toString());
+    track.setArtists(pool.intern(q.value(6).toStringList()));
+    track.setAlbumArtists(pool.intern(q.value(7).toStringList()));
+    track.setAlbum(pool.intern(q.value(8).toString()));
     track.setDiscNumber(q.value(9).toInt());
     track.setDiscTotal(q.value(10).toInt());
-    track.setDate(q.value(11).toString());
-    track.setComposer(q.value(12).toString());
-    track.setPerformer(q.value(13).toString());
-    track.setGenres(q.value(14).toStringList());
+    track.setDate(pool.intern(q.value(11).toString()));
+    track.setComposer(pool.intern(q.value(12).toString()));
+    track.setPerformer(pool.intern(q.value(13).toString()));
+    track.setGenres(pool.intern(q.value(14).toStringList()));
     track.setComment(q.value(15).toString());
     track.setDuration(q.value(16).toULongLong());
     track.setFileSize(q.value(17).toInt());
@@ -129,6 +140,10 @@ Fooyin::Track readToTrack(const Fooyin::DbQuery& q)
     track.setFirstPlayed(q.value(27).toULongLong());
     track.setLastPlayed(q.value(28).toULongLong());
     track.setPlayCount(q.value(29).toInt());
+    track.storeCoverLocations(q.value(31).toByteArray());
+    track.setDeviceId(q.value(32).toULongLong());
+    track.setInode(q.value(33).toULongLong());
+    track.setFingerprint(q.value(34).toString());
 
     track.generateHash();
     track.setIsEnabled(QFileInfo::exists(track.filepath()));
@@ -232,6 +247,32 @@ TrackList TrackDatabase::getAllTracks() const
     return tracks;
 }
 
+TrackList TrackDatabase::playlistTracks(int playlistId) const
+{
+    const auto statement
+        = QStringLiteral("SELECT %1 FROM TracksView "
+                         "JOIN (SELECT TrackID AS PlaylistTrackID, TrackIndex AS PlaylistTrackIndex "
+                         "FROM PlaylistTracks WHERE PlaylistID = :playlistId) "
+                         "ON TrackID = PlaylistTrackID ORDER BY PlaylistTrackIndex;")
+              .arg(fetchTrackColumns());
+
+    DbQuery q{db(), statement};
+
+    q.bindValue(QStringLiteral(":playlistId"), playlistId);
+
+    TrackList tracks;
+
+    if(!q.exec()) {
+        return tracks;
+    }
+
+    while(q.next()) {
+        tracks.emplace_back(readToTrack(q));
+    }
+
+    return tracks;
+}
+
 TrackList TrackDatabase::tracksByHash(const QString& hash) const
 {
     const auto statement
@@ -254,6 +295,67 @@ TrackList TrackDatabase::tracksByHash(const QString& hash) const
     return tracks;
 }
 
+TrackList TrackDatabase::tracksByPaths(const QStringList& paths) const
+{
+    TrackList tracks;
+
+    // Stay well below SQLite's host parameter limit
+    static constexpr qsizetype MaxParams = 500;
+
+    for(qsizetype start{0}; start < paths.size(); start += MaxParams) {
+        const QStringList batch = paths.mid(start, MaxParams);
+
+        QStringList params;
+        for(qsizetype i{0}; i < batch.size(); ++i) {
+            params.append(QStringLiteral(":path%1").arg(i));
+        }
+
+        const auto statement = QStringLiteral("SELECT %1 FROM TracksView WHERE FilePath IN (%2)")
+                                   .arg(fetchTrackColumns(), params.join(u','));
+
+        DbQuery q{db(), statement};
+
+        for(qsizetype i{0}; i < batch.size(); ++i) {
+            q.bindValue(params.at(i), Utils::File::cleanPath(batch.at(i)));
+        }
+
+        if(!q.exec()) {
+            return tracks;
+        }
+
+        while(q.next()) {
+            tracks.emplace_back(readToTrack(q));
+        }
+    }
+
+    return tracks;
+}
+
+TrackList TrackDatabase::tracksInDirectory(const QString& dir) const
+{
+    const auto statement
+        = QStringLiteral("SELECT %1 FROM TracksView WHERE SUBSTR(FilePath, 1, :length) = :dir")
+              .arg(fetchTrackColumns());
+
+    DbQuery q{db(), statement};
+
+    const QString dirPath = Utils::File::cleanPath(dir) + u'/';
+    q.bindValue(QStringLiteral(":length"), dirPath.toUcs4().size());
+    q.bindValue(QStringLiteral(":dir"), dirPath);
+
+    TrackList tracks;
+
+    if(!q.exec()) {
+        return tracks;
+    }
+
+    while(q.next()) {
+        tracks.emplace_back(readToTrack(q));
+    }
+
+    return tracks;
+}
+
 bool TrackDatabase::updateTrack(const Track& track)
 {
     if(track.id() < 0) {
@@ -282,6 +384,10 @@ bool TrackDatabase::updateTrack(const Track& track)
                                           "SampleRate = :sampleRate,"
                                           "Channels = :channels,"
                                           "ExtraTags = :extraTags,"
+                                          "CoverLocations = :coverLocations,"
+                                          "Device = :device,"
+                                          "Inode = :inode,"
+                                          "Fingerprint = :fingerprint,"
                                           "Type = :type,"
                                           "ModifiedDate = :modifiedDate,"
                                           "TrackHash = :trackHash,"
@@ -300,6 +406,29 @@ bool TrackDatabase::updateTrack(const Track& track)
     return query.exec();
 }
 
+TrackList TrackDatabase::updateTracks(const TrackList& tracks)
+{
+    DbTransaction transaction{db()};
+
+    if(!transaction) {
+        return {};
+    }
+
+    TrackList updatedTracks;
+
+    for(const Track& track : tracks) {
+        if(updateTrack(track)) {
+            updatedTracks.push_back(track);
+        }
+    }
+
+    if(!transaction.commit()) {
+        return {};
+    }
+
+    return updatedTracks;
+}
+
 bool TrackDatabase::updateTrackStats(const TrackList& tracks)
 {
     bool success{true};
@@ -315,6 +444,29 @@ bool TrackDatabase::updateTrackStats(const TrackList& tracks)
     return success && transaction.commit();
 }
 
+bool TrackDatabase::updateCoverLocations(const TrackList& tracks)
+{
+    const QString statement
+        = QStringLiteral("UPDATE Tracks SET CoverLocations = :coverLocations WHERE TrackID = :trackId;");
+
+    bool success{true};
+
+    DbTransaction transaction{db()};
+
+    for(const Track& track : tracks) {
+        DbQuery query{db(), statement};
+
+        query.bindValue(QStringLiteral(":coverLocations"), track.serialiseCoverLocations());
+        query.bindValue(QStringLiteral(":trackId"), track.id());
+
+        if(!query.exec()) {
+            success = false;
+        }
+    }
+
+    return success && transaction.commit();
+}
+
 bool TrackDatabase::deleteTrack(int id)
 {
     const QString statement = QStringLiteral("DELETE FROM Tracks WHERE TrackID = :trackID;");
@@ -444,7 +596,11 @@ void TrackDatabase::insertViews(const QSqlDatabase& db)
                                           "TrackStats.FirstPlayed,"
                                           "TrackStats.LastPlayed,"
                                           "TrackStats.PlayCount,"
-                                          "TrackStats.Rating"
+                                          "TrackStats.Rating,"
+                                          "Tracks.CoverLocations,"
+                                          "Tracks.Device,"
+                                          "Tracks.Inode,"
+                                          "Tracks.Fingerprint"
                                           " FROM Tracks "
                                           "LEFT JOIN Libraries ON Tracks.LibraryID = Libraries.LibraryID "
                                           "LEFT JOIN TrackStats ON Tracks.TrackHash = TrackStats.TrackHash;");
@@ -494,6 +650,10 @@ bool TrackDatabase::insertTrack(Track& track) const
                                           "SampleRate,"
                                           "Channels,"
                                           "ExtraTags,"
+                                          "CoverLocations,"
+                                          "Device,"
+                                          "Inode,"
+                                          "Fingerprint,"
                                           "Type,"
                                           "ModifiedDate,"
                                           "TrackHash,"
@@ -520,6 +680,10 @@ bool TrackDatabase::insertTrack(Track& track) const
                                           ":sampleRate,"
                                           ":channels,"
                                           ":extraTags, "
+                                          ":coverLocations,"
+                                          ":device,"
+                                          ":inode,"
+                                          ":fingerprint,"
                                           ":type,"
                                           ":modifiedDate,"
                                           ":trackHash,"
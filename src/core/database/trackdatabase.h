@@ -33,10 +33,18 @@ public:
     bool reloadTrack(Track& track) const;
     bool reloadTracks(TrackList& tracks) const;
     [[nodiscard]] TrackList getAllTracks() const;
+    /** Returns the tracks of the playlist with @p playlistId in playlist order, without loading the library. */
+    [[nodiscard]] TrackList playlistTracks(int playlistId) const;
     [[nodiscard]] TrackList tracksByHash(const QString& hash) const;
+    [[nodiscard]] TrackList tracksByPaths(const QStringList& paths) const;
+    [[nodiscard]] TrackList tracksInDirectory(const QString& dir) const;
 
     bool updateTrack(const Track& track);
+    /** Updates @p tracks in a single transaction and returns those which were updated. */
+    TrackList updateTracks(const TrackList& tracks);
     bool updateTrackStats(const TrackList& track);
+    /** Stores the cover locations of @p tracks, without rewriting the rest of their data. */
+    bool updateCoverLocations(const TrackList& tracks);
 
     bool deleteTrack(int id);
     bool deleteTracks(const TrackList& tracks);
@@ -21,9 +21,112 @@
 
 #include <QDebug>
 
+#include <algorithm>
+#include <mutex>
 #include <ranges>
 #include <utility>
 
+namespace {
+using Storage = std::vector<std::byte>;
+
+/*!
+ * Recycles the control blocks and sample storage of released buffers,
+ * so decoding and rendering don't allocate once playback has warmed up.
+ */
+class AudioBufferPool
+{
+public:
+    static constexpr size_t MaxPooled = 64;
+    // Larger storage is freed rather than pooled, so a few oversized buffers can't stay resident
+    static constexpr size_t MaxPooledCapacity = 1024 * 1024;
+
+    static AudioBufferPool& instance()
+    {
+        // Never destroyed, as buffers may still be released during static destruction
+        static auto* pool = new AudioBufferPool();
+        return *pool;
+    }
+
+    void* takeBlock(size_t size)
+    {
+        {
+            const std::scoped_lock lock{m_mutex};
+            if(size == m_blockSize && !m_blocks.empty()) {
+                void* block = m_blocks.back();
+                m_blocks.pop_back();
+                return block;
+            }
+        }
+        return ::operator new(size);
+    }
+
+    void recycleBlock(void* block, size_t size)
+    {
+        {
+            const std::scoped_lock lock{m_mutex};
+            if(m_blocks.size() < MaxPooled) {
+                m_blockSize = size;
+                m_blocks.push_back(block);
+                return;
+            }
+        }
+        ::operator delete(block);
+    }
+
+    // Returns empty storage, preferring the smallest which can already hold @p capacity bytes
+    Storage takeStorage(size_t capacity)
+    {
+        const std::scoped_lock lock{m_mutex};
+
+        if(m_storage.empty()) {
+            return {};
+        }
+
+        auto storageIt = m_storage.end();
+        for(auto it = m_storage.begin(); it != m_storage.end(); ++it) {
+            if(it->capacity() >= capacity && (storageIt == m_storage.end() || it->capacity() < storageIt->capacity())) {
+                storageIt = it;
+            }
+        }
+        if(storageIt == m_storage.end()) {
+            // Growing the largest means it will fit next time
+            storageIt = std::ranges::max_element(m_storage, {}, &Storage::capacity);
+        }
+
+        Storage storage = std::move(*storageIt);
+        *storageIt      = std::move(m_storage.back());
+        m_storage.pop_back();
+        return storage;
+    }
+
+    void recycleStorage(Storage&& storage)
+    {
+        if(storage.capacity() == 0 || storage.capacity() > MaxPooledCapacity) {
+            return;
+        }
+
+        storage.clear();
+
+        const std::scoped_lock lock{m_mutex};
+        if(m_storage.size() < MaxPooled) {
+            m_storage.push_back(std::move(storage));
+        }
+    }
+
+private:
+    AudioBufferPool()
+    {
+        m_blocks.reserve(MaxPooled);
+        m_storage.reserve(MaxPooled);
+    }
+
+    std::mutex m_mutex;
+    size_t m_blockSize{0};
+    std::vector<void*> m_blocks;
+    std::vector<Storage> m_storage;
+};
+} // namespace
+
 namespace Fooyin {
 struct AudioBuffer::Private : QSharedData
 {
@@ -32,20 +135,68 @@ struct AudioBuffer::Private : QSharedData
     uint64_t startTime;
 
     Private(std::span<const std::byte> data_, AudioFormat format_, uint64_t startTime_)
-        : format{format_}
+        : buffer{AudioBufferPool::instance().takeStorage(data_.size())}
+        , format{format_}
         , startTime{startTime_}
     {
         buffer.assign(data_.begin(), data_.end());
     }
 
     Private(const uint8_t* data_, size_t size, AudioFormat format_, uint64_t startTime_)
-        : format{format_}
+        : buffer{AudioBufferPool::instance().takeStorage(size)}
+        , format{format_}
         , startTime{startTime_}
     {
         buffer.resize(size);
         std::memmove(buffer.data(), data_, size);
     }
 
+    Private(const Private& other)
+        : QSharedData{other}
+        , buffer{AudioBufferPool::instance().takeStorage(other.buffer.size())}
+        , format{other.format}
+        , startTime{other.startTime}
+    {
+        buffer.assign(other.buffer.cbegin(), other.buffer.cend());
+    }
+
+    Private& operator=(const Private&) = delete;
+
+    ~Private()
+    {
+        AudioBufferPool::instance().recycleStorage(std::move(buffer));
+    }
+
+    static void* operator new(size_t size)
+    {
+        return AudioBufferPool::instance().takeBlock(size);
+    }
+
+    static void operator delete(void* block, size_t size)
+    {
+        AudioBufferPool::instance().recycleBlock(block, size);
+    }
+
+    // Swaps in pooled storage with room for @p size bytes, keeping the current contents
+    void reserve(size_t size)
+    {
+        if(buffer.capacity() >= size) {
+            return;
+        }
+
+        Storage storage = AudioBufferPool::instance().takeStorage(size);
+        storage.reserve(size);
+        storage.assign(buffer.cbegin(), buffer.cend());
+        AudioBufferPool::instance().recycleStorage(std::exchange(buffer, std::move(storage)));
+    }
+
+    void grow(size_t size)
+    {
+        if(buffer.capacity() < size) {
+            reserve(std::max(size, buffer.capacity() * 2));
+        }
+    }
+
     void fillSilence()
     {
         const bool unsignedFormat = format.sampleFormat() == SampleFormat::U8;
@@ -97,13 +248,14 @@ AudioBuffer::AudioBuffer(AudioBuffer&& other) noexcept        = default;
 void AudioBuffer::reserve(size_t size)
 {
     if(isValid()) {
-        p->buffer.reserve(size);
+        p->reserve(size);
     }
 }
 
 void AudioBuffer::resize(size_t size)
 {
     if(isValid()) {
+        p->reserve(size);
         p->buffer.resize(size);
     }
 }
@@ -119,6 +271,7 @@ void AudioBuffer::append(const std::byte* data, size_t size)
 {
     if(isValid()) {
         const size_t index = p->buffer.size();
+        p->grow(index + size);
         p->buffer.resize(index + size);
         std::memcpy(p->buffer.data() + index, data, size);
     }
@@ -26,13 +26,19 @@
 #include <core/coresettings.h>
 #include <core/engine/audiobuffer.h>
 #include <core/engine/audiodecoder.h>
+#include <core/engine/enginemetrics.h>
+#include <core/engine/replaygain.h>
 #include <core/track.h>
+#include <utils/async.h>
 #include <utils/settings/settingsmanager.h>
 
 #include <QBasicTimer>
+#include <QDebug>
 #include <QTimer>
 #include <QTimerEvent>
 
+#include <optional>
+
 using namespace std::chrono_literals;
 
 #if QT_VERSION >= QT_VERSION_CHECK(6, 5, 0)
@@ -42,11 +48,15 @@ constexpr auto BufferInterval = 5;
 #endif
 
 namespace Fooyin {
+// Time taken to open the track, or nullopt if it couldn't be opened
+using OpenResult = std::optional<std::chrono::steady_clock::duration>;
+
 struct AudioPlaybackEngine::Private
 {
     AudioEngine* self;
 
     SettingsManager* settings;
+    EngineMetrics* metrics;
 
     AudioClock clock;
     QTimer* positionUpdateTimer{nullptr};
@@ -58,29 +68,74 @@ struct AudioPlaybackEngine::Private
 
     uint64_t totalBufferTime{0};
     uint64_t bufferLength{0};
+    uint64_t preloadTime{0};
+    int fadeLength{0};
 
     uint64_t duration{0};
+    uint64_t decodeDuration{0};
     double volume{1.0};
 
     AudioFormat format;
 
+    Track track;
+    bool pcmTapEnabled{false};
+    bool pcmTapStreaming{false};
+
+    bool aboutToFinishSent{false};
+    bool inputFinished{false};
+
     std::unique_ptr<AudioDecoder> decoder;
     AudioRenderer* renderer;
 
+    // Opened ahead of time by prepareNextTrack
+    std::unique_ptr<AudioDecoder> nextDecoder;
+    Track nextTrack;
+    // nextDecoder is being opened on a worker thread and mustn't be used until it finishes
+    QFuture<OpenResult> nextOpen;
+    bool nextOpening{false};
+    // The track nextDecoder should be opened for once it's free
+    Track openingTrack;
+    // Being decoded after the current track, but changeTrack hasn't been called for it yet
+    Track splicedTrack;
+    bool spliceHeard{false};
+
+    // Waiting for the renderer to fade out
+    std::optional<uint64_t> pendingSeek;
+    bool pendingStop{false};
+
     QBasicTimer bufferTimer;
 
-    explicit Private(AudioEngine* self_, SettingsManager* settings_)
+    Private(AudioEngine* self_, SettingsManager* settings_, EngineMetrics* metrics_)
         : self{self_}
         , settings{settings_}
+        , metrics{metrics_}
         , bufferLength{static_cast<uint64_t>(settings->value<Settings::Core::BufferLength>())}
+        , preloadTime{static_cast<uint64_t>(settings->value<Settings::Core::NextTrackPreload>())}
+        , fadeLength{settings->value<Settings::Core::FadeLength>()}
         , decoder{std::make_unique<FFmpegDecoder>()}
-        , renderer{new AudioRenderer(self)}
+        , renderer{new AudioRenderer(metrics, self)}
+        , nextDecoder{std::make_unique<FFmpegDecoder>()}
     {
         settings->subscribe<Settings::Core::BufferLength>(self, [this](int length) { bufferLength = length; });
+        settings->subscribe<Settings::Core::NextTrackPreload>(self, [this](int time) { preloadTime = time; });
+        settings->subscribe<Settings::Core::FadeLength>(self, [this](int length) {
+            fadeLength = length;
+            renderer->setFadeLength(length);
+        });
+        settings->subscribe<Settings::Core::CrossfadeLength>(
+            self, [this](int length) { renderer->setCrossfadeLength(length); });
+
+        settings->subscribe<Settings::Core::ReplayGainMode>(self, [this]() { updateReplayGain(); });
+        settings->subscribe<Settings::Core::ReplayGainPreamp>(self, [this]() { updateReplayGain(); });
+        settings->subscribe<Settings::Core::ReplayGainNoClip>(self, [this]() { updateReplayGain(); });
+
+        renderer->setFadeLength(fadeLength);
+        renderer->setCrossfadeLength(settings->value<Settings::Core::CrossfadeLength>());
 
         QObject::connect(renderer, &AudioRenderer::bufferProcessed, self,
                          [this](const AudioBuffer& buffer) { totalBufferTime -= buffer.duration(); });
         QObject::connect(renderer, &AudioRenderer::finished, self, [this]() { onRendererFinished(); });
+        QObject::connect(renderer, &AudioRenderer::paused, self, [this]() { onRendererPaused(); });
         QObject::connect(renderer, &AudioRenderer::outputStateChanged, self,
                          [this](AudioOutput::State outState) { handleOutputState(outState); });
     }
@@ -102,17 +157,163 @@ struct AudioPlaybackEngine::Private
             return;
         }
 
-        const auto bytesLeft = static_cast<size_t>(format.bytesForDuration(bufferLength - totalBufferTime));
-        const auto buffer    = decoder->readBuffer(bytesLeft);
+        const auto bytesLeft   = static_cast<size_t>(format.bytesForDuration(bufferLength - totalBufferTime));
+        const auto decodeStart = std::chrono::steady_clock::now();
+        const auto buffer      = decoder->readBuffer(bytesLeft);
+        metrics->recordDecode(std::chrono::steady_clock::now() - decodeStart);
+
+        if(pcmTapStreaming) {
+            emit self->pcmDecoded(decodingTrack(), buffer);
+            pcmTapStreaming = buffer.isValid();
+        }
+
         if(buffer.isValid()) {
             totalBufferTime += buffer.duration();
             renderer->queueBuffer(buffer);
+
+            if(!aboutToFinishSent && decodeDuration > 0
+               && buffer.startTime() + buffer.duration() + preloadTime >= decodeDuration) {
+                aboutToFinishSent = true;
+                QMetaObject::invokeMethod(self, &AudioEngine::trackAboutToFinish);
+            }
+            return;
         }
-        else {
-            bufferTimer.stop();
-            renderer->queueBuffer({});
+
+        bufferTimer.stop();
+        renderer->queueBuffer({});
+        inputFinished = true;
+
+        if(!std::exchange(aboutToFinishSent, true)) {
             QMetaObject::invokeMethod(self, &AudioEngine::trackAboutToFinish);
         }
+        else {
+            spliceNextTrack();
+        }
+    }
+
+    [[nodiscard]] float replayGain(const Track& gainTrack) const
+    {
+        return ReplayGain::playbackGain(
+            gainTrack, static_cast<ReplayGain::Mode>(settings->value<Settings::Core::ReplayGainMode>()),
+            settings->value<Settings::Core::ReplayGainPreamp>(), settings->value<Settings::Core::ReplayGainNoClip>());
+    }
+
+    void updateReplayGain()
+    {
+        renderer->setReplayGain(replayGain(spliceHeard ? splicedTrack : track));
+        if(splicedTrack.isValid() && !spliceHeard) {
+            renderer->setNextReplayGain(replayGain(splicedTrack));
+        }
+    }
+
+    [[nodiscard]] const Track& decodingTrack() const
+    {
+        return splicedTrack.isValid() ? splicedTrack : track;
+    }
+
+    /*!
+     * Continues decoding from the pre-opened next track once the current track has been fully queued.
+     * The renderer plays past the end of track marker if more audio follows, so there is no gap.
+     */
+    void spliceNextTrack()
+    {
+        if(!inputFinished || !nextTrack.isValid() || splicedTrack.isValid() || state != PlaybackState::Playing
+           || !settings->value<Settings::Core::GaplessPlayback>() || nextDecoder->format() != format) {
+            return;
+        }
+
+        std::swap(decoder, nextDecoder);
+        nextDecoder->stop();
+
+        splicedTrack      = std::exchange(nextTrack, {});
+        decodeDuration    = splicedTrack.duration();
+        aboutToFinishSent = false;
+        inputFinished     = false;
+        pcmTapStreaming   = pcmTapEnabled;
+
+        renderer->setNextReplayGain(replayGain(splicedTrack));
+
+        decoder->start();
+        startBufferTimer();
+        // Queue the start of the next track straight away in case the renderer is close to the end marker
+        readNextBuffer();
+    }
+
+    /** Drops the spliced track, returning to decoding the current track if it hasn't been reached yet. */
+    void cancelSplice()
+    {
+        if(!splicedTrack.isValid()) {
+            return;
+        }
+
+        interruptPcmTap();
+
+        if(std::exchange(spliceHeard, false)) {
+            splicedTrack = {};
+            return;
+        }
+
+        std::swap(decoder, nextDecoder);
+        nextDecoder->stop();
+        decoder->start();
+
+        nextTrack      = std::exchange(splicedTrack, {});
+        decodeDuration = track.duration();
+    }
+
+    // Opens the next track off the engine thread, so the renderer keeps being fed
+    void openNextTrack(const Track& trackToOpen)
+    {
+        nextOpening = true;
+
+        auto* decoderToOpen = nextDecoder.get();
+        nextOpen = Utils::asyncExec([decoderToOpen, filepath = trackToOpen.filepath()]() -> OpenResult {
+            const auto openStart = std::chrono::steady_clock::now();
+            if(!decoderToOpen->init(filepath)) {
+                return {};
+            }
+            return std::chrono::steady_clock::now() - openStart;
+        });
+        nextOpen.then(self, [this, trackToOpen](const OpenResult& openTime) {
+            nextTrackOpened(trackToOpen, openTime);
+        });
+    }
+
+    void nextTrackOpened(const Track& openedTrack, const OpenResult& openTime)
+    {
+        nextOpening = false;
+
+        if(openTime) {
+            metrics->recordTrackOpen(*openTime);
+            qDebug() << "[Engine] Opened next track in"
+                     << std::chrono::duration_cast<std::chrono::microseconds>(*openTime).count() << "µs";
+        }
+        else {
+            qDebug() << "[Engine] Unable to open next track:" << openedTrack.filepath();
+        }
+
+        if(openingTrack != openedTrack) {
+            // A different track was requested while this one was opening
+            if(openingTrack.isValid()) {
+                openNextTrack(openingTrack);
+            }
+            return;
+        }
+
+        openingTrack = {};
+
+        if(openTime) {
+            nextTrack = openedTrack;
+            // The current track may have finished decoding before this arrived
+            spliceNextTrack();
+        }
+    }
+
+    void interruptPcmTap()
+    {
+        if(std::exchange(pcmTapStreaming, false)) {
+            emit self->pcmTapInterrupted(decodingTrack());
+        }
     }
 
     void handleOutputState(AudioOutput::State outState)
@@ -151,6 +352,11 @@ struct AudioPlaybackEngine::Private
         if(std::exchange(lastPosition, clock.currentPosition()) != lastPosition) {
             emit self->positionChanged(lastPosition);
         }
+
+        if(const auto played = renderer->playbackPosition()) {
+            const auto clockPosition = clock.positionFromTime(played->time);
+            metrics->recordClockDrift(static_cast<int64_t>(clockPosition) - static_cast<int64_t>(played->position));
+        }
     }
 
     bool updateFormat(const AudioFormat& nextFormat)
@@ -179,12 +385,74 @@ struct AudioPlaybackEngine::Private
 
     void onRendererFinished()
     {
+        if(splicedTrack.isValid() && !spliceHeard) {
+            // The next track follows without a gap, so keep the clock running from its start
+            spliceHeard = true;
+            clock.sync(0);
+            metrics->gaplessTransitions.fetch_add(1, std::memory_order_relaxed);
+            changeTrackStatus(TrackStatus::EndOfTrack);
+            return;
+        }
+
+        inputFinished = false;
         clock.setPaused(true);
         clock.sync(duration);
 
         changeTrackStatus(TrackStatus::EndOfTrack);
     }
 
+    [[nodiscard]] bool shouldFade() const
+    {
+        return fadeLength > 0 && state == PlaybackState::Playing && !renderer->isPaused();
+    }
+
+    void onRendererPaused()
+    {
+        if(std::exchange(pendingStop, false)) {
+            pendingSeek.reset();
+            if(state == PlaybackState::Stopped) {
+                stopWorkers(true);
+                interruptPcmTap();
+            }
+            return;
+        }
+
+        if(const auto pos = std::exchange(pendingSeek, {})) {
+            seekDecoder(*pos);
+        }
+    }
+
+    void seekDecoder(uint64_t pos)
+    {
+        const bool splicePending = splicedTrack.isValid() && !spliceHeard;
+        if(!(splicePending ? nextDecoder : decoder)->isSeekable()) {
+            return;
+        }
+
+        resetWorkers();
+        if(splicePending) {
+            cancelSplice();
+        }
+        aboutToFinishSent = nextTrack.isValid();
+        interruptPcmTap();
+
+        decoder->seek(pos);
+        clock.sync(pos);
+
+        if(state == PlaybackState::Playing) {
+            clock.setPaused(false);
+            startBufferTimer();
+            if(renderer->isPaused()) {
+                // Faded out for the seek
+                renderer->pause(false);
+            }
+            renderer->start();
+        }
+        else {
+            updatePosition();
+        }
+    }
+
     void pauseOutput(bool pause)
     {
         if(pause) {
@@ -203,10 +471,15 @@ struct AudioPlaybackEngine::Private
         clock.setPaused(true);
         renderer->reset();
         totalBufferTime = 0;
+        inputFinished   = false;
     }
 
     void stopWorkers(bool full = false)
     {
+        cancelSplice();
+        pendingSeek.reset();
+        pendingStop = false;
+
         bufferTimer.stop();
         clock.setPaused(true);
         clock.sync();
@@ -217,16 +490,18 @@ struct AudioPlaybackEngine::Private
         }
         decoder->stop();
         totalBufferTime = 0;
+        inputFinished   = false;
     }
 };
 
-AudioPlaybackEngine::AudioPlaybackEngine(SettingsManager* settings, QObject* parent)
+AudioPlaybackEngine::AudioPlaybackEngine(SettingsManager* settings, EngineMetrics* metrics, QObject* parent)
     : AudioEngine{parent}
-    , p{std::make_unique<Private>(this, settings)}
+    , p{std::make_unique<Private>(this, settings, metrics)}
 { }
 
 AudioPlaybackEngine::~AudioPlaybackEngine()
 {
+    p->nextOpen.waitForFinished();
     p->stopWorkers();
 
     if(p->positionUpdateTimer) {
@@ -236,28 +511,37 @@ AudioPlaybackEngine::~AudioPlaybackEngine()
 
 void AudioPlaybackEngine::seek(uint64_t pos)
 {
-    if(!p->decoder->isSeekable()) {
+    if(p->pendingSeek || p->shouldFade()) {
+        // Seek once the fade out has been heard
+        p->pendingSeek = pos;
+        p->bufferTimer.stop();
+        p->clock.setPaused(true);
+        p->clock.sync(pos);
+        p->renderer->pause(true);
         return;
     }
 
-    p->resetWorkers();
-
-    p->decoder->seek(pos);
-    p->clock.sync(pos);
-
-    if(p->state == PlaybackState::Playing) {
-        p->clock.setPaused(false);
-        p->startBufferTimer();
-        p->renderer->start();
-    }
-    else {
-        p->updatePosition();
-    }
+    p->seekDecoder(pos);
 }
 
 void AudioPlaybackEngine::changeTrack(const Track& track)
 {
+    if(p->spliceHeard && track == p->splicedTrack) {
+        // Spliced after the previous track and already playing
+        p->track       = std::exchange(p->splicedTrack, {});
+        p->spliceHeard = false;
+        p->duration    = track.duration();
+        p->changeTrackStatus(TrackStatus::LoadedTrack);
+
+        if(p->aboutToFinishSent && !p->nextTrack.isValid()) {
+            // The request made while the splice was pending was ignored
+            emit trackAboutToFinish();
+        }
+        return;
+    }
+
     p->stopWorkers();
+    p->interruptPcmTap();
 
     emit positionChanged(0);
 
@@ -271,16 +555,34 @@ void AudioPlaybackEngine::changeTrack(const Track& track)
 
     p->changeTrackStatus(TrackStatus::LoadingTrack);
 
-    if(!p->decoder->init(track.filepath())) {
-        p->changeTrackStatus(TrackStatus::InvalidTrack);
-        return;
+    if(p->nextTrack.isValid() && p->nextTrack == track) {
+        std::swap(p->decoder, p->nextDecoder);
+        p->metrics->preopenedTracks.fetch_add(1, std::memory_order_relaxed);
     }
+    else {
+        const auto openStart = std::chrono::steady_clock::now();
+        if(!p->decoder->init(track.filepath())) {
+            p->nextTrack = {};
+            p->changeTrackStatus(TrackStatus::InvalidTrack);
+            return;
+        }
+        p->metrics->recordTrackOpen(std::chrono::steady_clock::now() - openStart);
+    }
+
+    p->nextTrack         = {};
+    p->openingTrack      = {};
+    p->track             = track;
+    p->duration          = track.duration();
+    p->decodeDuration    = track.duration();
+    p->aboutToFinishSent = false;
+    p->pcmTapStreaming   = p->pcmTapEnabled;
 
     if(!p->updateFormat(p->decoder->format())) {
         p->changeTrackStatus(TrackStatus::NoTrack);
         return;
     }
 
+    p->renderer->setReplayGain(p->replayGain(track));
     p->changeTrackStatus(TrackStatus::LoadedTrack);
 
     if(p->state == PlaybackState::Playing) {
@@ -290,17 +592,31 @@ void AudioPlaybackEngine::changeTrack(const Track& track)
 
 void AudioPlaybackEngine::setState(PlaybackState state)
 {
+    const bool fade      = p->shouldFade();
     const auto prevState = p->changeState(state);
 
     p->clock.setPaused(state != PlaybackState::Playing);
 
     if(state == PlaybackState::Stopped) {
+        if(fade || p->pendingSeek) {
+            // Stop once the fade out has been heard
+            p->pendingStop = true;
+            p->bufferTimer.stop();
+            p->renderer->pause(true);
+            return;
+        }
         p->stopWorkers(true);
+        p->interruptPcmTap();
     }
     else if(state == PlaybackState::Paused) {
         p->pauseOutput(true);
     }
     else if(state == PlaybackState::Playing) {
+        if(p->pendingStop) {
+            p->stopWorkers(true);
+            p->interruptPcmTap();
+        }
+
         if(p->outputState == AudioOutput::State::Disconnected) {
             if(p->renderer->init(p->format)) {
                 p->outputState = AudioOutput::State::None;
@@ -315,6 +631,37 @@ void AudioPlaybackEngine::setState(PlaybackState state)
         if(prevState == PlaybackState::Paused) {
             p->pauseOutput(false);
         }
+
+        if(const auto pos = std::exchange(p->pendingSeek, {})) {
+            // Resumed before the seek fade finished
+            p->seekDecoder(*pos);
+        }
+    }
+}
+
+void AudioPlaybackEngine::prepareNextTrack(const Track& track)
+{
+    if(p->splicedTrack.isValid()) {
+        // nextDecoder is reserved until the splice is resolved; the request is repeated in changeTrack
+        return;
+    }
+
+    if(!track.isValid()) {
+        p->nextTrack    = {};
+        p->openingTrack = {};
+        return;
+    }
+
+    if((p->nextTrack.isValid() && p->nextTrack == track) || (p->openingTrack.isValid() && p->openingTrack == track)) {
+        return;
+    }
+
+    p->nextTrack    = {};
+    p->openingTrack = track;
+
+    if(!p->nextOpening) {
+        // Otherwise opened once the current open finishes
+        p->openNextTrack(track);
     }
 }
 
@@ -420,6 +767,15 @@ void AudioPlaybackEngine::setOutputDevice(const QString& device)
     }
 }
 
+void AudioPlaybackEngine::setPcmTapEnabled(bool enabled)
+{
+    p->pcmTapEnabled = enabled;
+
+    if(!enabled) {
+        p->pcmTapStreaming = false;
+    }
+}
+
 void AudioPlaybackEngine::timerEvent(QTimerEvent* event)
 {
     if(event->timerId() == p->bufferTimer.timerId()) {
@@ -23,13 +23,14 @@
 
 namespace Fooyin {
 class SettingsManager;
+struct EngineMetrics;
 
 class AudioPlaybackEngine : public AudioEngine
 {
     Q_OBJECT
 
 public:
-    explicit AudioPlaybackEngine(SettingsManager* settings, QObject* parent = nullptr);
+    AudioPlaybackEngine(SettingsManager* settings, EngineMetrics* metrics, QObject* parent = nullptr);
     ~AudioPlaybackEngine() override;
 
 public slots:
@@ -38,6 +39,8 @@ public slots:
     void changeTrack(const Track& track) override;
     void setState(PlaybackState state) override;
 
+    void prepareNextTrack(const Track& track) override;
+
     void play() override;
     void pause() override;
     void stop() override;
@@ -47,6 +50,8 @@ public slots:
     void setAudioOutput(const OutputCreator& output) override;
     void setOutputDevice(const QString& device) override;
 
+    void setPcmTapEnabled(bool enabled) override;
+
 protected:
     void timerEvent(QTimerEvent* event) override;
 
@@ -19,39 +19,92 @@
 
 #include "audiorenderer.h"
 
+#include "engine/dsp/crossfadenode.h"
+#include "engine/dsp/dspchain.h"
+#include "engine/dsp/fadenode.h"
+#include "engine/dsp/gainnode.h"
+
 #include <core/engine/audiobuffer.h>
+#include <core/engine/audioconverter.h>
 #include <core/engine/audiooutput.h>
+#include <core/engine/enginemetrics.h>
 #include <utils/threadqueue.h>
 
 #include <QDebug>
 #include <QTimer>
+
+#include <algorithm>
+#include <deque>
 #include <utility>
 
+// Enough for the default 4s buffer of 20ms packets several times over
+constexpr size_t QueueCapacity = 1024;
+
 namespace Fooyin {
 struct AudioRenderer::Private
 {
     AudioRenderer* self;
+    EngineMetrics* metrics;
 
     std::unique_ptr<AudioOutput> audioOutput;
     AudioFormat format;
+    AudioFormat floatFormat;
     double volume{0.0};
     int bufferSize{0};
 
+    DspChain dspChain;
+    GainNode replayGain;
+    CrossfadeNode crossfade;
+    FadeNode fade;
+    int crossfadeLength{0};
+    int fadeLength{0};
+
     bool bufferPrefilled{false};
 
     ThreadQueue<AudioBuffer> bufferQueue{false};
     AudioBuffer tempBuffer;
+    // Sized for the output's buffer when the format is set, so draining doesn't allocate
+    AudioBuffer silenceBuffer;
     int totalSamplesWritten{0};
     int currentBufferOffset{0};
+    uint64_t queuedDuration{0};
+    bool inputFinished{false};
+    bool queueStarved{false};
+
+    std::optional<uint64_t> writePosition;
+    std::optional<PlaybackPosition> playbackPosition;
+
+    // Position of each queued end of track marker, in frames queued
+    std::deque<uint64_t> markerFrames;
+    uint64_t framesQueued{0};
+    uint64_t framesRead{0};
+
+    // Read position of the next track while crossfading, relative to the end of track marker
+    bool crossfading{false};
+    size_t itemsBeforeMarker{0};
+    size_t nextItem{0};
+    int nextItemOffset{0};
+    uint64_t nextFramesRead{0};
 
     bool isRunning{false};
+    bool pausing{false};
+    int drainFrames{0};
 
     QTimer* writeTimer;
 
-    explicit Private(AudioRenderer* self_)
+    explicit Private(AudioRenderer* self_, EngineMetrics* metrics_)
         : self{self_}
+        , metrics{metrics_}
         , writeTimer{new QTimer(self)}
     {
+        // Reserved up front so queueing packets doesn't allocate during playback
+        bufferQueue.reserve(QueueCapacity);
+
+        // Gain is applied before the crossfade, which scales the next track's input itself
+        dspChain.addNode(&replayGain);
+        dspChain.addNode(&crossfade);
+        dspChain.addNode(&fade);
+
         QObject::connect(writeTimer, &QTimer::timeout, self, [this]() { writeNext(); });
     }
 
@@ -65,6 +118,14 @@ struct AudioRenderer::Private
         bufferSize = audioOutput->bufferSize();
         updateInterval();
 
+        floatFormat = {SampleFormat::Float, format.sampleRate(), format.channelCount()};
+        dspChain.prepare(format, bufferSize);
+
+        silenceBuffer = AudioBuffer{format, 0};
+        silenceBuffer.reserve(static_cast<size_t>(format.bytesForFrames(bufferSize)));
+        pausing = false;
+        fade.reset();
+
         return true;
     }
 
@@ -73,8 +134,19 @@ struct AudioRenderer::Private
         bufferPrefilled     = false;
         totalSamplesWritten = 0;
         currentBufferOffset = 0;
+        queuedDuration      = 0;
+        inputFinished       = false;
+        queueStarved        = false;
         bufferQueue.clear();
         tempBuffer.reset();
+        writePosition.reset();
+        playbackPosition.reset();
+        markerFrames.clear();
+        framesQueued = 0;
+        framesRead   = 0;
+        crossfading  = false;
+        crossfade.reset();
+        replayGain.reset();
     }
 
     void outputStateChanged(AudioOutput::State state) const
@@ -93,11 +165,43 @@ struct AudioRenderer::Private
 
     void writeNext()
     {
-        if(!isRunning || bufferQueue.empty() || !audioOutput->initialised()) {
+        if(!isRunning || !audioOutput->initialised()) {
             return;
         }
 
-        const int samples = audioOutput->currentState().freeSamples;
+        if(pausing && fade.isSilent()) {
+            drainOutput();
+            return;
+        }
+
+        if(bufferQueue.empty()) {
+            if(pausing) {
+                finishPause();
+                return;
+            }
+            if(bufferPrefilled && !inputFinished && !std::exchange(queueStarved, true)) {
+                metrics->queueUnderruns.fetch_add(1, std::memory_order_relaxed);
+            }
+            return;
+        }
+        queueStarved = false;
+
+        const OutputState state = audioOutput->currentState();
+        const int samples       = state.freeSamples;
+
+        metrics->recordQueueDepth(queuedDuration);
+        metrics->recordOutputDelay(state.delay);
+        metrics->outputUnderruns.store(static_cast<uint64_t>(state.underruns), std::memory_order_relaxed);
+
+        if(writePosition) {
+            const auto delay = static_cast<uint64_t>(std::max(state.delay, 0.0) * 1000);
+            playbackPosition = PlaybackPosition{.time     = std::chrono::steady_clock::now(),
+                                                .position = *writePosition - std::min(*writePosition, delay)};
+        }
+
+        if(samples == 0) {
+            metrics->outputFull.fetch_add(1, std::memory_order_relaxed);
+        }
 
         if((samples == 0 && totalSamplesWritten > 0) || (samples > 0 && renderAudio(samples) == samples)) {
             if(!bufferPrefilled) {
@@ -107,9 +211,143 @@ struct AudioRenderer::Private
         }
     }
 
+    void finishPause()
+    {
+        pausing   = false;
+        isRunning = false;
+
+        if(audioOutput && audioOutput->initialised()) {
+            audioOutput->setPaused(true);
+        }
+
+        emit self->paused();
+    }
+
+    void drainOutput()
+    {
+        // Write silence until everything up to the end of the fade has been played, then pause
+        if(!tempBuffer.isValid() || drainFrames >= bufferSize) {
+            finishPause();
+            return;
+        }
+
+        const int samples = std::min(audioOutput->currentState().freeSamples, bufferSize);
+        if(samples <= 0) {
+            return;
+        }
+
+        silenceBuffer.resize(static_cast<size_t>(format.bytesForFrames(samples)));
+        silenceBuffer.fillSilence();
+
+        drainFrames += audioOutput->write(silenceBuffer);
+    }
+
+    // Returns how many of @p frames can be read before a crossfade is due, starting it if it is
+    int checkCrossfade(int frames)
+    {
+        if(crossfadeLength <= 0 || markerFrames.empty()) {
+            return frames;
+        }
+
+        const uint64_t marker    = markerFrames.front();
+        const uint64_t remaining = marker - std::min(marker, framesRead);
+        const auto length        = static_cast<uint64_t>(format.framesForDuration(crossfadeLength));
+
+        if(remaining > length) {
+            return static_cast<int>(std::min<uint64_t>(frames, remaining - length));
+        }
+
+        const uint64_t nextEnd   = markerFrames.size() > 1 ? markerFrames.at(1) : framesQueued;
+        const uint64_t available = nextEnd - marker;
+
+        // Wait for enough of the next track to be queued, shortening the crossfade if needed
+        if(remaining > 0 && available >= remaining) {
+            startCrossfade(static_cast<int>(remaining));
+        }
+
+        return frames;
+    }
+
+    void startCrossfade(int frames)
+    {
+        itemsBeforeMarker = 0;
+        const size_t count = bufferQueue.size();
+        while(itemsBeforeMarker < count && bufferQueue.at(itemsBeforeMarker).isValid()) {
+            ++itemsBeforeMarker;
+        }
+
+        nextItem       = 0;
+        nextItemOffset = 0;
+        nextFramesRead = 0;
+        crossfading    = true;
+        crossfade.start(frames);
+
+        // The next track can be heard from here
+        QMetaObject::invokeMethod(self, &AudioRenderer::finished);
+    }
+
+    void readCrossfadeInput(int blockOffset, int frames)
+    {
+        const auto input   = crossfade.input(blockOffset, frames);
+        const int channels = format.channelCount();
+        const int sstride  = format.bytesPerFrame();
+
+        int framesLeft = static_cast<int>(input.size()) / channels;
+        size_t written{0};
+
+        while(framesLeft > 0) {
+            const size_t index = itemsBeforeMarker + 1 + nextItem;
+            if(index >= bufferQueue.size()) {
+                break;
+            }
+
+            const AudioBuffer& next = bufferQueue.at(index);
+            if(!next.isValid()) {
+                break;
+            }
+
+            const int available = (next.byteCount() - nextItemOffset) / sstride;
+            if(available <= 0) {
+                ++nextItem;
+                nextItemOffset = 0;
+                continue;
+            }
+
+            const int count = std::min(available, framesLeft);
+            Audio::convert(format, next.constData().data() + nextItemOffset, floatFormat,
+                           reinterpret_cast<std::byte*>(input.data() + written), count);
+
+            nextItemOffset += count * sstride;
+            nextFramesRead += count;
+            written += static_cast<size_t>(count) * channels;
+            framesLeft -= count;
+        }
+
+        std::fill(input.begin() + static_cast<ptrdiff_t>(written), input.end(), 0.0F);
+
+        if(const float gain = replayGain.nextGain(); gain != 1.0F) {
+            std::ranges::transform(input, input.begin(), [gain](float sample) { return sample * gain; });
+        }
+    }
+
+    void skipCrossfadedInput()
+    {
+        // The start of the next track has already been mixed into the end of the previous
+        for(size_t i{0}; i < nextItem && !bufferQueue.empty(); ++i) {
+            const AudioBuffer& next = bufferQueue.front();
+            queuedDuration -= std::min(queuedDuration, next.duration());
+            emit self->bufferProcessed(next);
+            bufferQueue.dequeue();
+        }
+
+        currentBufferOffset = nextItemOffset;
+        framesRead += nextFramesRead;
+    }
+
     int writeAudioSamples(int samples)
     {
         tempBuffer.clear();
+        crossfade.beginBlock();
 
         int samplesBuffered{0};
 
@@ -121,23 +359,50 @@ struct AudioRenderer::Private
             if(!buffer.isValid()) {
                 // End of file
                 currentBufferOffset = 0;
+                inputFinished       = true;
                 bufferQueue.dequeue();
+                if(!markerFrames.empty()) {
+                    markerFrames.pop_front();
+                }
+
+                if(std::exchange(crossfading, false)) {
+                    skipCrossfadedInput();
+                    replayGain.switchAt(samplesBuffered);
+                    inputFinished = false;
+                    continue;
+                }
+
                 QMetaObject::invokeMethod(self, &AudioRenderer::finished);
-                return samplesBuffered;
+                if(bufferQueue.empty()) {
+                    return samplesBuffered;
+                }
+                // The next track was queued directly after this one
+                replayGain.switchAt(samplesBuffered);
+                inputFinished = false;
+                continue;
             }
 
             const int bytesLeft = buffer.byteCount() - currentBufferOffset;
 
             if(bytesLeft <= 0) {
                 currentBufferOffset = 0;
+                inputFinished       = false;
+                queuedDuration -= std::min(queuedDuration, buffer.duration());
                 emit self->bufferProcessed(buffer);
                 bufferQueue.dequeue();
+                if(crossfading && itemsBeforeMarker > 0) {
+                    --itemsBeforeMarker;
+                }
                 continue;
             }
 
-            const int sampleCount = std::min(bytesLeft / sstride, samples - samplesBuffered);
-            const int bytes       = sampleCount * sstride;
-            const auto fdata      = buffer.constData().subspan(currentBufferOffset, static_cast<size_t>(bytes));
+            int sampleCount = std::min(bytesLeft / sstride, samples - samplesBuffered);
+            if(!crossfading) {
+                sampleCount = checkCrossfade(sampleCount);
+            }
+
+            const int bytes  = sampleCount * sstride;
+            const auto fdata = buffer.constData().subspan(currentBufferOffset, static_cast<size_t>(bytes));
 
             if(!tempBuffer.isValid()) {
                 tempBuffer = {fdata, buffer.format(), buffer.startTime()};
@@ -146,8 +411,14 @@ struct AudioRenderer::Private
                 tempBuffer.append(fdata);
             }
 
+            if(crossfading) {
+                readCrossfadeInput(samplesBuffered, sampleCount);
+            }
+
             samplesBuffered += sampleCount;
             currentBufferOffset += bytes;
+            framesRead += sampleCount;
+            writePosition = buffer.startTime() + format.durationForBytes(currentBufferOffset);
         }
 
         tempBuffer.fillRemainingWithSilence();
@@ -165,6 +436,8 @@ struct AudioRenderer::Private
             return 0;
         }
 
+        dspChain.process(tempBuffer);
+
         if(!audioOutput->canHandleVolume()) {
             tempBuffer.adjustVolumeOfSamples(volume);
         }
@@ -180,9 +453,9 @@ struct AudioRenderer::Private
     }
 };
 
-AudioRenderer::AudioRenderer(QObject* parent)
+AudioRenderer::AudioRenderer(EngineMetrics* metrics, QObject* parent)
     : QObject{parent}
-    , p{std::make_unique<Private>(this)}
+    , p{std::make_unique<Private>(this, metrics)}
 {
     setObjectName(QStringLiteral("Renderer"));
 }
@@ -221,7 +494,9 @@ void AudioRenderer::start()
 void AudioRenderer::stop()
 {
     p->isRunning = false;
+    p->pausing   = false;
     p->writeTimer->stop();
+    p->fade.reset();
 
     p->resetBuffer();
 }
@@ -249,18 +524,47 @@ bool AudioRenderer::isPaused() const
 
 void AudioRenderer::pause(bool paused)
 {
+    if(paused) {
+        if(p->isRunning && p->bufferPrefilled && p->fadeLength > 0 && p->audioOutput
+           && p->audioOutput->initialised()) {
+            if(!std::exchange(p->pausing, true)) {
+                p->drainFrames = 0;
+                p->fade.fadeOut(p->format.framesForDuration(p->fadeLength));
+            }
+            return;
+        }
+
+        p->finishPause();
+        return;
+    }
+
+    p->pausing = false;
+
     if(p->audioOutput && p->audioOutput->initialised()) {
-        p->audioOutput->setPaused(paused);
+        p->audioOutput->setPaused(false);
     }
 
-    p->isRunning = !paused;
+    p->isRunning = true;
+    p->fade.fadeIn(p->format.framesForDuration(p->fadeLength));
 }
 
 void AudioRenderer::queueBuffer(const AudioBuffer& buffer)
 {
+    if(buffer.isValid()) {
+        p->queuedDuration += buffer.duration();
+        p->framesQueued += buffer.frameCount();
+    }
+    else {
+        p->markerFrames.push_back(p->framesQueued);
+    }
     p->bufferQueue.enqueue(buffer);
 }
 
+std::optional<PlaybackPosition> AudioRenderer::playbackPosition() const
+{
+    return p->playbackPosition;
+}
+
 void AudioRenderer::updateOutput(const OutputCreator& output)
 {
     auto newOutput = output();
@@ -295,6 +599,26 @@ void AudioRenderer::updateDevice(const QString& device)
     }
 }
 
+void AudioRenderer::setFadeLength(int ms)
+{
+    p->fadeLength = std::max(ms, 0);
+}
+
+void AudioRenderer::setReplayGain(float gain)
+{
+    p->replayGain.setGain(gain);
+}
+
+void AudioRenderer::setNextReplayGain(float gain)
+{
+    p->replayGain.setNextGain(gain);
+}
+
+void AudioRenderer::setCrossfadeLength(int ms)
+{
+    p->crossfadeLength = std::max(ms, 0);
+}
+
 void AudioRenderer::updateVolume(double volume)
 {
     p->volume = volume;
@@ -19,20 +19,32 @@
 
 #pragma once
 
+#include "fycore_export.h"
+
 #include <core/engine/audiooutput.h>
 
 #include <QObject>
 
+#include <chrono>
+#include <optional>
+
 namespace Fooyin {
 class AudioBuffer;
 class AudioFormat;
+struct EngineMetrics;
+
+struct PlaybackPosition
+{
+    std::chrono::steady_clock::time_point time;
+    uint64_t position{0};
+};
 
-class AudioRenderer : public QObject
+class FYCORE_EXPORT AudioRenderer : public QObject
 {
     Q_OBJECT
 
 public:
-    explicit AudioRenderer(QObject* parent = nullptr);
+    explicit AudioRenderer(EngineMetrics* metrics, QObject* parent = nullptr);
     ~AudioRenderer() override;
 
     bool init(const AudioFormat& format);
@@ -42,18 +54,37 @@ public:
     void reset();
 
     [[nodiscard]] bool isPaused() const;
+    /*!
+     * Pauses or resumes the output.
+     * If a fade length is set, pausing fades out first and completes asynchronously; paused is emitted once done.
+     */
     void pause(bool paused);
 
     void queueBuffer(const AudioBuffer& buffer);
 
+    /** Returns the position last heard from the output and when it was measured, if anything has been written. */
+    [[nodiscard]] std::optional<PlaybackPosition> playbackPosition() const;
+
     void updateOutput(const OutputCreator& output);
     void updateDevice(const QString& device);
     void updateVolume(double volume);
 
+    /** Sets the length of the fades applied when pausing and resuming, in milliseconds. 0 disables fading. */
+    void setFadeLength(int ms);
+    /** Sets the length of the crossfade into a track queued directly after the current one, in milliseconds. */
+    void setCrossfadeLength(int ms);
+
+    /** Sets the linear ReplayGain applied to the current track. */
+    void setReplayGain(float gain);
+    /** Sets the ReplayGain applied once the audio of a track queued after the current one is reached. */
+    void setNextReplayGain(float gain);
+
 signals:
     void outputStateChanged(AudioOutput::State state);
     void bufferProcessed(const AudioBuffer& buffer);
+    /** Emitted when the end of a track is reached, or when a crossfade into the next track starts. */
     void finished();
+    void paused();
 
 private:
     struct Private;
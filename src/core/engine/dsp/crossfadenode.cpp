@@ -0,0 +1,119 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "crossfadenode.h"
+
+#include <core/engine/audioformat.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace Fooyin {
+void CrossfadeNode::start(int frames)
+{
+    m_length   = std::max(frames, 0);
+    m_position = 0;
+}
+
+bool CrossfadeNode::isCrossfading() const
+{
+    return m_position < m_length;
+}
+
+void CrossfadeNode::beginBlock()
+{
+    m_inputStart      = 0;
+    m_inputFrames     = 0;
+    m_processedFrames = 0;
+}
+
+std::span<float> CrossfadeNode::input(int blockOffset, int frames)
+{
+    if(m_inputFrames == 0) {
+        m_inputStart = blockOffset;
+    }
+
+    const int offset = m_inputStart + m_inputFrames;
+    frames           = std::min(frames, m_maxFrames - offset);
+    if(frames <= 0) {
+        return {};
+    }
+    m_inputFrames += frames;
+
+    const auto channels = static_cast<size_t>(m_channels);
+    return std::span{m_input}.subspan(static_cast<size_t>(offset) * channels, static_cast<size_t>(frames) * channels);
+}
+
+void CrossfadeNode::prepare(const AudioFormat& format, int maxFrames)
+{
+    m_channels  = format.channelCount();
+    m_maxFrames = maxFrames;
+    m_input.assign(static_cast<size_t>(maxFrames) * m_channels, 0.0F);
+
+    reset();
+}
+
+bool CrossfadeNode::isActive() const
+{
+    return m_inputFrames > 0;
+}
+
+void CrossfadeNode::process(std::span<float> samples)
+{
+    if(m_channels <= 0) {
+        return;
+    }
+
+    const auto channels = static_cast<size_t>(m_channels);
+    const int frames    = static_cast<int>(samples.size() / channels);
+    const int inputEnd  = m_inputStart + m_inputFrames;
+
+    for(int frame{0}; frame < frames; ++frame) {
+        const int blockFrame = m_processedFrames + frame;
+        if(blockFrame < m_inputStart || blockFrame >= inputEnd) {
+            continue;
+        }
+
+        // Equal power: the outgoing track follows a cosine curve and the incoming a sine curve
+        const float progress = m_length > 0 ? static_cast<float>(m_position) / static_cast<float>(m_length) : 1.0F;
+        const float angle    = std::min(progress, 1.0F) * std::numbers::pi_v<float> / 2;
+        const float outGain  = std::cos(angle);
+        const float inGain   = std::sin(angle);
+
+        const auto sampleIndex = static_cast<size_t>(frame) * channels;
+        const auto inputIndex  = static_cast<size_t>(blockFrame) * channels;
+
+        for(size_t ch{0}; ch < channels; ++ch) {
+            samples[sampleIndex + ch] = (samples[sampleIndex + ch] * outGain) + (m_input[inputIndex + ch] * inGain);
+        }
+
+        ++m_position;
+    }
+
+    m_processedFrames += frames;
+}
+
+void CrossfadeNode::reset()
+{
+    m_length   = 0;
+    m_position = 0;
+    beginBlock();
+}
+} // namespace Fooyin
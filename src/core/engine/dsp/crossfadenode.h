@@ -0,0 +1,65 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fycore_export.h"
+
+#include <core/engine/dspnode.h>
+
+#include <vector>
+
+namespace Fooyin {
+/*!
+ * Mixes the start of the next track into the end of the current one using equal power curves.
+ * The renderer supplies the next track's audio for each block through input.
+ */
+class FYCORE_EXPORT CrossfadeNode : public DspNode
+{
+public:
+    /** Starts a crossfade lasting @p frames. */
+    void start(int frames);
+    [[nodiscard]] bool isCrossfading() const;
+
+    /** Clears the input of the previous block. Must be called before filling the input for a new block. */
+    void beginBlock();
+    /*!
+     * Returns storage for @p frames of the next track, mixed in at @p blockOffset frames into the current block.
+     * Successive calls within a block must be contiguous.
+     */
+    [[nodiscard]] std::span<float> input(int blockOffset, int frames);
+
+    void prepare(const AudioFormat& format, int maxFrames) override;
+    [[nodiscard]] bool isActive() const override;
+    void process(std::span<float> samples) override;
+    void reset() override;
+
+private:
+    int m_channels{0};
+    int m_maxFrames{0};
+    std::vector<float> m_input;
+
+    int m_length{0};
+    int m_position{0};
+
+    int m_inputStart{0};
+    int m_inputFrames{0};
+    int m_processedFrames{0};
+};
+} // namespace Fooyin
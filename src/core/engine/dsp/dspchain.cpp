@@ -0,0 +1,110 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "dspchain.h"
+
+#include <core/engine/audiobuffer.h>
+#include <core/engine/audioconverter.h>
+#include <core/engine/dspnode.h>
+
+#include <QDebug>
+
+#include <algorithm>
+
+namespace Fooyin {
+void DspChain::addNode(DspNode* node)
+{
+    if(!node || std::ranges::find(m_nodes, node) != m_nodes.cend()) {
+        return;
+    }
+
+    m_nodes.push_back(node);
+
+    if(m_format.isValid()) {
+        node->prepare(m_format, m_maxFrames);
+    }
+}
+
+void DspChain::removeNode(DspNode* node)
+{
+    std::erase(m_nodes, node);
+}
+
+void DspChain::prepare(const AudioFormat& format, int maxFrames)
+{
+    m_format      = format;
+    m_floatFormat = {SampleFormat::Float, format.sampleRate(), format.channelCount()};
+    m_maxFrames   = std::max(maxFrames, 1);
+
+    m_samples.assign(static_cast<size_t>(m_maxFrames) * format.channelCount(), 0.0F);
+
+    for(DspNode* node : m_nodes) {
+        node->prepare(m_format, m_maxFrames);
+    }
+}
+
+bool DspChain::isActive() const
+{
+    return std::ranges::any_of(m_nodes, [](const DspNode* node) { return node->isActive(); });
+}
+
+void DspChain::process(AudioBuffer& buffer)
+{
+    if(!buffer.isValid() || buffer.format() != m_format || !isActive()) {
+        return;
+    }
+
+    const int channels    = m_format.channelCount();
+    const int totalFrames = buffer.frameCount();
+    const int frameBytes  = m_format.bytesPerFrame();
+    const bool isFloat    = m_format.sampleFormat() == SampleFormat::Float;
+
+    for(int offset{0}; offset < totalFrames; offset += m_maxFrames) {
+        const int frames = std::min(m_maxFrames, totalFrames - offset);
+        std::byte* data  = buffer.data() + (static_cast<ptrdiff_t>(offset) * frameBytes);
+        const auto count = static_cast<size_t>(frames) * channels;
+
+        float* samples = m_samples.data();
+        if(isFloat) {
+            samples = reinterpret_cast<float*>(data);
+        }
+        else if(!Audio::convert(m_format, data, m_floatFormat, reinterpret_cast<std::byte*>(samples), frames)) {
+            qDebug() << "[DSP] Unable to process unsupported format";
+            return;
+        }
+
+        for(DspNode* node : m_nodes) {
+            if(node->isActive()) {
+                node->process({samples, count});
+            }
+        }
+
+        if(!isFloat) {
+            Audio::convert(m_floatFormat, reinterpret_cast<const std::byte*>(samples), m_format, data, frames);
+        }
+    }
+}
+
+void DspChain::reset()
+{
+    for(DspNode* node : m_nodes) {
+        node->reset();
+    }
+}
+} // namespace Fooyin
@@ -0,0 +1,57 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fycore_export.h"
+
+#include <core/engine/audioformat.h>
+
+#include <vector>
+
+namespace Fooyin {
+class AudioBuffer;
+class DspNode;
+
+/*!
+ * Runs a list of DspNodes over blocks of audio.
+ * Audio is converted to float for the nodes and back again, unless no node is active.
+ * All memory is allocated in prepare, so process is safe to call from the audio path.
+ */
+class FYCORE_EXPORT DspChain
+{
+public:
+    /** Appends @p node to the chain. The node is not owned by the chain. */
+    void addNode(DspNode* node);
+    void removeNode(DspNode* node);
+
+    void prepare(const AudioFormat& format, int maxFrames);
+
+    [[nodiscard]] bool isActive() const;
+    void process(AudioBuffer& buffer);
+    void reset();
+
+private:
+    AudioFormat m_format;
+    AudioFormat m_floatFormat;
+    int m_maxFrames{0};
+    std::vector<float> m_samples;
+    std::vector<DspNode*> m_nodes;
+};
+} // namespace Fooyin
@@ -0,0 +1,101 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "fadenode.h"
+
+#include <core/engine/audioformat.h>
+
+#include <cmath>
+
+namespace Fooyin {
+void FadeNode::fadeOut(int frames)
+{
+    rampTo(0.0F, frames);
+}
+
+void FadeNode::fadeIn(int frames)
+{
+    rampTo(1.0F, frames);
+}
+
+bool FadeNode::isFading() const
+{
+    return m_framesLeft > 0;
+}
+
+bool FadeNode::isSilent() const
+{
+    return !isFading() && m_gain == 0.0F;
+}
+
+void FadeNode::prepare(const AudioFormat& format, int /*maxFrames*/)
+{
+    m_channels = format.channelCount();
+}
+
+bool FadeNode::isActive() const
+{
+    return isFading() || m_gain != 1.0F;
+}
+
+void FadeNode::process(std::span<float> samples)
+{
+    if(m_channels <= 0) {
+        return;
+    }
+
+    const auto channels = static_cast<size_t>(m_channels);
+
+    for(size_t i{0}; i + channels <= samples.size(); i += channels) {
+        if(m_framesLeft > 0) {
+            m_gain = --m_framesLeft > 0 ? m_gain + m_step : m_target;
+        }
+
+        for(size_t ch{0}; ch < channels; ++ch) {
+            samples[i + ch] *= m_gain;
+        }
+    }
+}
+
+void FadeNode::reset()
+{
+    m_gain       = 1.0F;
+    m_target     = 1.0F;
+    m_step       = 0.0F;
+    m_framesLeft = 0;
+}
+
+void FadeNode::rampTo(float target, int frames)
+{
+    m_target = target;
+
+    // A partial fade takes proportionally less time, so reversing a fade midway sounds symmetrical
+    const auto scaledFrames = static_cast<int>(std::lround(std::abs(target - m_gain) * static_cast<float>(frames)));
+
+    if(scaledFrames <= 0) {
+        m_gain       = target;
+        m_step       = 0.0F;
+        m_framesLeft = 0;
+        return;
+    }
+
+    m_step       = (target - m_gain) / static_cast<float>(scaledFrames);
+    m_framesLeft = scaledFrames;
+}
+} // namespace Fooyin
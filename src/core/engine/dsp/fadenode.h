@@ -0,0 +1,58 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fycore_export.h"
+
+#include <core/engine/dspnode.h>
+
+namespace Fooyin {
+/*!
+ * Applies a linear gain ramp, used to avoid clicks when audio starts or stops abruptly.
+ * Once faded out, the gain is held at zero until faded back in or reset.
+ */
+class FYCORE_EXPORT FadeNode : public DspNode
+{
+public:
+    /** Ramps the gain to 0 over @p frames, scaled by the current gain. */
+    void fadeOut(int frames);
+    /** Ramps the gain to 1 over @p frames, scaled by the current gain. */
+    void fadeIn(int frames);
+
+    /** Returns @c true if the gain is ramping. */
+    [[nodiscard]] bool isFading() const;
+    /** Returns @c true if faded out completely. */
+    [[nodiscard]] bool isSilent() const;
+
+    void prepare(const AudioFormat& format, int maxFrames) override;
+    [[nodiscard]] bool isActive() const override;
+    void process(std::span<float> samples) override;
+    void reset() override;
+
+private:
+    void rampTo(float target, int frames);
+
+    int m_channels{0};
+    float m_gain{1.0F};
+    float m_target{1.0F};
+    float m_step{0.0F};
+    int m_framesLeft{0};
+};
+} // namespace Fooyin
@@ -0,0 +1,96 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "gainnode.h"
+
+#include <core/engine/audioformat.h>
+
+#include <algorithm>
+
+namespace Fooyin {
+void GainNode::setGain(float gain)
+{
+    m_gain        = gain;
+    m_nextGain    = gain;
+    m_switchFrame = -1;
+}
+
+void GainNode::setNextGain(float gain)
+{
+    m_nextGain = gain;
+}
+
+float GainNode::nextGain() const
+{
+    return m_nextGain;
+}
+
+void GainNode::switchAt(int blockOffset)
+{
+    m_switchFrame = std::max(blockOffset, 0);
+}
+
+void GainNode::prepare(const AudioFormat& format, int /*maxFrames*/)
+{
+    m_channels = format.channelCount();
+    reset();
+}
+
+bool GainNode::isActive() const
+{
+    return m_gain != 1.0F || m_switchFrame >= 0;
+}
+
+void GainNode::process(std::span<float> samples)
+{
+    if(m_channels <= 0) {
+        return;
+    }
+
+    const auto scale = [](std::span<float> range, float gain) {
+        if(gain != 1.0F) {
+            std::ranges::transform(range, range.begin(), [gain](float sample) { return sample * gain; });
+        }
+    };
+
+    const auto channels = static_cast<size_t>(m_channels);
+    const auto frames   = static_cast<int>(samples.size() / channels);
+
+    if(m_switchFrame < 0 || m_switchFrame >= frames) {
+        scale(samples, m_gain);
+        if(m_switchFrame >= 0) {
+            // Blocks may be processed in several parts
+            m_switchFrame -= frames;
+        }
+        return;
+    }
+
+    const size_t split = static_cast<size_t>(m_switchFrame) * channels;
+    scale(samples.first(split), m_gain);
+
+    m_gain        = m_nextGain;
+    m_switchFrame = -1;
+    scale(samples.subspan(split), m_gain);
+}
+
+void GainNode::reset()
+{
+    m_switchFrame = -1;
+}
+} // namespace Fooyin
@@ -0,0 +1,54 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fycore_export.h"
+
+#include <core/engine/dspnode.h>
+
+namespace Fooyin {
+/*!
+ * Applies a constant gain, such as ReplayGain.
+ * The gain of a track queued after the current one is held until its first frame is reached.
+ */
+class FYCORE_EXPORT GainNode : public DspNode
+{
+public:
+    /** Sets the gain used from now on, replacing any pending gain. */
+    void setGain(float gain);
+    /** Sets the gain to switch to at the next switch point. */
+    void setNextGain(float gain);
+    [[nodiscard]] float nextGain() const;
+
+    /** Switches to the next gain @p blockOffset frames into the next block processed. */
+    void switchAt(int blockOffset);
+
+    void prepare(const AudioFormat& format, int maxFrames) override;
+    [[nodiscard]] bool isActive() const override;
+    void process(std::span<float> samples) override;
+    void reset() override;
+
+private:
+    int m_channels{0};
+    float m_gain{1.0F};
+    float m_nextGain{1.0F};
+    int m_switchFrame{-1};
+};
+} // namespace Fooyin
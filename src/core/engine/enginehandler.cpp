@@ -21,16 +21,20 @@
 
 #include "audioplaybackengine.h"
 #include "engine/ffmpeg/ffmpegdecoder.h"
+#include "internalcoresettings.h"
 
 #include <core/coresettings.h>
 #include <core/engine/audioengine.h>
+#include <core/engine/enginemetrics.h>
 #include <core/engine/outputplugin.h>
 #include <core/track.h>
 
 #include <core/player/playercontroller.h>
 #include <utils/settings/settingsmanager.h>
 
+#include <QJsonDocument>
 #include <QThread>
+#include <QTimer>
 
 namespace Fooyin {
 struct CurrentOutput
@@ -46,17 +50,23 @@ struct EngineHandler::Private
     PlayerController* playerController;
     SettingsManager* settings;
 
+    EngineMetrics metrics;
+    QTimer* metricsLogTimer;
+
     QThread engineThread;
     AudioEngine* engine;
 
     std::map<QString, OutputCreator> outputs;
     CurrentOutput currentOutput;
 
+    int pcmTapCount{0};
+
     Private(EngineHandler* self_, PlayerController* playerController_, SettingsManager* settings_)
         : self{self_}
         , playerController{playerController_}
         , settings{settings_}
-        , engine{new AudioPlaybackEngine(settings)}
+        , metricsLogTimer{new QTimer(self)}
+        , engine{new AudioPlaybackEngine(settings, &metrics)}
     {
         engine->moveToThread(&engineThread);
         engineThread.start();
@@ -71,8 +81,15 @@ struct EngineHandler::Private
                          [this](PlaybackState state) { handleStateChange(state); });
         QObject::connect(engine, &AudioEngine::trackStatusChanged, self,
                          [this](TrackStatus status) { handleTrackStatus(status); });
+        QObject::connect(engine, &AudioEngine::pcmDecoded, self, &EngineController::pcmDecoded,
+                         Qt::DirectConnection);
+        QObject::connect(engine, &AudioEngine::pcmTapInterrupted, self, &EngineController::pcmTapInterrupted,
+                         Qt::DirectConnection);
+
+        QObject::connect(metricsLogTimer, &QTimer::timeout, self, [this]() { logMetrics(); });
 
         updateVolume(settings->value<Settings::Core::OutputVolume>());
+        updateMetricsLogging(settings->value<Settings::Core::Internal::EngineMetricsLogging>());
     }
 
     void handleStateChange(PlaybackState state) const
@@ -170,11 +187,33 @@ struct EngineHandler::Private
         }
     }
 
+    void setPcmTapEnabled(bool enabled)
+    {
+        QMetaObject::invokeMethod(
+            engine, [this, enabled]() { engine->setPcmTapEnabled(enabled); }, Qt::QueuedConnection);
+    }
+
     void updateVolume(double volume)
     {
         QMetaObject::invokeMethod(
             engine, [this, volume]() { engine->setVolume(volume); }, Qt::QueuedConnection);
     }
+
+    void updateMetricsLogging(int interval) const
+    {
+        if(interval > 0) {
+            metricsLogTimer->start(interval * 1000);
+        }
+        else {
+            metricsLogTimer->stop();
+        }
+    }
+
+    void logMetrics() const
+    {
+        const QJsonDocument json{metrics.snapshot().toJson()};
+        qInfo().noquote() << "[Engine] Metrics:" << QString::fromUtf8(json.toJson(QJsonDocument::Compact));
+    }
 };
 
 EngineHandler::EngineHandler(PlayerController* playerController, SettingsManager* settings, QObject* parent)
@@ -195,6 +234,8 @@ EngineHandler::EngineHandler(PlayerController* playerController, SettingsManager
     p->settings->subscribe<Settings::Core::AudioOutput>(this,
                                                         [this](const QString& output) { p->changeOutput(output); });
     p->settings->subscribe<Settings::Core::OutputVolume>(this, [this](double volume) { p->updateVolume(volume); });
+    p->settings->subscribe<Settings::Core::Internal::EngineMetricsLogging>(
+        this, [this](int interval) { p->updateMetricsLogging(interval); });
 }
 
 EngineHandler::~EngineHandler()
@@ -246,6 +287,36 @@ std::unique_ptr<AudioDecoder> EngineHandler::createDecoder()
 {
     return std::make_unique<FFmpegDecoder>();
 }
+
+void EngineHandler::prepareNextTrack(const Track& track)
+{
+    QMetaObject::invokeMethod(
+        p->engine, [this, track]() { p->engine->prepareNextTrack(track); }, Qt::QueuedConnection);
+}
+
+void EngineHandler::registerPcmTap()
+{
+    if(p->pcmTapCount++ == 0) {
+        p->setPcmTapEnabled(true);
+    }
+}
+
+void EngineHandler::unregisterPcmTap()
+{
+    if(p->pcmTapCount > 0 && --p->pcmTapCount == 0) {
+        p->setPcmTapEnabled(false);
+    }
+}
+
+const EngineMetrics& EngineHandler::metrics() const
+{
+    return p->metrics;
+}
+
+void EngineHandler::resetMetrics()
+{
+    p->metrics.reset();
+}
 } // namespace Fooyin
 
 #include "moc_enginehandler.cpp"
@@ -46,6 +46,14 @@ public:
 
     std::unique_ptr<AudioDecoder> createDecoder() override;
 
+    void prepareNextTrack(const Track& track) override;
+
+    void registerPcmTap() override;
+    void unregisterPcmTap() override;
+
+    [[nodiscard]] const EngineMetrics& metrics() const override;
+    void resetMetrics() override;
+
 private:
     struct Private;
     std::unique_ptr<Private> p;
@@ -0,0 +1,206 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <core/engine/enginemetrics.h>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace {
+size_t bucketForValue(uint64_t value)
+{
+    return std::min<size_t>(std::bit_width(value), Fooyin::MetricHistogram::BucketCount - 1);
+}
+
+uint64_t bucketUpperBound(size_t bucket)
+{
+    return bucket == 0 ? 0 : (uint64_t{1} << bucket) - 1;
+}
+} // namespace
+
+namespace Fooyin {
+double MetricHistogram::Snapshot::mean() const
+{
+    return count > 0 ? static_cast<double>(sum) / static_cast<double>(count) : 0.0;
+}
+
+uint64_t MetricHistogram::Snapshot::percentile(double percentile) const
+{
+    if(count == 0) {
+        return 0;
+    }
+
+    const auto target = static_cast<uint64_t>(std::ceil(static_cast<double>(count) * percentile / 100.0));
+
+    uint64_t seen{0};
+    for(size_t i{0}; i < BucketCount; ++i) {
+        seen += buckets.at(i);
+        if(seen >= std::max<uint64_t>(target, 1)) {
+            return std::min(bucketUpperBound(i), max);
+        }
+    }
+
+    return max;
+}
+
+QJsonObject MetricHistogram::Snapshot::toJson() const
+{
+    QJsonObject json;
+
+    json[QStringLiteral("count")] = static_cast<qint64>(count);
+    json[QStringLiteral("mean")]  = mean();
+    json[QStringLiteral("p50")]   = static_cast<qint64>(percentile(50));
+    json[QStringLiteral("p95")]   = static_cast<qint64>(percentile(95));
+    json[QStringLiteral("p99")]   = static_cast<qint64>(percentile(99));
+    json[QStringLiteral("max")]   = static_cast<qint64>(max);
+
+    return json;
+}
+
+void MetricHistogram::record(uint64_t value)
+{
+    m_buckets.at(bucketForValue(value)).fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(value, std::memory_order_relaxed);
+
+    uint64_t max = m_max.load(std::memory_order_relaxed);
+    while(value > max && !m_max.compare_exchange_weak(max, value, std::memory_order_relaxed)) { }
+}
+
+void MetricHistogram::reset()
+{
+    for(auto& bucket : m_buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    m_count.store(0, std::memory_order_relaxed);
+    m_sum.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+MetricHistogram::Snapshot MetricHistogram::snapshot() const
+{
+    Snapshot snapshot;
+
+    for(size_t i{0}; i < BucketCount; ++i) {
+        snapshot.buckets.at(i) = m_buckets.at(i).load(std::memory_order_relaxed);
+        snapshot.count += snapshot.buckets.at(i);
+    }
+    snapshot.sum = m_sum.load(std::memory_order_relaxed);
+    snapshot.max = m_max.load(std::memory_order_relaxed);
+
+    return snapshot;
+}
+
+QJsonObject EngineMetrics::Snapshot::toJson() const
+{
+    QJsonObject json;
+
+    json[QStringLiteral("decodeTimeUs")]  = decodeTime.toJson();
+    json[QStringLiteral("queueDepthMs")]  = queueDepth.toJson();
+    json[QStringLiteral("outputDelayUs")] = outputDelay.toJson();
+    json[QStringLiteral("clockDriftMs")]  = clockDrift.toJson();
+    json[QStringLiteral("trackOpenUs")]   = trackOpenTime.toJson();
+
+    json[QStringLiteral("buffersDecoded")]     = static_cast<qint64>(buffersDecoded);
+    json[QStringLiteral("outputFull")]         = static_cast<qint64>(outputFull);
+    json[QStringLiteral("queueUnderruns")]     = static_cast<qint64>(queueUnderruns);
+    json[QStringLiteral("outputUnderruns")]    = static_cast<qint64>(outputUnderruns);
+    json[QStringLiteral("preopenedTracks")]    = static_cast<qint64>(preopenedTracks);
+    json[QStringLiteral("gaplessTransitions")] = static_cast<qint64>(gaplessTransitions);
+
+    json[QStringLiteral("currentQueueDepthMs")]  = static_cast<qint64>(currentQueueDepth);
+    json[QStringLiteral("currentOutputDelayUs")] = static_cast<qint64>(currentOutputDelay);
+    json[QStringLiteral("currentClockDriftMs")]  = static_cast<qint64>(currentClockDrift);
+
+    return json;
+}
+
+void EngineMetrics::recordDecode(std::chrono::nanoseconds time)
+{
+    decodeTime.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(time).count()));
+    buffersDecoded.fetch_add(1, std::memory_order_relaxed);
+}
+
+void EngineMetrics::recordQueueDepth(uint64_t ms)
+{
+    queueDepth.record(ms);
+    currentQueueDepth.store(ms, std::memory_order_relaxed);
+}
+
+void EngineMetrics::recordOutputDelay(double seconds)
+{
+    const auto delay = static_cast<uint64_t>(std::max(seconds, 0.0) * 1000000);
+    outputDelay.record(delay);
+    currentOutputDelay.store(delay, std::memory_order_relaxed);
+}
+
+void EngineMetrics::recordClockDrift(int64_t drift)
+{
+    clockDrift.record(static_cast<uint64_t>(std::abs(drift)));
+    currentClockDrift.store(drift, std::memory_order_relaxed);
+}
+
+void EngineMetrics::recordTrackOpen(std::chrono::nanoseconds time)
+{
+    trackOpenTime.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(time).count()));
+}
+
+void EngineMetrics::reset()
+{
+    decodeTime.reset();
+    queueDepth.reset();
+    outputDelay.reset();
+    clockDrift.reset();
+    trackOpenTime.reset();
+
+    buffersDecoded.store(0, std::memory_order_relaxed);
+    outputFull.store(0, std::memory_order_relaxed);
+    queueUnderruns.store(0, std::memory_order_relaxed);
+    outputUnderruns.store(0, std::memory_order_relaxed);
+    preopenedTracks.store(0, std::memory_order_relaxed);
+    gaplessTransitions.store(0, std::memory_order_relaxed);
+    currentQueueDepth.store(0, std::memory_order_relaxed);
+    currentOutputDelay.store(0, std::memory_order_relaxed);
+    currentClockDrift.store(0, std::memory_order_relaxed);
+}
+
+EngineMetrics::Snapshot EngineMetrics::snapshot() const
+{
+    Snapshot snapshot;
+
+    snapshot.decodeTime    = decodeTime.snapshot();
+    snapshot.queueDepth    = queueDepth.snapshot();
+    snapshot.outputDelay   = outputDelay.snapshot();
+    snapshot.clockDrift    = clockDrift.snapshot();
+    snapshot.trackOpenTime = trackOpenTime.snapshot();
+
+    snapshot.buffersDecoded     = buffersDecoded.load(std::memory_order_relaxed);
+    snapshot.outputFull         = outputFull.load(std::memory_order_relaxed);
+    snapshot.queueUnderruns     = queueUnderruns.load(std::memory_order_relaxed);
+    snapshot.outputUnderruns    = outputUnderruns.load(std::memory_order_relaxed);
+    snapshot.preopenedTracks    = preopenedTracks.load(std::memory_order_relaxed);
+    snapshot.gaplessTransitions = gaplessTransitions.load(std::memory_order_relaxed);
+    snapshot.currentQueueDepth  = currentQueueDepth.load(std::memory_order_relaxed);
+    snapshot.currentOutputDelay = currentOutputDelay.load(std::memory_order_relaxed);
+    snapshot.currentClockDrift  = currentClockDrift.load(std::memory_order_relaxed);
+
+    return snapshot;
+}
+} // namespace Fooyin
@@ -96,6 +96,10 @@ struct FFmpegDecoder::Private
     bool draining{false};
     bool isDecoding{false};
 
+    // Reused for every packet and frame, so decoding doesn't allocate per packet
+    Packet packet;
+    Frame frame;
+
     AudioBuffer buffer;
     int bufferPos{0};
     uint64_t currentPts{0};
@@ -103,6 +107,7 @@ struct FFmpegDecoder::Private
     explicit Private(FFmpegDecoder* self_)
         : self{self_}
         , timeBase{0, 0}
+        , packet{PacketPtr{av_packet_alloc()}}
     { }
 
     bool setup(const QString& source)
@@ -125,6 +130,7 @@ struct FFmpegDecoder::Private
         }
 
         audioFormat = Utils::audioFormatFromCodec(stream.avStream()->codecpar);
+        frame       = Frame{FramePtr{av_frame_alloc()}, timeBase};
 
         return createCodec(stream.avStream());
     }
@@ -221,17 +227,17 @@ struct FFmpegDecoder::Private
         return true;
     }
 
-    void decodeAudio(const Packet& packet)
+    void decodeAudio()
     {
         if(!isDecoding) {
             return;
         }
 
-        int result = sendAVPacket(packet);
+        int result = sendAVPacket();
 
         if(result == AVERROR(EAGAIN)) {
             receiveAVFrames();
-            result = sendAVPacket(packet);
+            result = sendAVPacket();
 
             if(result != AVERROR(EAGAIN)) {
                 qWarning() << "Unexpected decoder behavior";
@@ -248,7 +254,7 @@ struct FFmpegDecoder::Private
         return error != Error::NoError;
     }
 
-    [[nodiscard]] int sendAVPacket(const Packet& packet) const
+    [[nodiscard]] int sendAVPacket() const
     {
         if(hasError() || !isDecoding) {
             return -1;
@@ -263,8 +269,7 @@ struct FFmpegDecoder::Private
             return;
         }
 
-        auto avFrame     = FramePtr(av_frame_alloc());
-        const int result = avcodec_receive_frame(codec.context(), avFrame.get());
+        const int result = avcodec_receive_frame(codec.context(), frame.avFrame());
 
         if(result == AVERROR_EOF) {
             return;
@@ -280,8 +285,6 @@ struct FFmpegDecoder::Private
             return;
         }
 
-        const Frame frame{std::move(avFrame), timeBase};
-
         currentPts = frame.ptsMs();
 
         const auto sampleCount = audioFormat.bytesPerFrame() * frame.sampleCount();
@@ -294,6 +297,9 @@ struct FFmpegDecoder::Private
         else {
             buffer = {frame.avFrame()->data[0], static_cast<size_t>(sampleCount), audioFormat, frame.ptsMs()};
         }
+
+        // Hand the decoder's buffers back to its pool
+        av_frame_unref(frame.avFrame());
     }
 
     void readNext()
@@ -302,7 +308,9 @@ struct FFmpegDecoder::Private
             return;
         }
 
-        const Packet packet(PacketPtr{av_packet_alloc()});
+        // The previous packet has already been sent to the decoder, which keeps its own reference
+        av_packet_unref(packet.avPacket());
+
         const int readResult = av_read_frame(context.get(), packet.avPacket());
         if(readResult < 0) {
             if(readResult != AVERROR_EOF) {
@@ -310,7 +318,7 @@ struct FFmpegDecoder::Private
             }
             else if(!draining) {
                 draining = true;
-                decodeAudio(packet);
+                decodeAudio();
                 return;
             }
             return;
@@ -321,7 +329,7 @@ struct FFmpegDecoder::Private
             return;
         }
 
-        decodeAudio(packet);
+        decodeAudio();
     }
 
     void seek(uint64_t pos) const
@@ -414,6 +422,7 @@ AudioBuffer FFmpegDecoder::readBuffer(size_t bytes)
     while(p->buffer.isValid() && bytesWritten < bytesRequested) {
         if(!buffer.isValid()) {
             buffer = {p->buffer.format(), p->buffer.startTime()};
+            buffer.reserve(bytes);
         }
         const int remaining = bytesRequested - bytesWritten;
         const int count     = p->buffer.byteCount() - p->bufferPos;
@@ -19,13 +19,15 @@
 
 #pragma once
 
+#include "fycore_export.h"
+
 #include <core/engine/audiodecoder.h>
 
 namespace Fooyin {
 class AudioFormat;
 class AudioBuffer;
 
-class FFmpegDecoder : public AudioDecoder
+class FYCORE_EXPORT FFmpegDecoder : public AudioDecoder
 {
 public:
     FFmpegDecoder();
@@ -0,0 +1,176 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "loudnessmeter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <numeric>
+
+namespace {
+// Blocks quieter than this are always ignored
+constexpr double AbsoluteGate = -70.0;
+// Blocks this far below the loudness of the ungated blocks are ignored
+constexpr double RelativeGate = -10.0;
+// Offset so a 997Hz sine at 0dBFS on a single channel measures -3.01 LUFS
+constexpr double LoudnessOffset = -0.691;
+
+double toLoudness(double energy)
+{
+    return LoudnessOffset + (10 * std::log10(energy));
+}
+
+double toEnergy(double loudness)
+{
+    return std::pow(10.0, (loudness - LoudnessOffset) / 10);
+}
+
+double meanAbove(const std::vector<double>& blocks, double threshold, int& count)
+{
+    double sum{0.0};
+    count = 0;
+    for(const double block : blocks) {
+        if(block > threshold) {
+            sum += block;
+            ++count;
+        }
+    }
+    return count > 0 ? sum / count : 0.0;
+}
+} // namespace
+
+namespace Fooyin {
+LoudnessMeter::LoudnessMeter(int sampleRate, int channels)
+    : m_channels{std::max(channels, 1)}
+    , m_state(static_cast<size_t>(m_channels))
+    , m_weights(static_cast<size_t>(m_channels), 1.0)
+    , m_stepFrames{std::max(sampleRate / 10, 1)}
+{
+    const auto rate = static_cast<double>(std::max(sampleRate, 1));
+
+    // Stage 1: high shelf modelling the acoustic effect of the head
+    {
+        const double f0 = 1681.974450955533;
+        const double q  = 0.7071752369554196;
+        const double vh = std::pow(10.0, 3.999843853973347 / 20);
+        const double vb = std::pow(vh, 0.4996667741545416);
+        const double k  = std::tan(std::numbers::pi * f0 / rate);
+        const double a0 = 1.0 + (k / q) + (k * k);
+
+        m_shelf.b0 = (vh + (vb * k / q) + (k * k)) / a0;
+        m_shelf.b1 = 2.0 * ((k * k) - vh) / a0;
+        m_shelf.b2 = (vh - (vb * k / q) + (k * k)) / a0;
+        m_shelf.a1 = 2.0 * ((k * k) - 1.0) / a0;
+        m_shelf.a2 = (1.0 - (k / q) + (k * k)) / a0;
+    }
+
+    // Stage 2: RLB high pass
+    {
+        const double f0 = 38.13547087602444;
+        const double q  = 0.5003270373238773;
+        const double k  = std::tan(std::numbers::pi * f0 / rate);
+        const double a0 = 1.0 + (k / q) + (k * k);
+
+        m_highPass.b0 = 1.0;
+        m_highPass.b1 = -2.0;
+        m_highPass.b2 = 1.0;
+        m_highPass.a1 = 2.0 * ((k * k) - 1.0) / a0;
+        m_highPass.a2 = (1.0 - (k / q) + (k * k)) / a0;
+    }
+
+    if(m_channels == 6) {
+        // 5.1: the LFE channel is ignored and the surround channels are weighted higher
+        m_weights = {1.0, 1.0, 1.0, 0.0, 1.41, 1.41};
+    }
+}
+
+void LoudnessMeter::process(const float* samples, int frames)
+{
+    const auto channels = static_cast<size_t>(m_channels);
+
+    for(int frame{0}; frame < frames; ++frame) {
+        const float* in = samples + (static_cast<size_t>(frame) * channels);
+
+        for(size_t ch{0}; ch < channels; ++ch) {
+            const double x = in[ch];
+            m_peak         = std::max(m_peak, std::abs(in[ch]));
+
+            // Transposed direct form II for both stages
+            auto& s        = m_state[ch];
+            const double y = (m_shelf.b0 * x) + s[0];
+            s[0]           = (m_shelf.b1 * x) - (m_shelf.a1 * y) + s[1];
+            s[1]           = (m_shelf.b2 * x) - (m_shelf.a2 * y);
+
+            const double z = (m_highPass.b0 * y) + s[2];
+            s[2]           = (m_highPass.b1 * y) - (m_highPass.a1 * z) + s[3];
+            s[3]           = (m_highPass.b2 * y) - (m_highPass.a2 * z);
+
+            m_stepEnergy += m_weights[ch] * z * z;
+        }
+
+        if(++m_stepPosition < m_stepFrames) {
+            continue;
+        }
+
+        // Each block is four 100ms steps, so a new block completes every step
+        m_steps[static_cast<size_t>(m_stepCount % 4)] = m_stepEnergy;
+        if(++m_stepCount >= 4) {
+            const double sum = std::accumulate(m_steps.cbegin(), m_steps.cend(), 0.0);
+            m_blocks.push_back(sum / (4.0 * m_stepFrames));
+        }
+
+        m_stepPosition = 0;
+        m_stepEnergy   = 0.0;
+    }
+}
+
+std::optional<double> LoudnessMeter::integratedLoudness() const
+{
+    return integratedLoudness(m_blocks);
+}
+
+float LoudnessMeter::peak() const
+{
+    return m_peak;
+}
+
+const std::vector<double>& LoudnessMeter::blocks() const
+{
+    return m_blocks;
+}
+
+std::optional<double> LoudnessMeter::integratedLoudness(const std::vector<double>& blocks)
+{
+    int count{0};
+    const double absoluteThreshold = toEnergy(AbsoluteGate);
+    const double ungated           = meanAbove(blocks, absoluteThreshold, count);
+    if(count == 0) {
+        return {};
+    }
+
+    const double relativeThreshold = std::max(absoluteThreshold, toEnergy(toLoudness(ungated) + RelativeGate));
+    const double gated             = meanAbove(blocks, relativeThreshold, count);
+    if(count == 0) {
+        return {};
+    }
+
+    return toLoudness(gated);
+}
+} // namespace Fooyin
@@ -0,0 +1,76 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fycore_export.h"
+
+#include <array>
+#include <optional>
+#include <vector>
+
+namespace Fooyin {
+/*!
+ * Measures loudness as defined by ITU-R BS.1770 / EBU R128.
+ * Samples are K-weighted and summed into 400ms gating blocks overlapping by 75%.
+ */
+class FYCORE_EXPORT LoudnessMeter
+{
+public:
+    LoudnessMeter(int sampleRate, int channels);
+
+    /** Adds @p frames of interleaved float samples. */
+    void process(const float* samples, int frames);
+
+    /** Returns the gated loudness in LUFS, or nothing if no block was loud enough to measure. */
+    [[nodiscard]] std::optional<double> integratedLoudness() const;
+    /** Returns the highest absolute sample value. */
+    [[nodiscard]] float peak() const;
+
+    /** Returns the mean square energy of each gating block, so blocks from several tracks can be combined. */
+    [[nodiscard]] const std::vector<double>& blocks() const;
+    /** Returns the gated loudness of @p blocks in LUFS. */
+    static std::optional<double> integratedLoudness(const std::vector<double>& blocks);
+
+private:
+    struct Biquad
+    {
+        double b0{1.0};
+        double b1{0.0};
+        double b2{0.0};
+        double a1{0.0};
+        double a2{0.0};
+    };
+
+    int m_channels;
+    Biquad m_shelf;
+    Biquad m_highPass;
+    std::vector<std::array<double, 4>> m_state;
+    std::vector<double> m_weights;
+
+    int m_stepFrames;
+    int m_stepPosition{0};
+    double m_stepEnergy{0.0};
+    std::array<double, 4> m_steps{};
+    int m_stepCount{0};
+
+    std::vector<double> m_blocks;
+    float m_peak{0.0F};
+};
+} // namespace Fooyin
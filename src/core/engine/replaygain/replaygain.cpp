@@ -0,0 +1,76 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <core/engine/replaygain.h>
+
+#include <core/track.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+std::optional<double> tagValue(const Fooyin::Track& track, const char* tag)
+{
+    const QStringList values = track.extraTag(QString::fromLatin1(tag));
+    if(values.empty()) {
+        return {};
+    }
+
+    // Gains are stored as e.g. "-6.54 dB"
+    QString value = values.front().trimmed();
+    if(value.endsWith(QStringLiteral("dB"), Qt::CaseInsensitive)) {
+        value.chop(2);
+    }
+
+    bool ok{false};
+    const double number = value.trimmed().toDouble(&ok);
+    if(!ok) {
+        return {};
+    }
+    return number;
+}
+} // namespace
+
+namespace Fooyin::ReplayGain {
+float playbackGain(const Track& track, Mode mode, double preampDb, bool preventClipping)
+{
+    if(mode == Mode::None) {
+        return 1.0F;
+    }
+
+    const bool album = mode == Mode::Album;
+
+    auto gain = tagValue(track, album ? AlbumGainTag : TrackGainTag);
+    auto peak = tagValue(track, album ? AlbumPeakTag : TrackPeakTag);
+    if(!gain) {
+        gain = tagValue(track, album ? TrackGainTag : AlbumGainTag);
+        peak = tagValue(track, album ? TrackPeakTag : AlbumPeakTag);
+    }
+    if(!gain) {
+        return 1.0F;
+    }
+
+    double scale = std::pow(10.0, (*gain + preampDb) / 20);
+    if(preventClipping && peak && *peak > 0.0) {
+        scale = std::min(scale, 1.0 / *peak);
+    }
+
+    return static_cast<float>(scale);
+}
+} // namespace Fooyin::ReplayGain
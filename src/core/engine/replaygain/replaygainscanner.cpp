@@ -0,0 +1,240 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <core/engine/replaygainscanner.h>
+
+#include "engine/ffmpeg/ffmpegdecoder.h"
+#include "loudnessmeter.h"
+
+#include <core/engine/audioconverter.h>
+#include <core/engine/replaygain.h>
+#include <core/track.h>
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFutureWatcher>
+#include <QThreadPool>
+#include <QtConcurrentMap>
+
+#include <atomic>
+#include <map>
+
+namespace {
+struct TrackAnalysis
+{
+    std::optional<double> loudness;
+    float peak{0.0F};
+    std::vector<double> blocks;
+};
+
+TrackAnalysis analyseTrack(const Fooyin::Track& track, const std::atomic<bool>& cancelled)
+{
+    using namespace Fooyin;
+
+    FFmpegDecoder decoder;
+    if(!decoder.init(track.filepath())) {
+        qDebug() << "[ReplayGain] Unable to open" << track.filepath();
+        return {};
+    }
+    decoder.start();
+
+    const AudioFormat format = decoder.format();
+    const AudioFormat floatFormat{SampleFormat::Float, format.sampleRate(), format.channelCount()};
+
+    LoudnessMeter meter{format.sampleRate(), format.channelCount()};
+    std::vector<float> samples;
+
+    while(!cancelled.load(std::memory_order_relaxed)) {
+        const AudioBuffer buffer = decoder.readBuffer();
+        if(!buffer.isValid()) {
+            break;
+        }
+
+        const int frames = buffer.frameCount();
+        const auto* data = buffer.constData().data();
+
+        if(buffer.format().sampleFormat() == SampleFormat::Float) {
+            meter.process(reinterpret_cast<const float*>(data), frames);
+            continue;
+        }
+
+        samples.resize(static_cast<size_t>(frames) * format.channelCount());
+        if(Audio::convert(buffer.format(), data, floatFormat, reinterpret_cast<std::byte*>(samples.data()), frames)) {
+            meter.process(samples.data(), frames);
+        }
+    }
+
+    decoder.stop();
+
+    if(cancelled.load(std::memory_order_relaxed)) {
+        return {};
+    }
+
+    return {meter.integratedLoudness(), meter.peak(), meter.blocks()};
+}
+
+void setTags(Fooyin::Track& track, const char* gainTag, const char* peakTag, double loudness, float peak)
+{
+    const double gain = Fooyin::ReplayGain::ReferenceLoudness - loudness;
+    track.replaceExtraTag(QString::fromLatin1(gainTag), QStringLiteral("%1 dB").arg(gain, 0, 'f', 2));
+    track.replaceExtraTag(QString::fromLatin1(peakTag), QString::number(peak, 'f', 6));
+}
+
+Fooyin::TrackList applyResults(const Fooyin::TrackList& tracks, const std::vector<TrackAnalysis>& results)
+{
+    using namespace Fooyin;
+
+    struct Album
+    {
+        std::vector<double> blocks;
+        float peak{0.0F};
+        std::optional<double> loudness;
+    };
+
+    std::map<QString, Album> albums;
+
+    for(size_t i{0}; i < tracks.size() && i < results.size(); ++i) {
+        const auto& result = results.at(i);
+        if(!result.loudness || tracks.at(i).album().isEmpty()) {
+            continue;
+        }
+
+        auto& album = albums[tracks.at(i).albumHash()];
+        album.blocks.insert(album.blocks.end(), result.blocks.cbegin(), result.blocks.cend());
+        album.peak = std::max(album.peak, result.peak);
+    }
+
+    for(auto& [_, album] : albums) {
+        album.loudness = LoudnessMeter::integratedLoudness(album.blocks);
+    }
+
+    TrackList scanned;
+
+    for(size_t i{0}; i < tracks.size() && i < results.size(); ++i) {
+        const auto& result = results.at(i);
+        if(!result.loudness) {
+            continue;
+        }
+
+        Track track{tracks.at(i)};
+        setTags(track, ReplayGain::TrackGainTag, ReplayGain::TrackPeakTag, *result.loudness, result.peak);
+
+        if(const auto album = albums.find(track.albumHash()); album != albums.cend() && album->second.loudness) {
+            setTags(track, ReplayGain::AlbumGainTag, ReplayGain::AlbumPeakTag, *album->second.loudness,
+                    album->second.peak);
+        }
+
+        scanned.push_back(track);
+    }
+
+    return scanned;
+}
+} // namespace
+
+namespace Fooyin {
+struct ReplayGainScanner::Private
+{
+    ReplayGainScanner* self;
+
+    QFutureWatcher<TrackAnalysis> watcher;
+    std::shared_ptr<std::atomic<bool>> cancelled;
+    TrackList tracks;
+    QElapsedTimer timer;
+
+    explicit Private(ReplayGainScanner* self_)
+        : self{self_}
+    {
+        QObject::connect(&watcher, &QFutureWatcherBase::progressValueChanged, self,
+                         [this](int value) { emit self->progressChanged(value, static_cast<int>(tracks.size())); });
+        QObject::connect(&watcher, &QFutureWatcherBase::finished, self, [this]() { scanFinished(); });
+    }
+
+    void scanFinished()
+    {
+        if(watcher.isCanceled()) {
+            return;
+        }
+
+        const auto future = watcher.future();
+        const std::vector<TrackAnalysis> results{future.begin(), future.end()};
+        const TrackList scanned = applyResults(std::exchange(tracks, {}), results);
+
+        qDebug() << "[ReplayGain] Scanned" << results.size() << "tracks in" << timer.elapsed() << "ms";
+
+        emit self->finished(scanned);
+    }
+};
+
+ReplayGainScanner::ReplayGainScanner(QObject* parent)
+    : QObject{parent}
+    , p{std::make_unique<Private>(this)}
+{ }
+
+ReplayGainScanner::~ReplayGainScanner()
+{
+    cancel();
+    p->watcher.waitForFinished();
+}
+
+bool ReplayGainScanner::isScanning() const
+{
+    return p->watcher.isRunning();
+}
+
+void ReplayGainScanner::scan(const TrackList& tracks)
+{
+    cancel();
+
+    if(tracks.empty()) {
+        emit finished({});
+        return;
+    }
+
+    p->tracks    = tracks;
+    p->cancelled = std::make_shared<std::atomic<bool>>(false);
+    p->timer.start();
+
+    // Each track is decoded on its own thread, so throughput scales with the size of the pool
+    auto analyse = [cancelled = p->cancelled](const Track& track) {
+        return analyseTrack(track, *cancelled);
+    };
+    p->watcher.setFuture(QtConcurrent::mapped(QThreadPool::globalInstance(), tracks, analyse));
+}
+
+void ReplayGainScanner::cancel()
+{
+    if(p->cancelled) {
+        p->cancelled->store(true, std::memory_order_relaxed);
+    }
+    p->watcher.cancel();
+    p->tracks.clear();
+}
+
+TrackList ReplayGainScanner::scanBlocking(const TrackList& tracks, QThreadPool* pool)
+{
+    const std::atomic<bool> cancelled{false};
+
+    const auto results = QtConcurrent::blockingMapped<std::vector<TrackAnalysis>>(
+        pool, tracks, [&cancelled](const Track& track) { return analyseTrack(track, cancelled); });
+
+    return applyResults(tracks, results);
+}
+} // namespace Fooyin
+
+#include "moc_replaygainscanner.cpp"
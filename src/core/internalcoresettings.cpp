@@ -47,11 +47,18 @@ CoreSettings::CoreSettings(SettingsManager* settingsManager)
     m_settings->createSetting<GaplessPlayback>(true, QStringLiteral("Engine/GaplessPlayback"));
     m_settings->createSetting<Language>(QStringLiteral(""), QStringLiteral("Language"));
     m_settings->createSetting<BufferLength>(4000, QStringLiteral("Engine/BufferLength"));
+    m_settings->createSetting<NextTrackPreload>(5000, QStringLiteral("Engine/NextTrackPreload"));
+    m_settings->createSetting<CrossfadeLength>(0, QStringLiteral("Engine/CrossfadeLength"));
+    m_settings->createSetting<FadeLength>(0, QStringLiteral("Engine/FadeLength"));
+    m_settings->createSetting<ReplayGainMode>(0, QStringLiteral("Engine/ReplayGainMode"));
+    m_settings->createSetting<ReplayGainPreamp>(0.0, QStringLiteral("Engine/ReplayGainPreamp"));
+    m_settings->createSetting<ReplayGainNoClip>(true, QStringLiteral("Engine/ReplayGainPreventClipping"));
 
     m_settings->createSetting<Internal::MonitorLibraries>(true, QStringLiteral("Library/MonitorLibraries"));
     m_settings->createTempSetting<Internal::MuteVolume>(m_settings->value<OutputVolume>());
     m_settings->createSetting<Internal::DisabledPlugins>(QStringList{}, QStringLiteral("Plugins/Disabled"));
     m_settings->createSetting<Internal::SavePlaybackState>(false, QStringLiteral("Player/SavePlaybackState"));
+    m_settings->createSetting<Internal::EngineMetricsLogging>(0, QStringLiteral("Engine/MetricsLogInterval"));
 
     m_settings->set<FirstRun>(!QFileInfo::exists(Core::settingsPath()));
 }
@@ -0,0 +1,469 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "librarymonitor.h"
+
+#include <core/track.h>
+#include <utils/fileutils.h>
+
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QTimer>
+
+#ifdef Q_OS_LINUX
+#include <QSocketNotifier>
+
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#endif
+
+#include <array>
+#include <map>
+#include <ranges>
+#include <set>
+#include <unordered_map>
+#include <utility>
+
+using namespace std::chrono_literals;
+
+// Events are coalesced until no more have been received for this long
+constexpr auto CoalesceInterval = 250ms;
+// Changes are reported at least this often, even while events keep arriving
+constexpr auto MaxLatency = 2s;
+
+namespace {
+bool isSupportedFile(const QString& path)
+{
+    static const std::set<QString> extensions = []() {
+        std::set<QString> supported;
+        for(const QString& extension : Fooyin::Track::supportedFileExtensions()) {
+            supported.emplace(extension.mid(2).toLower());
+        }
+        return supported;
+    }();
+
+    return extensions.contains(QFileInfo{path}.suffix().toLower());
+}
+
+bool isWithin(const QString& path, const QString& dir)
+{
+    return path == dir || (path.startsWith(dir) && path.at(dir.size()) == u'/');
+}
+
+QStringList filesInDirectory(const QString& dir)
+{
+    return Fooyin::Utils::File::getFilesInDirRecursive(QDir{dir}, Fooyin::Track::supportedFileExtensions());
+}
+} // namespace
+
+namespace Fooyin {
+struct LibraryMonitor::Private
+{
+    LibraryMonitor* self;
+
+    QTimer* flushTimer;
+    QTimer* deadlineTimer;
+
+    std::unordered_map<int, QString> libraries;
+
+    enum class Change : uint8_t
+    {
+        Modified,
+        Removed,
+    };
+
+    struct PendingChanges
+    {
+        std::map<QString, Change> files;
+        std::vector<std::pair<QString, QString>> moved;
+        QStringList removedDirs;
+    };
+    std::unordered_map<int, PendingChanges> pending;
+
+#ifdef Q_OS_LINUX
+    static constexpr uint32_t WatchMask
+        = IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR;
+
+    int fd{-1};
+    QSocketNotifier* notifier{nullptr};
+    bool limitReached{false};
+
+    struct Watch
+    {
+        int libraryId;
+        QString dir;
+    };
+    std::unordered_map<int, Watch> watches;
+
+    struct PendingMove
+    {
+        int libraryId;
+        QString path;
+        bool isDir;
+    };
+    // Keyed by the cookie shared by an IN_MOVED_FROM/IN_MOVED_TO pair
+    std::unordered_map<uint32_t, PendingMove> pendingMoves;
+#endif
+
+    explicit Private(LibraryMonitor* self_)
+        : self{self_}
+        , flushTimer{new QTimer(self)}
+        , deadlineTimer{new QTimer(self)}
+    {
+        flushTimer->setSingleShot(true);
+        flushTimer->setInterval(CoalesceInterval);
+        QObject::connect(flushTimer, &QTimer::timeout, self, [this]() { flush(); });
+
+        deadlineTimer->setSingleShot(true);
+        deadlineTimer->setInterval(MaxLatency);
+        QObject::connect(deadlineTimer, &QTimer::timeout, self, [this]() { flush(); });
+    }
+
+#ifdef Q_OS_LINUX
+    ~Private()
+    {
+        if(fd >= 0) {
+            ::close(fd);
+        }
+    }
+
+    bool init()
+    {
+        if(fd >= 0) {
+            return true;
+        }
+
+        fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if(fd < 0) {
+            qWarning() << "[LibraryMonitor] Unable to initialise inotify:" << std::strerror(errno);
+            return false;
+        }
+
+        notifier = new QSocketNotifier(fd, QSocketNotifier::Read, self);
+        QObject::connect(notifier, &QSocketNotifier::activated, self, [this]() { readEvents(); });
+
+        return true;
+    }
+
+    void addWatch(int libraryId, const QString& dir)
+    {
+        const int wd = inotify_add_watch(fd, QFile::encodeName(dir).constData(), WatchMask);
+        if(wd < 0) {
+            if(errno == ENOSPC && !limitReached) {
+                limitReached = true;
+                qWarning() << "[LibraryMonitor] Reached the inotify watch limit (fs.inotify.max_user_watches) at"
+                           << dir;
+            }
+            return;
+        }
+
+        watches[wd] = {libraryId, dir};
+    }
+
+    // inotify has no recursive watches, so each directory needs its own.
+    // Supported files are collected in the same walk if @p files is set.
+    void addWatches(int libraryId, const QString& dir, QStringList* files = nullptr)
+    {
+        addWatch(libraryId, dir);
+
+        const auto filters = files ? QDir::Dirs | QDir::Files | QDir::NoDotAndDotDot : QDir::Dirs | QDir::NoDotAndDotDot;
+
+        QDirIterator it{dir, filters, QDirIterator::Subdirectories};
+        while(it.hasNext()) {
+            const QString path = it.next();
+            if(it.fileInfo().isDir()) {
+                addWatch(libraryId, path);
+            }
+            else if(isSupportedFile(path)) {
+                files->append(path);
+            }
+        }
+    }
+
+    template <typename Pred>
+    void removeWatches(Pred pred)
+    {
+        std::erase_if(watches, [this, &pred](const auto& watch) {
+            if(pred(watch.second)) {
+                inotify_rm_watch(fd, watch.first);
+                return true;
+            }
+            return false;
+        });
+    }
+
+    void readEvents()
+    {
+        alignas(inotify_event) std::array<char, 16384> buffer;
+
+        ssize_t length{0};
+        while((length = ::read(fd, buffer.data(), buffer.size())) > 0) {
+            ssize_t offset{0};
+            while(offset < length) {
+                const auto* event = reinterpret_cast<const inotify_event*>(buffer.data() + offset);
+                handleEvent(*event);
+                offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+            }
+        }
+
+        flushTimer->start();
+        if(!deadlineTimer->isActive()) {
+            deadlineTimer->start();
+        }
+    }
+
+    void handleEvent(const inotify_event& event)
+    {
+        if(event.mask & IN_Q_OVERFLOW) {
+            pending.clear();
+            pendingMoves.clear();
+            for(const int libraryId : libraries | std::views::keys) {
+                emit self->eventsDropped(libraryId);
+            }
+            return;
+        }
+
+        const auto watchIt = watches.find(event.wd);
+        if(watchIt == watches.end()) {
+            return;
+        }
+
+        if(event.mask & IN_IGNORED) {
+            // Directory was deleted
+            watches.erase(watchIt);
+            return;
+        }
+
+        if(event.len == 0) {
+            return;
+        }
+
+        const int libraryId = watchIt->second.libraryId;
+        const QString path  = watchIt->second.dir + u'/' + QFile::decodeName(event.name);
+        const bool isDir    = event.mask & IN_ISDIR;
+
+        auto& changes = pending[libraryId];
+
+        if(event.mask & IN_MOVED_FROM) {
+            pendingMoves[event.cookie] = {libraryId, path, isDir};
+            return;
+        }
+
+        if(event.mask & IN_MOVED_TO) {
+            if(const auto moveIt = pendingMoves.find(event.cookie); moveIt != pendingMoves.end()) {
+                const PendingMove from = moveIt->second;
+                pendingMoves.erase(moveIt);
+
+                if(from.libraryId == libraryId) {
+                    if(isDir) {
+                        moveDirectory(from.path, path, changes);
+                    }
+                    else {
+                        moveFile(from.path, path, changes);
+                    }
+                    return;
+                }
+
+                movedOut(from);
+            }
+        }
+
+        if(isDir) {
+            if(event.mask & (IN_CREATE | IN_MOVED_TO)) {
+                // Files may have been written before the watches were added
+                QStringList files;
+                addWatches(libraryId, path, &files);
+                for(const QString& file : files) {
+                    changes.files[file] = Change::Modified;
+                }
+            }
+            return;
+        }
+
+        if(!isSupportedFile(path)) {
+            return;
+        }
+
+        if(event.mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) {
+            changes.files[path] = Change::Modified;
+        }
+        else if(event.mask & IN_DELETE) {
+            changes.files[path] = Change::Removed;
+        }
+    }
+
+    static void moveFile(const QString& from, const QString& to, PendingChanges& changes)
+    {
+        if(!isSupportedFile(to)) {
+            if(isSupportedFile(from)) {
+                changes.files[from] = Change::Removed;
+            }
+            return;
+        }
+
+        if(!isSupportedFile(from)) {
+            // i.e. a temporary file renamed into place
+            changes.files[to] = Change::Modified;
+            return;
+        }
+
+        changes.moved.emplace_back(from, to);
+
+        // Pending changes follow the file
+        if(const auto fileIt = changes.files.find(from); fileIt != changes.files.end()) {
+            const Change change = fileIt->second;
+            changes.files.erase(fileIt);
+            if(change == Change::Modified) {
+                changes.files[to] = Change::Modified;
+            }
+        }
+    }
+
+    void moveDirectory(const QString& from, const QString& to, PendingChanges& changes)
+    {
+        // Watches follow the moved inodes, so only their paths need updating
+        for(auto& watch : watches | std::views::values) {
+            if(isWithin(watch.dir, from)) {
+                watch.dir = to + watch.dir.mid(from.size());
+            }
+        }
+
+        for(const QString& file : filesInDirectory(to)) {
+            changes.moved.emplace_back(from + file.mid(to.size()), file);
+        }
+    }
+
+    void movedOut(const PendingMove& move)
+    {
+        auto& changes = pending[move.libraryId];
+
+        if(move.isDir) {
+            removeWatches([&move](const Watch& watch) { return isWithin(watch.dir, move.path); });
+            changes.removedDirs.append(move.path);
+        }
+        else if(isSupportedFile(move.path)) {
+            changes.files[move.path] = Change::Removed;
+        }
+    }
+#else
+    static bool init()
+    {
+        return false;
+    }
+
+    void addWatches(int /*libraryId*/, const QString& /*dir*/) { }
+#endif
+
+    void flush()
+    {
+        flushTimer->stop();
+        deadlineTimer->stop();
+
+#ifdef Q_OS_LINUX
+        // Anything left unmatched was moved outside of the watched directories
+        for(const auto& move : pendingMoves | std::views::values) {
+            movedOut(move);
+        }
+        pendingMoves.clear();
+#endif
+
+        const auto libraryChanges = std::exchange(pending, {});
+
+        for(const auto& [libraryId, libraryChange] : libraryChanges) {
+            LibraryChanges changes;
+            changes.moved       = libraryChange.moved;
+            changes.removedDirs = libraryChange.removedDirs;
+
+            for(const auto& [path, change] : libraryChange.files) {
+                if(change == Change::Modified) {
+                    changes.modified.append(path);
+                }
+                else {
+                    changes.removed.append(path);
+                }
+            }
+
+            if(!changes.isEmpty()) {
+                emit self->changesReady(libraryId, changes);
+            }
+        }
+    }
+};
+
+LibraryMonitor::LibraryMonitor(QObject* parent)
+    : QObject{parent}
+    , p{std::make_unique<Private>(this)}
+{ }
+
+LibraryMonitor::~LibraryMonitor() = default;
+
+bool LibraryMonitor::addLibrary(int id, const QString& path)
+{
+    if(!p->init()) {
+        return false;
+    }
+
+    removeLibrary(id);
+
+    p->libraries.emplace(id, path);
+    p->addWatches(id, QDir::cleanPath(path));
+
+    return true;
+}
+
+void LibraryMonitor::removeLibrary(int id)
+{
+    if(!p->libraries.contains(id)) {
+        return;
+    }
+
+#ifdef Q_OS_LINUX
+    p->removeWatches([id](const Private::Watch& watch) { return watch.libraryId == id; });
+#endif
+
+    p->libraries.erase(id);
+    p->pending.erase(id);
+}
+
+void LibraryMonitor::clear()
+{
+#ifdef Q_OS_LINUX
+    p->removeWatches([](const Private::Watch& /*watch*/) { return true; });
+    p->pendingMoves.clear();
+#endif
+
+    p->flushTimer->stop();
+    p->deadlineTimer->stop();
+    p->libraries.clear();
+    p->pending.clear();
+}
+
+bool LibraryMonitor::isMonitoring(int id) const
+{
+    return p->libraries.contains(id);
+}
+} // namespace Fooyin
+
+#include "moc_librarymonitor.cpp"
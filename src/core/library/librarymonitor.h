@@ -0,0 +1,80 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QStringList>
+
+#include <memory>
+
+namespace Fooyin {
+/*!
+ * A set of coalesced file changes within a single library.
+ * Paths are absolute, and files are limited to supported audio files.
+ */
+struct LibraryChanges
+{
+    // Files which were created or written to
+    QStringList modified;
+    // Files which were deleted or moved outside the library
+    QStringList removed;
+    // Directories which were moved outside the library
+    QStringList removedDirs;
+    // Files which were renamed or moved within the library (from, to)
+    std::vector<std::pair<QString, QString>> moved;
+
+    [[nodiscard]] bool isEmpty() const
+    {
+        return modified.empty() && removed.empty() && removedDirs.empty() && moved.empty();
+    }
+};
+
+/*!
+ * Watches library directories using the native notification API (inotify on Linux),
+ * and reports per-file changes rather than changed directories.
+ */
+class LibraryMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LibraryMonitor(QObject* parent = nullptr);
+    ~LibraryMonitor() override;
+
+    /*!
+     * Starts monitoring the library with @p id at @p path.
+     * @returns false if native monitoring is unavailable.
+     */
+    bool addLibrary(int id, const QString& path);
+    void removeLibrary(int id);
+    void clear();
+
+    [[nodiscard]] bool isMonitoring(int id) const;
+
+signals:
+    void changesReady(int libraryId, const Fooyin::LibraryChanges& changes);
+    /** Emitted if the kernel event queue overflowed. The library must be rescanned. */
+    void eventsDropped(int libraryId);
+
+private:
+    struct Private;
+    std::unique_ptr<Private> p;
+};
+} // namespace Fooyin
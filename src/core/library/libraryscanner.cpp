@@ -30,30 +30,135 @@
 #include <utils/fileutils.h>
 #include <utils/settings/settingsmanager.h>
 
+#include <QDateTime>
 #include <QDir>
+#include <QFileInfo>
 #include <QFileSystemWatcher>
 
+#include <map>
+#include <optional>
 #include <ranges>
+#include <unordered_set>
 
 constexpr auto BatchSize = 250;
 
 namespace {
-Fooyin::Track matchMissingTrack(const Fooyin::TrackFieldMap& missingFiles, const Fooyin::TrackFieldMap& missingHashes,
-                                Fooyin::Track& track)
+// Tracks in the library whose files no longer exist, indexed so they can be matched to moved files
+struct MissingTracks
 {
-    const QString filename = track.filename();
-    const QString hash     = track.hash();
+    Fooyin::TrackIdMap tracks;
+    Fooyin::TrackFieldMap files;
+    Fooyin::TrackFieldMap hashes;
+    Fooyin::TrackFieldMap fingerprints;
+    std::map<std::pair<uint64_t, uint64_t>, Fooyin::Track> fileIds;
+    std::unordered_set<uint64_t> sizes;
+
+    void add(const Fooyin::Track& track)
+    {
+        tracks.emplace(track.id(), track);
+        files.emplace(track.filename(), track);
+        hashes.emplace(track.hash(), track);
+
+        if(!track.fingerprint().isEmpty()) {
+            fingerprints.emplace(track.fingerprint(), track);
+            sizes.emplace(track.fileSize());
+        }
+        if(track.inode() != 0) {
+            fileIds.emplace(std::pair{track.deviceId(), track.inode()}, track);
+        }
+    }
 
-    if(missingFiles.contains(filename) && missingFiles.at(filename).duration() == track.duration()) {
-        return missingFiles.at(filename);
+    void remove(const Fooyin::Track& track)
+    {
+        tracks.erase(track.id());
+        // Other missing tracks may share the same keys, so only remove entries for this track
+        eraseTrack(files, track.filename(), track);
+        eraseTrack(hashes, track.hash(), track);
+        eraseTrack(fingerprints, track.fingerprint(), track);
+        eraseTrack(fileIds, std::pair{track.deviceId(), track.inode()}, track);
     }
 
-    if(missingHashes.contains(hash) && missingHashes.at(hash).duration() == track.duration()) {
-        return missingHashes.at(hash);
+    template <typename Map, typename Key>
+    static void eraseTrack(Map& map, const Key& key, const Fooyin::Track& track)
+    {
+        const auto trackIt = map.find(key);
+        if(trackIt != map.end() && trackIt->second.id() == track.id()) {
+            map.erase(trackIt);
+        }
+    }
+
+    // Inodes are reused once a file is deleted, so check the file at @p filepath existed when the track was added.
+    // Unlike the contents, this still holds if the file's tags were edited after it was moved.
+    template <typename Fingerprint>
+    static bool isSameFile(const Fooyin::Track& track, const QString& filepath, uint64_t size,
+                           const Fingerprint& fileFingerprint)
+    {
+        const QDateTime created = QFileInfo{filepath}.birthTime();
+        if(created.isValid() && track.addedTime() > 0) {
+            return static_cast<uint64_t>(created.toMSecsSinceEpoch()) <= track.addedTime();
+        }
+
+        // Creation time isn't available on every filesystem, so fall back to comparing contents
+        return track.fingerprint().isEmpty() ? track.fileSize() == size : track.fingerprint() == fileFingerprint();
     }
 
-    return {};
+    // Matches using the file itself, so tags don't need to be read
+    [[nodiscard]] Fooyin::Track matchFile(const QString& filepath, uint64_t size) const
+    {
+        if(tracks.empty()) {
+            return {};
+        }
+
+        std::optional<QString> fingerprint;
+        const auto fileFingerprint = [&fingerprint, &filepath]() -> const QString& {
+            if(!fingerprint) {
+                fingerprint = Fooyin::Utils::File::fingerprint(filepath);
+            }
+            return *fingerprint;
+        };
+
+        const auto fileId = Fooyin::Utils::File::fileId(filepath);
+        if(fileId.isValid()) {
+            const auto fileIt = fileIds.find({fileId.device, fileId.inode});
+            if(fileIt != fileIds.cend() && isSameFile(fileIt->second, filepath, size, fileFingerprint)) {
+                return fileIt->second;
+            }
+        }
+
+        // Only fingerprint files which could possibly match
+        if(sizes.contains(size)) {
+            if(!fileFingerprint().isEmpty() && fingerprints.contains(fileFingerprint())) {
+                return fingerprints.at(fileFingerprint());
+            }
+        }
+
+        return {};
+    }
+
+    [[nodiscard]] Fooyin::Track matchTrack(const Fooyin::Track& track) const
+    {
+        const QString filename = track.filename();
+        const QString hash     = track.hash();
+
+        if(files.contains(filename) && files.at(filename).duration() == track.duration()) {
+            return files.at(filename);
+        }
+
+        if(hashes.contains(hash) && hashes.at(hash).duration() == track.duration()) {
+            return hashes.at(hash);
+        }
+
+        return {};
+    }
 };
+
+void readFileIdentity(Fooyin::Track& track)
+{
+    const auto fileId = Fooyin::Utils::File::fileId(track.filepath());
+    track.setDeviceId(fileId.device);
+    track.setInode(fileId.inode);
+    track.setFingerprint(Fooyin::Utils::File::fingerprint(track.filepath()));
+}
 } // namespace
 
 namespace Fooyin {
@@ -73,16 +178,50 @@ struct LibraryScanner::Private
     double totalTracks{0};
     int currentProgress{-1};
 
+    LibraryMonitor* monitor;
+    LibraryInfoMap monitoredLibraries;
+    // Fallback if native monitoring is unavailable
     std::unordered_map<int, LibraryWatcher> watchers;
 
     Private(LibraryScanner* self_, DbConnectionPoolPtr dbPool_, SettingsManager* settings_)
         : self{self_}
         , dbPool{std::move(dbPool_)}
         , settings{settings_}
-    { }
+        , monitor{new LibraryMonitor(self)}
+    {
+        QObject::connect(monitor, &LibraryMonitor::changesReady, self,
+                         [this](int libraryId, const LibraryChanges& changes) {
+                             if(monitoredLibraries.contains(libraryId)) {
+                                 emit self->libraryChanged(monitoredLibraries.at(libraryId), changes);
+                             }
+                         });
+        QObject::connect(monitor, &LibraryMonitor::eventsDropped, self, [this](int libraryId) {
+            if(monitoredLibraries.contains(libraryId)) {
+                const auto& library = monitoredLibraries.at(libraryId);
+                emit self->directoryChanged(library, library.path);
+            }
+        });
+    }
+
+    [[nodiscard]] bool isWatching(int libraryId) const
+    {
+        return monitor->isMonitoring(libraryId) || watchers.contains(libraryId);
+    }
+
+    void clearWatchers()
+    {
+        monitor->clear();
+        monitoredLibraries.clear();
+        watchers.clear();
+    }
 
     void addWatcher(const Fooyin::LibraryInfo& library)
     {
+        if(monitor->addLibrary(library.id, library.path)) {
+            monitoredLibraries[library.id] = library;
+            return;
+        }
+
         auto watchPaths = [this, library](const QString& path) {
             QStringList dirs = Utils::File::getAllSubdirectories(path);
             dirs.append(path);
@@ -124,15 +263,13 @@ struct LibraryScanner::Private
         TrackList tracksToUpdate;
 
         TrackFieldMap trackPaths;
-        TrackFieldMap missingFiles;
-        TrackFieldMap missingHashes;
+        MissingTracks missingTracks;
 
         for(const Track& track : tracks) {
             trackPaths.emplace(track.filepath(), track);
 
             if(!QFileInfo::exists(track.filepath())) {
-                missingFiles.emplace(track.filename(), track);
-                missingHashes.emplace(track.hash(), track);
+                missingTracks.add(track);
             }
         }
 
@@ -158,10 +295,7 @@ struct LibraryScanner::Private
             }
 
             auto setTrackProps = [this, &filepath, &dir](Track& track) {
-                track.setFilePath(filepath);
-                track.setLibraryId(currentLibrary.id);
-                track.setRelativePath(dir.relativeFilePath(filepath));
-                track.setIsEnabled(true);
+                setTrackProperties(track, filepath, dir);
             };
 
             if(trackPaths.contains(filepath)) {
@@ -174,22 +308,47 @@ struct LibraryScanner::Private
                         setTrackProps(changedTrack);
 
                         tracksToUpdate.push_back(changedTrack);
-                        missingHashes.erase(changedTrack.hash());
-                        missingFiles.erase(changedTrack.filename());
+                        missingTracks.remove(changedTrack);
                     }
                 }
+                else if(libraryTrack.inode() == 0 && libraryTrack.fingerprint().isEmpty()) {
+                    // Scanned before file identities were recorded
+                    Track identifiedTrack{libraryTrack};
+                    readFileIdentity(identifiedTrack);
+                    tracksToUpdate.push_back(identifiedTrack);
+                }
+            }
+            else if(Track movedTrack = missingTracks.matchFile(filepath, static_cast<uint64_t>(info.size()));
+                    movedTrack.isInLibrary() || movedTrack.isInDatabase()) {
+                missingTracks.remove(movedTrack);
+
+                // Keeps the id and stats of the track, but tags may have changed along with the move
+                const bool modified = movedTrack.fileSize() != static_cast<uint64_t>(info.size())
+                                   || movedTrack.modifiedTime() != lastModified;
+
+                setTrackProps(movedTrack);
+
+                if(!modified) {
+                    readFileIdentity(movedTrack);
+                    tracksToUpdate.push_back(movedTrack);
+                }
+                else if(Tagging::readMetaData(movedTrack)) {
+                    tracksToUpdate.push_back(movedTrack);
+                }
             }
             else {
                 Track track{filepath};
 
                 if(Tagging::readMetaData(track)) {
-                    Track refoundTrack = matchMissingTrack(missingFiles, missingHashes, track);
+                    Track refoundTrack = missingTracks.matchTrack(track);
 
                     if(refoundTrack.isInLibrary() || refoundTrack.isInDatabase()) {
-                        missingHashes.erase(refoundTrack.hash());
-                        missingFiles.erase(refoundTrack.filename());
+                        missingTracks.remove(refoundTrack);
 
                         setTrackProps(refoundTrack);
+                        refoundTrack.setDeviceId(track.deviceId());
+                        refoundTrack.setInode(track.inode());
+                        refoundTrack.setFingerprint(track.fingerprint());
                         tracksToUpdate.push_back(refoundTrack);
                     }
                     else {
@@ -208,7 +367,7 @@ struct LibraryScanner::Private
             reportProgress();
         }
 
-        for(auto& track : missingFiles | std::views::values) {
+        for(auto& track : missingTracks.tracks | std::views::values) {
             if(track.isInLibrary() || track.isEnabled()) {
                 track.setLibraryId(-1);
                 track.setIsEnabled(false);
@@ -226,6 +385,186 @@ struct LibraryScanner::Private
         return true;
     }
 
+    void setTrackProperties(Track& track, const QString& filepath, const QDir& dir) const
+    {
+        track.setFilePath(filepath);
+        track.setLibraryId(currentLibrary.id);
+        track.setRelativePath(dir.relativeFilePath(filepath));
+        track.setIsEnabled(true);
+    }
+
+    Track findMissingTrack(const Track& track) const
+    {
+        const TrackList candidates = trackDatabase.tracksByHash(track.hash());
+        for(const Track& candidate : candidates) {
+            if(candidate.duration() == track.duration() && !QFileInfo::exists(candidate.filepath())) {
+                return candidate;
+            }
+        }
+        return {};
+    }
+
+    void applyChanges(const LibraryChanges& changes)
+    {
+        const QDir dir{currentLibrary.path};
+
+        TrackList tracksToStore;
+        TrackList tracksUpdated;
+
+        auto disableTrack = [](Track track, TrackList& tracksToUpdate) {
+            if(track.isInLibrary() || track.isEnabled()) {
+                track.setLibraryId(-1);
+                track.setIsEnabled(false);
+                tracksToUpdate.push_back(track);
+            }
+        };
+
+        auto storeUpdated = [this, &tracksUpdated](TrackList& tracksToUpdate) {
+            // Stored as we go so later lookups see the changes
+            storeTracks(tracksToUpdate);
+            std::ranges::move(tracksToUpdate, std::back_inserter(tracksUpdated));
+        };
+
+        QStringList modified{changes.modified};
+
+        if(!changes.moved.empty()) {
+            QStringList paths;
+            for(const auto& [from, to] : changes.moved) {
+                paths.append(from);
+                paths.append(to);
+            }
+
+            TrackFieldMap existing;
+            for(const Track& track : trackDatabase.tracksByPaths(paths)) {
+                existing.emplace(track.filepath(), track);
+            }
+
+            TrackList tracksToUpdate;
+
+            for(const auto& [from, to] : changes.moved) {
+                const auto fromIt = existing.find(from);
+                if(fromIt == existing.end()) {
+                    modified.append(to);
+                    continue;
+                }
+
+                Track track{fromIt->second};
+                existing.erase(fromIt);
+
+                if(existing.contains(to)) {
+                    // Replaced a file already in the library
+                    disableTrack(track, tracksToUpdate);
+                    modified.append(to);
+                    continue;
+                }
+
+                setTrackProperties(track, to, dir);
+                tracksToUpdate.push_back(track);
+                existing.emplace(to, track);
+            }
+
+            storeUpdated(tracksToUpdate);
+        }
+
+        if(!changes.removed.empty() || !changes.removedDirs.empty()) {
+            TrackList removedTracks = trackDatabase.tracksByPaths(changes.removed);
+            for(const QString& removedDir : changes.removedDirs) {
+                std::ranges::move(trackDatabase.tracksInDirectory(removedDir), std::back_inserter(removedTracks));
+            }
+
+            TrackList tracksToUpdate;
+            for(const Track& track : removedTracks) {
+                if(!QFileInfo::exists(track.filepath())) {
+                    disableTrack(track, tracksToUpdate);
+                }
+            }
+
+            storeUpdated(tracksToUpdate);
+        }
+
+        modified.removeDuplicates();
+
+        TrackFieldMap existing;
+        for(const Track& track : trackDatabase.tracksByPaths(modified)) {
+            existing.emplace(track.filepath(), track);
+        }
+
+        tracksProcessed = 0;
+        totalTracks     = static_cast<double>(modified.size());
+        currentProgress = -1;
+
+        TrackList tracksToUpdate;
+
+        for(const QString& filepath : std::as_const(modified)) {
+            if(!self->mayRun()) {
+                break;
+            }
+
+            ++tracksProcessed;
+
+            const QFileInfo info{filepath};
+            if(!info.exists()) {
+                continue;
+            }
+
+            const QDateTime lastModifiedTime{info.lastModified()};
+            const uint64_t lastModified
+                = lastModifiedTime.isValid() ? static_cast<uint64_t>(lastModifiedTime.toMSecsSinceEpoch()) : 0;
+
+            if(existing.contains(filepath)) {
+                const Track& libraryTrack = existing.at(filepath);
+
+                if(!libraryTrack.isEnabled() || libraryTrack.libraryId() != currentLibrary.id
+                   || libraryTrack.modifiedTime() != lastModified) {
+                    Track changedTrack{libraryTrack};
+                    if(Tagging::readMetaData(changedTrack)) {
+                        setTrackProperties(changedTrack, filepath, dir);
+                        tracksToUpdate.push_back(changedTrack);
+                    }
+                }
+            }
+            else {
+                Track track{filepath};
+
+                if(Tagging::readMetaData(track)) {
+                    Track refoundTrack = findMissingTrack(track);
+
+                    if(refoundTrack.isInLibrary() || refoundTrack.isInDatabase()) {
+                        setTrackProperties(refoundTrack, filepath, dir);
+                        tracksToUpdate.push_back(refoundTrack);
+                    }
+                    else {
+                        setTrackProperties(track, filepath, dir);
+                        tracksToStore.push_back(track);
+                    }
+                }
+            }
+
+            reportProgress();
+        }
+
+        storeTracks(tracksToStore);
+        storeUpdated(tracksToUpdate);
+
+        if(!tracksToStore.empty() || !tracksUpdated.empty()) {
+            emit self->scanUpdate({tracksToStore, tracksUpdated});
+        }
+    }
+
+    void finishScan()
+    {
+        if(self->state() == Paused) {
+            changeLibraryStatus(LibraryInfo::Status::Pending);
+        }
+        else {
+            changeLibraryStatus(settings->value<Settings::Core::Internal::MonitorLibraries>()
+                                    ? LibraryInfo::Status::Monitoring
+                                    : LibraryInfo::Status::Idle);
+            self->setState(Idle);
+            emit self->finished();
+        }
+    }
+
     void changeLibraryStatus(LibraryInfo::Status status)
     {
         currentLibrary.status = status;
@@ -267,7 +606,7 @@ void LibraryScanner::setupWatchers(const LibraryInfoMap& libraries, bool enabled
                 emit statusChanged(updatedLibrary);
             }
         }
-        else if(!p->watchers.contains(library.id)) {
+        else if(!p->isWatching(library.id)) {
             p->addWatcher(library);
             LibraryInfo updatedLibrary{library};
             updatedLibrary.status = LibraryInfo::Status::Monitoring;
@@ -276,7 +615,7 @@ void LibraryScanner::setupWatchers(const LibraryInfoMap& libraries, bool enabled
     }
 
     if(!enabled) {
-        p->watchers.clear();
+        p->clearWatchers();
     }
 }
 
@@ -289,22 +628,13 @@ void LibraryScanner::scanLibrary(const LibraryInfo& library, const TrackList& tr
     p->changeLibraryStatus(LibraryInfo::Status::Scanning);
 
     if(p->currentLibrary.id >= 0 && QFileInfo::exists(p->currentLibrary.path)) {
-        if(p->settings->value<Settings::Core::Internal::MonitorLibraries>() && !p->watchers.contains(library.id)) {
+        if(p->settings->value<Settings::Core::Internal::MonitorLibraries>() && !p->isWatching(library.id)) {
             p->addWatcher(library);
         }
         p->getAndSaveAllTracks(library.path, tracks);
     }
 
-    if(state() == Paused) {
-        p->changeLibraryStatus(LibraryInfo::Status::Pending);
-    }
-    else {
-        p->changeLibraryStatus(p->settings->value<Settings::Core::Internal::MonitorLibraries>()
-                                   ? LibraryInfo::Status::Monitoring
-                                   : LibraryInfo::Status::Idle);
-        setState(Idle);
-        emit finished();
-    }
+    p->finishScan();
 }
 
 void LibraryScanner::scanLibraryDirectory(const LibraryInfo& library, const QString& dir, const TrackList& tracks)
@@ -317,16 +647,20 @@ void LibraryScanner::scanLibraryDirectory(const LibraryInfo& library, const QStr
 
     p->getAndSaveAllTracks(dir, tracks);
 
-    if(state() == Paused) {
-        p->changeLibraryStatus(LibraryInfo::Status::Pending);
-    }
-    else {
-        p->changeLibraryStatus(p->settings->value<Settings::Core::Internal::MonitorLibraries>()
-                                   ? LibraryInfo::Status::Monitoring
-                                   : LibraryInfo::Status::Idle);
-        setState(Idle);
-        emit finished();
-    }
+    p->finishScan();
+}
+
+void LibraryScanner::scanChanges(const LibraryInfo& library, const LibraryChanges& changes)
+{
+    setState(Running);
+
+    p->currentLibrary = library;
+
+    p->changeLibraryStatus(LibraryInfo::Status::Scanning);
+
+    p->applyChanges(changes);
+
+    p->finishScan();
 }
 
 void LibraryScanner::scanTracks(const TrackList& libraryTracks, const TrackList& tracks)
@@ -20,6 +20,7 @@
 #pragma once
 
 #include "library/libraryinfo.h"
+#include "library/librarymonitor.h"
 
 #include <core/trackfwd.h>
 #include <utils/database/dbconnectionpool.h>
@@ -52,11 +53,13 @@ signals:
     void scanUpdate(const ScanResult& result);
     void scannedTracks(const TrackList& tracks);
     void directoryChanged(const LibraryInfo& library, const QString& dir);
+    void libraryChanged(const LibraryInfo& library, const LibraryChanges& changes);
 
 public slots:
     void setupWatchers(const LibraryInfoMap& libraries, bool enabled);
     void scanLibrary(const LibraryInfo& library, const TrackList& tracks);
     void scanLibraryDirectory(const LibraryInfo& library, const QString& dir, const TrackList& tracks);
+    void scanChanges(const LibraryInfo& library, const LibraryChanges& changes);
     void scanTracks(const TrackList& libraryTracks, const TrackList& tracks);
 
 private:
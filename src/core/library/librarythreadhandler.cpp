@@ -46,6 +46,7 @@ struct LibraryScanRequest
     LibraryInfo library;
     QString dir;
     TrackList tracks;
+    LibraryChanges changes;
 };
 
 struct LibraryThreadHandler::Private
@@ -103,6 +104,12 @@ struct LibraryThreadHandler::Private
         });
     }
 
+    void scanChanges(const LibraryScanRequest& request)
+    {
+        QMetaObject::invokeMethod(&scanner,
+                                  [this, request]() { scanner.scanChanges(request.library, request.changes); });
+    }
+
     ScanRequest addLibraryScanRequest(const LibraryInfo& libraryInfo)
     {
         const int id = nextRequestId();
@@ -160,6 +167,31 @@ struct LibraryThreadHandler::Private
         return request;
     }
 
+    void addChangesScanRequest(const LibraryInfo& libraryInfo, const LibraryChanges& changes)
+    {
+        // Merge into a queued request for the same library if possible
+        const auto requestIt = std::ranges::find_if(scanRequests, [this, &libraryInfo](const auto& request) {
+            return request.id != currentRequestId && request.library.id == libraryInfo.id
+                && !request.changes.isEmpty();
+        });
+
+        if(requestIt != scanRequests.end()) {
+            LibraryChanges& pending = requestIt->changes;
+            pending.modified.append(changes.modified);
+            pending.removed.append(changes.removed);
+            pending.removedDirs.append(changes.removedDirs);
+            pending.moved.insert(pending.moved.end(), changes.moved.cbegin(), changes.moved.cend());
+            return;
+        }
+
+        scanRequests.emplace_back(nextRequestId(), ScanRequest::Library, libraryInfo, QStringLiteral(""), TrackList{},
+                                  changes);
+
+        if(scanRequests.size() == 1) {
+            execNextRequest();
+        }
+    }
+
     std::optional<LibraryScanRequest> currentRequest() const
     {
         const auto requestIt = std::ranges::find_if(
@@ -182,6 +214,9 @@ struct LibraryThreadHandler::Private
         if(request.type == ScanRequest::Tracks) {
             scanTracks(request);
         }
+        else if(!request.changes.isEmpty()) {
+            scanChanges(request);
+        }
         else {
             if(request.dir.isEmpty()) {
                 scanLibrary(request);
@@ -229,7 +264,14 @@ LibraryThreadHandler::LibraryThreadHandler(DbConnectionPoolPtr dbPool, MusicLibr
                      &LibraryThreadHandler::gotTracks);
     QObject::connect(&p->trackDatabaseManager, &TrackDatabaseManager::updatedTracks, this,
                      &LibraryThreadHandler::tracksUpdated);
-    QObject::connect(&p->scanner, &Worker::finished, this, [this]() { p->finishScanRequest(); });
+    QObject::connect(&p->trackDatabaseManager, &TrackDatabaseManager::writeProgress, this,
+                     &LibraryThreadHandler::writeProgress);
+    QObject::connect(&p->trackDatabaseManager, &TrackDatabaseManager::writeFinished, this,
+                     &LibraryThreadHandler::writeFinished);
+    QObject::connect(&p->scanner, &Worker::finished, this, [this]() {
+        p->finishScanRequest();
+        emit scanFinished();
+    });
     QObject::connect(&p->scanner, &LibraryScanner::progressChanged, this,
                      [this](int percent) { emit progressChanged(p->currentRequestId, percent); });
     QObject::connect(&p->scanner, &LibraryScanner::scannedTracks, this,
@@ -239,6 +281,10 @@ LibraryThreadHandler::LibraryThreadHandler(DbConnectionPoolPtr dbPool, MusicLibr
     QObject::connect(
         &p->scanner, &LibraryScanner::directoryChanged, this,
         [this](const LibraryInfo& libraryInfo, const QString& dir) { p->addDirectoryScanRequest(libraryInfo, dir); });
+    QObject::connect(&p->scanner, &LibraryScanner::libraryChanged, this,
+                     [this](const LibraryInfo& libraryInfo, const LibraryChanges& changes) {
+                         p->addChangesScanRequest(libraryInfo, changes);
+                     });
 
     QMetaObject::invokeMethod(&p->scanner, &Worker::initialiseThread);
     QMetaObject::invokeMethod(&p->trackDatabaseManager, &Worker::initialiseThread);
@@ -248,6 +294,7 @@ LibraryThreadHandler::~LibraryThreadHandler()
 {
     p->scanner.stopThread();
     p->trackDatabaseManager.stopThread();
+    p->trackDatabaseManager.closeThread();
 
     p->thread.quit();
     p->thread.wait();
@@ -289,10 +336,14 @@ void LibraryThreadHandler::libraryRemoved(int id)
     }
 }
 
-void LibraryThreadHandler::saveUpdatedTracks(const TrackList& tracks)
+WriteRequest LibraryThreadHandler::saveUpdatedTracks(const TrackList& tracks)
 {
+    const int id = nextRequestId();
+
     QMetaObject::invokeMethod(&p->trackDatabaseManager,
-                              [this, tracks]() { p->trackDatabaseManager.updateTracks(tracks); });
+                              [this, id, tracks]() { p->trackDatabaseManager.updateTracks(id, tracks); });
+
+    return {.id = id, .cancel = [this, id]() { p->trackDatabaseManager.cancelWrite(id); }};
 }
 
 void LibraryThreadHandler::saveUpdatedTrackStats(const TrackList& track)
@@ -301,6 +352,12 @@ void LibraryThreadHandler::saveUpdatedTrackStats(const TrackList& track)
                               [this, track]() { p->trackDatabaseManager.updateTrackStats(track); });
 }
 
+void LibraryThreadHandler::saveCoverLocations(const TrackList& tracks)
+{
+    QMetaObject::invokeMethod(&p->trackDatabaseManager,
+                              [this, tracks]() { p->trackDatabaseManager.updateCoverLocations(tracks); });
+}
+
 void LibraryThreadHandler::cleanupTracks()
 {
     QMetaObject::invokeMethod(&p->trackDatabaseManager, &TrackDatabaseManager::cleanupTracks);
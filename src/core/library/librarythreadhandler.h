@@ -31,6 +31,7 @@ class SettingsManager;
 class MusicLibrary;
 struct ScanResult;
 struct ScanRequest;
+struct WriteRequest;
 
 class LibraryThreadHandler : public QObject
 {
@@ -48,15 +49,19 @@ public:
     ScanRequest scanLibrary(const LibraryInfo& library);
     ScanRequest scanTracks(const TrackList& tracks);
 
-    void saveUpdatedTracks(const TrackList& tracks);
+    WriteRequest saveUpdatedTracks(const TrackList& tracks);
     void saveUpdatedTrackStats(const TrackList& track);
+    void saveCoverLocations(const TrackList& tracks);
     void cleanupTracks();
 
     void libraryRemoved(int id);
 
 signals:
     void progressChanged(int id, int percent);
+    void writeProgress(int id, int percent);
+    void writeFinished(int id);
     void scannedTracks(int id, const TrackList& tracks);
+    void scanFinished();
     void statusChanged(const LibraryInfo& library);
     void scanUpdate(const ScanResult& result);
     void tracksUpdated(const TrackList& tracks);
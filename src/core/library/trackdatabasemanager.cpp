@@ -25,11 +25,52 @@
 #include <core/track.h>
 #include <utils/database/dbconnectionhandler.h>
 
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QtConcurrentMap>
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace {
+constexpr auto WriteChunkSize  = 100;
+constexpr auto MaxWriteThreads = 4;
+
+struct PendingWrite
+{
+    Fooyin::Track track;
+    bool written{false};
+};
+
+// Tracks sharing a file (cue sheets, archives) are written one after another by the same task
+using FileWrites = std::vector<PendingWrite*>;
+
+std::vector<FileWrites> groupByFile(std::vector<PendingWrite>& writes)
+{
+    std::vector<FileWrites> fileWrites;
+    std::unordered_map<QString, size_t> fileIndexes;
+
+    for(PendingWrite& write : writes) {
+        const auto [fileIt, inserted] = fileIndexes.try_emplace(write.track.filepath(), fileWrites.size());
+        if(inserted) {
+            fileWrites.emplace_back();
+        }
+        fileWrites.at(fileIt->second).push_back(&write);
+    }
+
+    return fileWrites;
+}
+} // namespace
+
 namespace Fooyin {
 TrackDatabaseManager::TrackDatabaseManager(DbConnectionPoolPtr dbPool, QObject* parent)
     : Worker{parent}
     , m_dbPool{std::move(dbPool)}
-{ }
+{
+    // Tag writing is mostly disk bound, so more threads rarely help
+    m_writePool.setMaxThreadCount(std::clamp(QThread::idealThreadCount(), 1, MaxWriteThreads));
+}
 
 void TrackDatabaseManager::initialiseThread()
 {
@@ -41,24 +82,83 @@ void TrackDatabaseManager::initialiseThread()
 
 void TrackDatabaseManager::getAllTracks()
 {
+    QElapsedTimer timer;
+    timer.start();
+
     const TrackList tracks = m_trackDatabase.getAllTracks();
+    qDebug() << "[Library] Read" << tracks.size() << "tracks in" << timer.elapsed() << "ms";
+
     emit gotTracks(tracks);
 }
 
-void TrackDatabaseManager::updateTracks(const TrackList& tracks)
+void TrackDatabaseManager::cancelWrite(int id)
+{
+    const std::scoped_lock lock{m_cancelGuard};
+    if(id > m_lastWrite) {
+        m_cancelledWrites.emplace(id);
+    }
+}
+
+void TrackDatabaseManager::updateTracks(int id, const TrackList& tracks)
 {
+    QElapsedTimer timer;
+    timer.start();
+
+    const auto total = static_cast<int>(tracks.size());
+    int processed{0};
     TrackList tracksUpdated;
 
-    for(const Track& track : tracks) {
-        Track updatedTrack{track};
-        if(Tagging::writeMetaData(updatedTrack) && m_trackDatabase.updateTrack(updatedTrack)) {
-            tracksUpdated.emplace_back(updatedTrack);
+    for(auto chunkStart = tracks.cbegin(); chunkStart != tracks.cend() && !writeCancelled(id);) {
+        const auto chunkEnd = chunkStart + std::min<std::ptrdiff_t>(WriteChunkSize, tracks.cend() - chunkStart);
+
+        std::vector<PendingWrite> writes;
+        writes.reserve(chunkEnd - chunkStart);
+        std::transform(chunkStart, chunkEnd, std::back_inserter(writes),
+                       [](const Track& track) { return PendingWrite{track}; });
+        chunkStart = chunkEnd;
+
+        // writeMetaData only touches its own file and track copy; the TagLib frame factory and
+        // QMimeDatabase it shares are safe to use from several threads
+        std::vector<FileWrites> fileWrites = groupByFile(writes);
+        QtConcurrent::blockingMap(&m_writePool, fileWrites, [this, id](const FileWrites& fileWrite) {
+            for(PendingWrite* write : fileWrite) {
+                if(!writeCancelled(id)) {
+                    write->written = Tagging::writeMetaData(write->track);
+                }
+            }
+        });
+
+        TrackList writtenTracks;
+        for(const PendingWrite& write : writes) {
+            if(write.written) {
+                writtenTracks.push_back(write.track);
+            }
         }
+
+        const TrackList updatedChunk = m_trackDatabase.updateTracks(writtenTracks);
+        std::ranges::copy(updatedChunk, std::back_inserter(tracksUpdated));
+
+        processed += static_cast<int>(writes.size());
+        emit writeProgress(id, processed * 100 / total);
     }
 
+    if(processed < total) {
+        qDebug() << "[Library] Cancelled writing metadata after" << processed << "of" << total << "tracks";
+    }
+    qDebug() << "[Library] Wrote metadata for" << tracksUpdated.size() << "tracks in" << timer.elapsed() << "ms";
+
+    // Emitted once so the library re-sorts and views update a single time
     if(!tracksUpdated.empty()) {
         emit updatedTracks(tracksUpdated);
     }
+
+    {
+        const std::scoped_lock lock{m_cancelGuard};
+        m_cancelledWrites.erase(id);
+        m_lastWrite = std::max(m_lastWrite, id);
+    }
+
+    emit writeFinished(id);
 }
 
 void TrackDatabaseManager::updateTrackStats(const TrackList& tracks)
@@ -66,10 +166,25 @@ void TrackDatabaseManager::updateTrackStats(const TrackList& tracks)
     m_trackDatabase.updateTrackStats(tracks);
 }
 
+void TrackDatabaseManager::updateCoverLocations(const TrackList& tracks)
+{
+    m_trackDatabase.updateCoverLocations(tracks);
+}
+
 void TrackDatabaseManager::cleanupTracks()
 {
     m_trackDatabase.cleanupTracks();
 }
+
+bool TrackDatabaseManager::writeCancelled(int id)
+{
+    if(closing()) {
+        return true;
+    }
+
+    const std::scoped_lock lock{m_cancelGuard};
+    return m_cancelledWrites.contains(id);
+}
 } // namespace Fooyin
 
 #include "moc_trackdatabasemanager.cpp"
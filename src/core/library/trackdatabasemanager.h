@@ -24,6 +24,11 @@
 #include <utils/database/dbconnectionhandler.h>
 #include <utils/worker.h>
 
+#include <QThreadPool>
+
+#include <mutex>
+#include <set>
+
 namespace Fooyin {
 class Database;
 
@@ -36,19 +41,37 @@ public:
 
     void initialiseThread() override;
 
+    /** Cancels the write request @p id. Safe to call from any thread. */
+    void cancelWrite(int id);
+
 signals:
     void gotTracks(const TrackList& tracks);
     void updatedTracks(const TrackList& tracks);
+    void writeProgress(int id, int percent);
+    void writeFinished(int id);
 
 public slots:
     void getAllTracks();
-    void updateTracks(const TrackList& tracks);
+    /*!
+     * Writes metadata to the files of @p tracks on a worker pool, and updates the database.
+     * Tracks are processed in chunks, each committed in one transaction and reported through writeProgress.
+     * All updated tracks are emitted through updatedTracks once, before writeFinished.
+     */
+    void updateTracks(int id, const TrackList& tracks);
     void updateTrackStats(const TrackList& track);
+    void updateCoverLocations(const TrackList& tracks);
     void cleanupTracks();
 
 private:
     DbConnectionPoolPtr m_dbPool;
     std::unique_ptr<DbConnectionHandler> m_dbHandler;
     TrackDatabase m_trackDatabase;
+
+    QThreadPool m_writePool;
+    std::mutex m_cancelGuard;
+    std::set<int> m_cancelledWrites;
+    int m_lastWrite{-1};
+
+    [[nodiscard]] bool writeCancelled(int id);
 };
 } // namespace Fooyin
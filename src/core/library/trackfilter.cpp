@@ -19,16 +19,20 @@
 
 #include <core/library/trackfilter.h>
 
+#include <core/library/tracksearchindex.h>
 #include <core/track.h>
 #include <utils/helpers.h>
 
 namespace {
+constexpr auto CancelCheckInterval = 1024;
+
 bool containsSearch(const QString& text, const QString& search)
 {
     return text.contains(search, Qt::CaseInsensitive);
 }
 
 // TODO: Use user-defined search script
+// Any fields added here must also be indexed by TrackSearchIndex
 bool matchSearch(const Fooyin::Track& track, const QString& search)
 {
     if(search.isEmpty()) {
@@ -46,4 +50,80 @@ TrackList filterTracks(const TrackList& tracks, const QString& search)
 {
     return Fooyin::Utils::filter(tracks, [search](const Fooyin::Track& track) { return matchSearch(track, search); });
 }
+
+TrackList filterTracks(const TrackList& tracks, const QString& search, const std::function<bool()>& isCancelled)
+{
+    TrackList filteredTracks;
+
+    int count{0};
+    for(const Track& track : tracks) {
+        if(++count % CancelCheckInterval == 0 && isCancelled()) {
+            return {};
+        }
+        if(matchSearch(track, search)) {
+            filteredTracks.push_back(track);
+        }
+    }
+
+    return filteredTracks;
+}
+
+TrackList filterTracks(const TrackList& tracks, const QString& search, const TrackSearchIndex& index,
+                       const std::function<bool()>& isCancelled)
+{
+    const auto candidates = index.candidates(search);
+    if(!candidates) {
+        return isCancelled ? filterTracks(tracks, search, isCancelled) : filterTracks(tracks, search);
+    }
+
+    if(candidates->empty()) {
+        return {};
+    }
+
+    std::vector<bool> isCandidate(candidates->back() + 1, false);
+    for(const int id : *candidates) {
+        isCandidate[id] = true;
+    }
+
+    const auto candidateCount = static_cast<int>(isCandidate.size());
+
+    TrackList filteredTracks;
+
+    int count{0};
+    for(const Track& track : tracks) {
+        if(isCancelled && ++count % CancelCheckInterval == 0 && isCancelled()) {
+            return {};
+        }
+
+        const int id = track.id();
+        if(id >= 0 && id < candidateCount && isCandidate[id] && matchSearch(track, search)) {
+            filteredTracks.push_back(track);
+        }
+    }
+
+    return filteredTracks;
+}
+
+TrackList filterIndexedTracks(const TrackSearchIndex& index, const QString& search, const TrackList& tracks,
+                              const std::function<bool()>& isCancelled)
+{
+    const auto candidates = index.candidateTracks(search);
+    if(!candidates) {
+        return isCancelled ? filterTracks(tracks, search, isCancelled) : filterTracks(tracks, search);
+    }
+
+    TrackList filteredTracks;
+
+    int count{0};
+    for(const Track& track : *candidates) {
+        if(isCancelled && ++count % CancelCheckInterval == 0 && isCancelled()) {
+            return {};
+        }
+        if(matchSearch(track, search)) {
+            filteredTracks.push_back(track);
+        }
+    }
+
+    return filteredTracks;
+}
 } // namespace Fooyin::Filter
@@ -0,0 +1,358 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <core/library/tracksearchindex.h>
+
+#include <utils/async.h>
+
+#include <QFuture>
+
+#include <algorithm>
+#include <iterator>
+#include <mutex>
+#include <ranges>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace {
+using Trigram  = uint64_t;
+using Trigrams = std::vector<Trigram>;
+
+void addTrigrams(const QString& text, Trigrams& trigrams)
+{
+    const QString folded = text.toCaseFolded();
+    const qsizetype size = folded.size();
+
+    for(qsizetype i{0}; i + 2 < size; ++i) {
+        trigrams.push_back((static_cast<Trigram>(folded.at(i).unicode()) << 32)
+                           | (static_cast<Trigram>(folded.at(i + 1).unicode()) << 16)
+                           | static_cast<Trigram>(folded.at(i + 2).unicode()));
+    }
+}
+
+Trigrams uniqueTrigrams(Trigrams trigrams)
+{
+    std::ranges::sort(trigrams);
+    const auto [first, last] = std::ranges::unique(trigrams);
+    trigrams.erase(first, last);
+    return trigrams;
+}
+
+// Must cover the same fields as matchSearch in trackfilter.cpp
+Trigrams trigramsForTrack(const Fooyin::Track& track)
+{
+    Trigrams trigrams;
+    addTrigrams(track.artist(), trigrams);
+    addTrigrams(track.title(), trigrams);
+    addTrigrams(track.album(), trigrams);
+    addTrigrams(track.albumArtist(), trigrams);
+    addTrigrams(track.filename(), trigrams);
+    return uniqueTrigrams(std::move(trigrams));
+}
+
+void insertSorted(Fooyin::TrackIds& ids, int id)
+{
+    if(ids.empty() || ids.back() < id) {
+        ids.push_back(id);
+        return;
+    }
+
+    const auto it = std::ranges::lower_bound(ids, id);
+    if(it == ids.end() || *it != id) {
+        ids.insert(it, id);
+    }
+}
+
+void eraseSorted(Fooyin::TrackIds& ids, int id)
+{
+    const auto it = std::ranges::lower_bound(ids, id);
+    if(it != ids.end() && *it == id) {
+        ids.erase(it);
+    }
+}
+
+// Merges the sorted posting lists, starting from the rarest so the result only shrinks
+Fooyin::TrackIds intersect(std::vector<const Fooyin::TrackIds*> lists)
+{
+    std::ranges::sort(lists, {}, [](const Fooyin::TrackIds* ids) { return ids->size(); });
+
+    Fooyin::TrackIds result = *lists.front();
+    Fooyin::TrackIds next;
+
+    for(auto it = std::next(lists.cbegin()); it != lists.cend() && !result.empty(); ++it) {
+        next.clear();
+        std::ranges::set_intersection(result, **it, std::back_inserter(next));
+        result.swap(next);
+    }
+
+    return result;
+}
+} // namespace
+
+namespace Fooyin {
+struct TrackSearchIndex::Private
+{
+    // A change which has been queued but not yet applied to the postings
+    struct PendingChange
+    {
+        Track track;
+        bool removed{false};
+        int count{0};
+    };
+
+    mutable std::shared_mutex mutex;
+    std::unordered_map<Trigram, TrackIds> postings;
+    // The indexed version of each track, so its trigrams can be found again when it changes
+    std::unordered_map<int, Track> tracks;
+    std::unordered_map<int, PendingChange> pending;
+    bool built{false};
+
+    QFuture<void> updateQueue;
+
+    template <typename Func>
+    void enqueue(Func&& func)
+    {
+        if(updateQueue.isFinished()) {
+            updateQueue = Utils::asyncExec(std::forward<Func>(func));
+        }
+        else {
+            updateQueue = updateQueue.then(QtFuture::Launch::Async, std::forward<Func>(func));
+        }
+    }
+
+    // Records the changes straight away, so candidates() can include them before they're indexed
+    void queueChanges(const TrackList& changedTracks, bool removed)
+    {
+        const std::unique_lock lock{mutex};
+        for(const Track& track : changedTracks) {
+            if(track.id() >= 0) {
+                PendingChange& change = pending[track.id()];
+                change.track          = track;
+                change.removed        = removed;
+                ++change.count;
+            }
+        }
+    }
+
+    // Must be called with the lock held, once the changes to changedTracks have been indexed
+    void finishChanges(const TrackList& changedTracks)
+    {
+        for(const Track& track : changedTracks) {
+            const auto changeIt = pending.find(track.id());
+            if(changeIt != pending.end() && --changeIt->second.count <= 0) {
+                pending.erase(changeIt);
+            }
+        }
+    }
+
+    void removeTrack(int id)
+    {
+        const auto trackIt = tracks.find(id);
+        if(trackIt == tracks.end()) {
+            return;
+        }
+
+        for(const Trigram trigram : trigramsForTrack(trackIt->second)) {
+            const auto postingIt = postings.find(trigram);
+            if(postingIt != postings.end()) {
+                eraseSorted(postingIt->second, id);
+                if(postingIt->second.empty()) {
+                    postings.erase(postingIt);
+                }
+            }
+        }
+
+        tracks.erase(trackIt);
+    }
+
+    void addTracks(const TrackList& tracksToAdd)
+    {
+        std::vector<std::pair<Track, Trigrams>> indexed;
+        indexed.reserve(tracksToAdd.size());
+
+        for(const Track& track : tracksToAdd) {
+            if(track.id() >= 0) {
+                indexed.emplace_back(track, trigramsForTrack(track));
+            }
+        }
+
+        const std::unique_lock lock{mutex};
+
+        for(const auto& [track, trigrams] : indexed) {
+            removeTrack(track.id());
+            for(const Trigram trigram : trigrams) {
+                insertSorted(postings[trigram], track.id());
+            }
+            tracks.emplace(track.id(), track);
+        }
+
+        finishChanges(tracksToAdd);
+    }
+
+    // Must be called with the lock held
+    std::optional<TrackIds> indexedCandidates(const QString& search) const
+    {
+        Trigrams trigrams;
+        addTrigrams(search, trigrams);
+
+        if(trigrams.empty() || !built) {
+            return {};
+        }
+
+        trigrams = uniqueTrigrams(std::move(trigrams));
+
+        std::vector<const TrackIds*> lists;
+        lists.reserve(trigrams.size());
+
+        for(const Trigram trigram : trigrams) {
+            const auto postingIt = postings.find(trigram);
+            if(postingIt == postings.cend()) {
+                return TrackIds{};
+            }
+            lists.push_back(&postingIt->second);
+        }
+
+        return intersect(std::move(lists));
+    }
+};
+
+TrackSearchIndex::TrackSearchIndex()
+    : p{std::make_unique<Private>()}
+{ }
+
+TrackSearchIndex::~TrackSearchIndex()
+{
+    p->updateQueue.waitForFinished();
+}
+
+void TrackSearchIndex::build(const TrackList& tracks)
+{
+    p->enqueue([this, tracks]() {
+        std::unordered_map<Trigram, TrackIds> postings;
+        std::unordered_map<int, Track> indexedTracks;
+        indexedTracks.reserve(tracks.size());
+
+        for(const Track& track : tracks) {
+            const int id = track.id();
+            if(id < 0) {
+                continue;
+            }
+            for(const Trigram trigram : trigramsForTrack(track)) {
+                postings[trigram].push_back(id);
+            }
+            indexedTracks.insert_or_assign(id, track);
+        }
+
+        for(auto& ids : postings | std::views::values) {
+            std::ranges::sort(ids);
+            const auto [first, last] = std::ranges::unique(ids);
+            ids.erase(first, last);
+        }
+
+        const std::unique_lock lock{p->mutex};
+        p->postings = std::move(postings);
+        p->tracks   = std::move(indexedTracks);
+        p->built    = true;
+    });
+}
+
+void TrackSearchIndex::addTracks(const TrackList& tracks)
+{
+    if(!tracks.empty()) {
+        p->queueChanges(tracks, false);
+        p->enqueue([this, tracks]() { p->addTracks(tracks); });
+    }
+}
+
+void TrackSearchIndex::updateTracks(const TrackList& tracks)
+{
+    addTracks(tracks);
+}
+
+void TrackSearchIndex::removeTracks(const TrackList& tracks)
+{
+    if(tracks.empty()) {
+        return;
+    }
+
+    p->queueChanges(tracks, true);
+    p->enqueue([this, tracks]() {
+        const std::unique_lock lock{p->mutex};
+        for(const Track& track : tracks) {
+            p->removeTrack(track.id());
+        }
+        p->finishChanges(tracks);
+    });
+}
+
+void TrackSearchIndex::waitForUpdates() const
+{
+    p->updateQueue.waitForFinished();
+}
+
+std::optional<TrackIds> TrackSearchIndex::candidates(const QString& search) const
+{
+    const std::shared_lock lock{p->mutex};
+
+    auto indexed = p->indexedCandidates(search);
+    if(!indexed || p->pending.empty()) {
+        return indexed;
+    }
+
+    // Tracks with queued changes may match once indexed, so include them all
+    TrackIds pendingIds;
+    pendingIds.reserve(p->pending.size());
+    std::ranges::copy(p->pending | std::views::keys, std::back_inserter(pendingIds));
+    std::ranges::sort(pendingIds);
+
+    TrackIds merged;
+    merged.reserve(indexed->size() + pendingIds.size());
+    std::ranges::set_union(*indexed, pendingIds, std::back_inserter(merged));
+
+    return merged;
+}
+
+std::optional<TrackList> TrackSearchIndex::candidateTracks(const QString& search) const
+{
+    const std::shared_lock lock{p->mutex};
+
+    const auto indexed = p->indexedCandidates(search);
+    if(!indexed) {
+        return {};
+    }
+
+    TrackList tracks;
+    tracks.reserve(indexed->size() + p->pending.size());
+
+    for(const int id : *indexed) {
+        if(!p->pending.contains(id)) {
+            tracks.push_back(p->tracks.at(id));
+        }
+    }
+
+    // Use the queued version of changed tracks, and leave out those about to be removed
+    for(const auto& change : p->pending | std::views::values) {
+        if(!change.removed) {
+            tracks.push_back(change.track);
+        }
+    }
+
+    return tracks;
+}
+} // namespace Fooyin
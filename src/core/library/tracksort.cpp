@@ -22,6 +22,7 @@
 #include <core/scripting/scriptparser.h>
 #include <core/track.h>
 
+#include <numeric>
 #include <ranges>
 
 #include <QCollator>
@@ -33,9 +34,72 @@ Fooyin::ParsedScript parseScript(const QString& sort)
 
     return parser.parse(sort);
 }
+
+QCollator sortCollator()
+{
+    QCollator collator;
+    collator.setNumericMode(true);
+    return collator;
+}
+
+bool lessThan(const QCollator& collator, const QString& lhs, const QString& rhs, Qt::SortOrder order)
+{
+    const auto cmp = collator.compare(lhs, rhs);
+
+    if(cmp == 0) {
+        return false;
+    }
+    if(order == Qt::AscendingOrder) {
+        return cmp < 0;
+    }
+    return cmp > 0;
+}
+
+Fooyin::TrackList applyPermutation(const Fooyin::TrackList& tracks, const std::vector<int>& permutation)
+{
+    Fooyin::TrackList sortedTracks;
+    sortedTracks.reserve(permutation.size());
+
+    for(const int index : permutation) {
+        sortedTracks.push_back(tracks.at(index));
+    }
+
+    return sortedTracks;
+}
 } // namespace
 
 namespace Fooyin::Sorting {
+SortKeys calcSortKeys(const QString& sort, const TrackList& tracks)
+{
+    return calcSortKeys(parseScript(sort), tracks);
+}
+
+SortKeys calcSortKeys(const ParsedScript& sortScript, const TrackList& tracks)
+{
+    static ScriptParser parser;
+
+    SortKeys keys;
+    keys.reserve(tracks.size());
+
+    for(const Track& track : tracks) {
+        keys.push_back(parser.evaluate(sortScript, track));
+    }
+    return keys;
+}
+
+std::vector<int> sortIndexes(const SortKeys& keys, Qt::SortOrder order)
+{
+    std::vector<int> indexes(keys.size());
+    std::iota(indexes.begin(), indexes.end(), 0);
+
+    const QCollator collator = sortCollator();
+
+    std::ranges::stable_sort(indexes, [&keys, &collator, order](int lhs, int rhs) {
+        return lessThan(collator, keys.at(lhs), keys.at(rhs), order);
+    });
+    return indexes;
+}
+
 TrackList calcSortFields(const QString& sort, const TrackList& tracks)
 {
     return calcSortFields(parseScript(sort), tracks);
@@ -56,19 +120,10 @@ TrackList sortTracks(const TrackList& tracks, Qt::SortOrder order)
 {
     TrackList sortedTracks{tracks};
 
-    QCollator collator;
-    collator.setNumericMode(true);
-
-    std::ranges::sort(sortedTracks, [order, collator](const Track& lhs, const Track& rhs) {
-        const auto cmp = collator.compare(lhs.sort(), rhs.sort());
+    const QCollator collator = sortCollator();
 
-        if(cmp == 0) {
-            return false;
-        }
-        if(order == Qt::AscendingOrder) {
-            return cmp < 0;
-        }
-        return cmp > 0;
+    std::ranges::stable_sort(sortedTracks, [&collator, order](const Track& lhs, const Track& rhs) {
+        return lessThan(collator, lhs.sort(), rhs.sort(), order);
     });
     return sortedTracks;
 }
@@ -86,8 +141,8 @@ TrackList calcSortTracks(const QString& sort, const TrackList& tracks, const std
 
 TrackList calcSortTracks(const ParsedScript& sortScript, const TrackList& tracks, Qt::SortOrder order)
 {
-    const TrackList calcTracks = calcSortFields(sortScript, tracks);
-    return sortTracks(calcTracks, order);
+    const SortKeys keys = calcSortKeys(sortScript, tracks);
+    return applyPermutation(tracks, sortIndexes(keys, order));
 }
 
 TrackList calcSortTracks(const ParsedScript& sortScript, const TrackList& tracks, const std::vector<int>& indexes,
@@ -104,11 +159,11 @@ TrackList calcSortTracks(const ParsedScript& sortScript, const TrackList& tracks
         tracksToSort.push_back(tracks.at(index));
     }
 
-    const TrackList calcTracks      = calcSortFields(sortScript, tracksToSort);
-    const TrackList sortedSubTracks = sortTracks(calcTracks, order);
+    const SortKeys keys                = calcSortKeys(sortScript, tracksToSort);
+    const std::vector<int> permutation = sortIndexes(keys, order);
 
     for(auto i{0}; const int index : validIndexes) {
-        sortedTracks[index] = sortedSubTracks.at(i++);
+        sortedTracks[index] = tracksToSort.at(permutation.at(i++));
     }
 
     return sortedTracks;
@@ -23,25 +23,56 @@
 #include "library/libraryinfo.h"
 #include "library/librarymanager.h"
 #include "librarythreadhandler.h"
+#include "tagging/tagreader.h"
 
 #include <core/coresettings.h>
+#include <core/library/tracksearchindex.h>
 #include <core/library/tracksort.h>
 #include <utils/async.h>
 #include <utils/settings/settingsmanager.h>
+#include <utils/stringpool.h>
+
+#include <QElapsedTimer>
+#include <QTimer>
 
 #include <ranges>
 
 using namespace std::chrono_literals;
 
+constexpr auto PruneInterval         = 5s;
+constexpr auto CoverLocationInterval = 2s;
+
 namespace {
-QFuture<Fooyin::TrackList> recalSortTracks(const QString& sort, const Fooyin::TrackList& tracks)
+// Sort keys are kept alongside the library's tracks rather than on each track, so later additions can be merged
+struct SortedTracks
+{
+    Fooyin::TrackList tracks;
+    Fooyin::Sorting::SortKeys keys;
+};
+
+SortedTracks applySortOrder(const Fooyin::TrackList& tracks, const Fooyin::Sorting::SortKeys& keys)
+{
+    SortedTracks sorted;
+    sorted.tracks.reserve(tracks.size());
+    sorted.keys.reserve(keys.size());
+
+    for(const int index : Fooyin::Sorting::sortIndexes(keys)) {
+        sorted.tracks.push_back(tracks.at(index));
+        sorted.keys.push_back(keys.at(index));
+    }
+
+    return sorted;
+}
+
+QFuture<SortedTracks> recalSortTracks(const QString& sort, const Fooyin::TrackList& tracks)
 {
-    return Fooyin::Utils::asyncExec([sort, tracks]() { return Fooyin::Sorting::calcSortTracks(sort, tracks); });
+    return Fooyin::Utils::asyncExec(
+        [sort, tracks]() { return applySortOrder(tracks, Fooyin::Sorting::calcSortKeys(sort, tracks)); });
 }
 
-QFuture<Fooyin::TrackList> resortTracks(const Fooyin::TrackList& tracks)
+QFuture<SortedTracks> resortTracks(const Fooyin::TrackList& tracks, const Fooyin::Sorting::SortKeys& keys)
 {
-    return Fooyin::Utils::asyncExec([tracks]() { return Fooyin::Sorting::sortTracks(tracks); });
+    return Fooyin::Utils::asyncExec([tracks, keys]() { return applySortOrder(tracks, keys); });
 }
 } // namespace
 
@@ -57,7 +88,15 @@ struct UnifiedMusicLibrary::Private
     LibraryThreadHandler threadHandler;
 
     TrackList tracks;
+    Sorting::SortKeys sortKeys; // Parallel to tracks
+    int resortGeneration{0};
+    std::unordered_map<int, Track> idIndex;
+    TrackSearchIndex searchIndex;
     std::unordered_map<QString, Track> pendingStatUpdates;
+    QTimer* pruneTimer;
+    QFuture<void> pruneFuture;
+    std::unordered_map<int, Track::CoverLocations> pendingCoverLocations;
+    QTimer* coverLocationTimer;
 
     Private(UnifiedMusicLibrary* self_, LibraryManager* libraryManager_, DbConnectionPoolPtr dbPool_,
             SettingsManager* settings_)
@@ -66,7 +105,17 @@ struct UnifiedMusicLibrary::Private
         , dbPool{std::move(dbPool_)}
         , settings{settings_}
         , threadHandler{dbPool, self, settings}
-    { }
+        , pruneTimer{new QTimer(self)}
+        , coverLocationTimer{new QTimer(self)}
+    {
+        pruneTimer->setSingleShot(true);
+        pruneTimer->setInterval(PruneInterval);
+        QObject::connect(pruneTimer, &QTimer::timeout, self, [this]() { pruneStrings(); });
+
+        coverLocationTimer->setSingleShot(true);
+        coverLocationTimer->setInterval(CoverLocationInterval);
+        QObject::connect(coverLocationTimer, &QTimer::timeout, self, [this]() { saveCoverLocations(); });
+    }
 
     void loadTracks(const TrackList& trackToLoad)
     {
@@ -75,10 +124,16 @@ struct UnifiedMusicLibrary::Private
             return;
         }
 
+        QElapsedTimer timer;
+        timer.start();
+
         auto sortTracks = recalSortTracks(settings->value<Settings::Core::LibrarySortScript>(), trackToLoad);
 
-        sortTracks.then(self, [this](const TrackList& sortedTracks) {
-            tracks = sortedTracks;
+        sortTracks.then(self, [this, timer](const SortedTracks& sorted) {
+            qDebug() << "[Library] Sorted" << sorted.tracks.size() << "tracks in" << timer.elapsed() << "ms";
+            tracks   = sorted.tracks;
+            sortKeys = sorted.keys;
+            rebuildIdIndex();
             emit self->tracksLoaded(tracks);
         });
     }
@@ -87,39 +142,81 @@ struct UnifiedMusicLibrary::Private
     {
         auto sortTracks = recalSortTracks(settings->value<Settings::Core::LibrarySortScript>(), newTracks);
 
-        return sortTracks.then(self, [this](const TrackList& sortedTracks) {
-            std::ranges::copy(sortedTracks, std::back_inserter(tracks));
+        return sortTracks.then(self, [this](const SortedTracks& sorted) { addSortedTracks(sorted); });
+    }
 
-            resortTracks(tracks).then(self, [this, sortedTracks](const TrackList& sortedLibraryTracks) {
-                tracks = sortedLibraryTracks;
-                emit self->tracksAdded(sortedTracks);
-            });
+    void addSortedTracks(const SortedTracks& sorted)
+    {
+        std::ranges::copy(sorted.tracks, std::back_inserter(tracks));
+        std::ranges::copy(sorted.keys, std::back_inserter(sortKeys));
+        for(const Track& track : sorted.tracks) {
+            idIndex.insert_or_assign(track.id(), track);
+        }
+
+        resortLibrary([this, sortedTracks = sorted.tracks]() { emit self->tracksAdded(sortedTracks); });
+    }
+
+    void rebuildIdIndex()
+    {
+        idIndex.clear();
+        idIndex.reserve(tracks.size());
+
+        for(const Track& track : tracks) {
+            idIndex.emplace(track.id(), track);
+        }
+    }
+
+    void resortLibrary(const std::function<void()>& onSorted)
+    {
+        const int generation = ++resortGeneration;
+
+        resortTracks(tracks, sortKeys).then(self, [this, generation, onSorted](const SortedTracks& sorted) {
+            // A newer resort was started from more recent tracks, so applying this one would drop changes
+            if(generation == resortGeneration) {
+                tracks   = sorted.tracks;
+                sortKeys = sorted.keys;
+            }
+            onSorted();
         });
     }
 
-    void updateLibraryTracks(const TrackList& updatedTracks)
+    void updateLibraryTracks(const SortedTracks& updatedTracks)
     {
-        for(const auto& track : updatedTracks) {
-            auto trackIt
-                = std::ranges::find_if(tracks, [&track](const Track& oldTrack) { return oldTrack.id() == track.id(); });
-            if(trackIt != tracks.end()) {
-                *trackIt = track;
-                trackIt->clearWasModified();
+        std::unordered_map<int, size_t> updatedIndexes;
+        for(size_t i{0}; i < updatedTracks.tracks.size(); ++i) {
+            const int id = updatedTracks.tracks.at(i).id();
+            if(idIndex.contains(id)) {
+                updatedIndexes.emplace(id, i);
             }
         }
+
+        if(updatedIndexes.empty()) {
+            return;
+        }
+
+        // One pass over the library, rather than a search for each updated track
+        for(size_t i{0}; i < tracks.size(); ++i) {
+            const auto updatedIt = updatedIndexes.find(tracks.at(i).id());
+            if(updatedIt == updatedIndexes.cend()) {
+                continue;
+            }
+
+            Track& track = tracks.at(i);
+            track        = updatedTracks.tracks.at(updatedIt->second);
+            track.clearWasModified();
+            sortKeys[i] = updatedTracks.keys.at(updatedIt->second);
+            idIndex.insert_or_assign(track.id(), track);
+        }
     }
 
     QFuture<void> updateTracks(const TrackList& tracksToUpdate)
     {
         auto sortTracks = recalSortTracks(settings->value<Settings::Core::LibrarySortScript>(), tracksToUpdate);
 
-        return sortTracks.then(self, [this](const TrackList& sortedTracks) {
-            updateLibraryTracks(sortedTracks);
+        return sortTracks.then(self, [this](const SortedTracks& sorted) {
+            updateLibraryTracks(sorted);
 
-            resortTracks(tracks).then(self, [this, sortedTracks](const TrackList& sortedLibraryTracks) {
-                tracks = sortedLibraryTracks;
-                emit self->tracksUpdated(sortedTracks);
-            });
+            resortLibrary([this, sortedTracks = sorted.tracks]() { emit self->tracksUpdated(sortedTracks); });
         });
     }
 
@@ -127,13 +224,10 @@ struct UnifiedMusicLibrary::Private
     {
         auto sortTracks = recalSortTracks(settings->value<Settings::Core::LibrarySortScript>(), tracksToUpdate);
 
-        return sortTracks.then(self, [this](const TrackList& sortedTracks) {
-            updateLibraryTracks(sortedTracks);
+        return sortTracks.then(self, [this](const SortedTracks& sorted) {
+            updateLibraryTracks(sorted);
 
-            resortTracks(tracks).then(self, [this, sortedTracks](const TrackList& sortedLibraryTracks) {
-                tracks = sortedLibraryTracks;
-                emit self->tracksPlayed(sortedTracks);
-            });
+            resortLibrary([this, sortedTracks = sorted.tracks]() { emit self->tracksPlayed(sortedTracks); });
         });
     }
 
@@ -155,10 +249,9 @@ struct UnifiedMusicLibrary::Private
     {
         auto sortTracks = recalSortTracks(settings->value<Settings::Core::LibrarySortScript>(), tracksScanned);
 
-        sortTracks.then(self, [this, id](const TrackList& scannedTracks) {
-            addTracks(scannedTracks).then(self, [this, id, scannedTracks]() {
-                emit self->tracksScanned(id, scannedTracks);
-            });
+        sortTracks.then(self, [this, id](const SortedTracks& sorted) {
+            addSortedTracks(sorted);
+            emit self->tracksScanned(id, sorted.tracks);
         });
     }
 
@@ -169,23 +262,28 @@ struct UnifiedMusicLibrary::Private
         }
 
         TrackList newTracks;
+        Sorting::SortKeys newKeys;
         TrackList removedTracks;
         TrackList updatedTracks;
 
-        for(auto& track : tracks) {
+        for(size_t i{0}; i < tracks.size(); ++i) {
+            Track& track = tracks.at(i);
             if(track.libraryId() == id) {
                 if(tracksRemoved.contains(track.id())) {
                     removedTracks.push_back(track);
+                    idIndex.erase(track.id());
                     continue;
                 }
                 track.setLibraryId(-1);
+                idIndex.insert_or_assign(track.id(), track);
                 updatedTracks.push_back(track);
-                newTracks.push_back(track);
             }
             newTracks.push_back(track);
+            newKeys.push_back(sortKeys.at(i));
         }
 
-        tracks = newTracks;
+        tracks   = newTracks;
+        sortKeys = newKeys;
 
         threadHandler.libraryRemoved(id);
 
@@ -193,6 +291,52 @@ struct UnifiedMusicLibrary::Private
         emit self->tracksUpdated(updatedTracks);
     }
 
+    void pruneStrings()
+    {
+        if(pruneFuture.isRunning()) {
+            pruneTimer->start();
+            return;
+        }
+
+        pruneFuture = Utils::asyncExec([]() { StringPool::shared().prune(); });
+    }
+
+    void coverLocated(const Track& track)
+    {
+        const auto trackIt = idIndex.find(track.id());
+        // The file may have been rescanned since the cover was read
+        if(trackIt == idIndex.cend() || trackIt->second.modifiedTime() != track.modifiedTime()) {
+            return;
+        }
+
+        pendingCoverLocations.insert_or_assign(track.id(), track.coverLocations());
+        coverLocationTimer->start();
+    }
+
+    void saveCoverLocations()
+    {
+        if(pendingCoverLocations.empty()) {
+            return;
+        }
+
+        TrackList locatedTracks;
+
+        for(Track& track : tracks) {
+            const auto locationIt = pendingCoverLocations.find(track.id());
+            if(locationIt != pendingCoverLocations.cend()) {
+                track.setCoverLocations(locationIt->second);
+                idIndex.insert_or_assign(track.id(), track);
+                locatedTracks.push_back(track);
+            }
+        }
+
+        pendingCoverLocations.clear();
+
+        if(!locatedTracks.empty()) {
+            threadHandler.saveCoverLocations(locatedTracks);
+        }
+    }
+
     void libraryStatusChanged(const LibraryInfo& library) const
     {
         libraryManager->updateLibraryStatus(library);
@@ -200,8 +344,9 @@ struct UnifiedMusicLibrary::Private
 
     void changeSort(const QString& sort)
     {
-        recalSortTracks(sort, tracks).then(self, [this](const TrackList& sortedTracks) {
-            tracks = sortedTracks;
+        recalSortTracks(sort, tracks).then(self, [this](const SortedTracks& sorted) {
+            tracks   = sorted.tracks;
+            sortKeys = sorted.keys;
             emit self->tracksSorted(tracks);
         });
     }
@@ -217,6 +362,8 @@ UnifiedMusicLibrary::UnifiedMusicLibrary(LibraryManager* libraryManager, DbConne
             [this](int id, const std::set<int>& tracksRemoved) { p->removeLibrary(id, tracksRemoved); });
 
     connect(&p->threadHandler, &LibraryThreadHandler::progressChanged, this, &UnifiedMusicLibrary::scanProgress);
+    connect(&p->threadHandler, &LibraryThreadHandler::writeProgress, this, &UnifiedMusicLibrary::writeProgress);
+    connect(&p->threadHandler, &LibraryThreadHandler::writeFinished, this, &UnifiedMusicLibrary::writeFinished);
 
     connect(&p->threadHandler, &LibraryThreadHandler::statusChanged, this,
             [this](const LibraryInfo& library) { p->libraryStatusChanged(library); });
@@ -232,6 +379,21 @@ UnifiedMusicLibrary::UnifiedMusicLibrary(LibraryManager* libraryManager, DbConne
     p->settings->subscribe<Settings::Core::LibrarySortScript>(this,
                                                               [this](const QString& sort) { p->changeSort(sort); });
 
+    connect(this, &MusicLibrary::tracksLoaded, this,
+            [this](const TrackList& tracks) { p->searchIndex.build(tracks); });
+    connect(this, &MusicLibrary::tracksAdded, this,
+            [this](const TrackList& tracks) { p->searchIndex.addTracks(tracks); });
+    connect(this, &MusicLibrary::tracksUpdated, this,
+            [this](const TrackList& tracks) { p->searchIndex.updateTracks(tracks); });
+    connect(this, &MusicLibrary::tracksDeleted, this,
+            [this](const TrackList& tracks) { p->searchIndex.removeTracks(tracks); });
+
+    // Delayed so views have released replaced or removed tracks before their strings are pruned
+    connect(this, &MusicLibrary::tracksLoaded, p->pruneTimer, qOverload<>(&QTimer::start));
+    connect(this, &MusicLibrary::tracksUpdated, p->pruneTimer, qOverload<>(&QTimer::start));
+    connect(this, &MusicLibrary::tracksDeleted, p->pruneTimer, qOverload<>(&QTimer::start));
+    connect(&p->threadHandler, &LibraryThreadHandler::scanFinished, p->pruneTimer, qOverload<>(&QTimer::start));
+
     connect(
         this, &MusicLibrary::tracksLoaded, this,
         [this]() {
@@ -245,10 +407,20 @@ UnifiedMusicLibrary::UnifiedMusicLibrary(LibraryManager* libraryManager, DbConne
 
     p->settings->subscribe<Settings::Core::Internal::MonitorLibraries>(
         this, [this](bool enabled) { p->threadHandler.setupWatchers(p->libraryManager->allLibraries(), enabled); });
+
+    // Store covers located on first read, so they don't need to be searched for again after a restart
+    Tagging::setCoverLocatedHandler([this](const Track& track) {
+        if(track.isInDatabase()) {
+            QMetaObject::invokeMethod(this, [this, track]() { p->coverLocated(track); });
+        }
+    });
 }
 
 UnifiedMusicLibrary::~UnifiedMusicLibrary()
 {
+    Tagging::setCoverLocatedHandler({});
+    p->saveCoverLocations();
+
     if(!p->pendingStatUpdates.empty()) {
         TrackList tracksToUpdate;
         for(const Track& track : p->pendingStatUpdates | std::views::values) {
@@ -302,19 +474,23 @@ TrackList UnifiedMusicLibrary::tracksForIds(const TrackIds& ids) const
     tracks.reserve(ids.size());
 
     for(const int id : ids) {
-        auto trackIt
-            = std::ranges::find_if(std::as_const(p->tracks), [id](const Track& track) { return track.id() == id; });
-        if(trackIt != p->tracks.cend()) {
-            tracks.push_back(*trackIt);
+        const auto trackIt = p->idIndex.find(id);
+        if(trackIt != p->idIndex.cend()) {
+            tracks.push_back(trackIt->second);
         }
     }
 
     return tracks;
 }
 
-void UnifiedMusicLibrary::updateTrackMetadata(const TrackList& tracks)
+const TrackSearchIndex& UnifiedMusicLibrary::searchIndex() const
+{
+    return p->searchIndex;
+}
+
+WriteRequest UnifiedMusicLibrary::updateTrackMetadata(const TrackList& tracks)
 {
-    p->threadHandler.saveUpdatedTracks(tracks);
+    return p->threadHandler.saveUpdatedTracks(tracks);
 }
 
 void UnifiedMusicLibrary::updateTrackStats(const Track& track)
@@ -47,8 +47,9 @@ public:
 
     [[nodiscard]] TrackList tracks() const override;
     [[nodiscard]] TrackList tracksForIds(const TrackIds& ids) const override;
+    [[nodiscard]] const TrackSearchIndex& searchIndex() const override;
 
-    void updateTrackMetadata(const TrackList& tracks) override;
+    WriteRequest updateTrackMetadata(const TrackList& tracks) override;
     void updateTrackStats(const Track& track) override;
 
     void trackWasPlayed(const Track& track);
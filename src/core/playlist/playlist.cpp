@@ -91,67 +91,88 @@ struct Playlist::Private
         }
     }
 
-    int getRandomIndex(PlayModes mode)
+    [[nodiscard]] int shuffledIndex(int& index, PlayModes mode) const
     {
-        if(shuffleOrder.empty()) {
-            createShuffleOrder();
-
-            shuffleIndex = (mode & RepeatTrack) ? 0 : 1;
-        }
-
-        else if(mode & RepeatPlaylist) {
-            if(shuffleIndex > static_cast<int>(shuffleOrder.size() - 1)) {
-                shuffleIndex = 0;
+        if(mode & RepeatPlaylist) {
+            if(index > static_cast<int>(shuffleOrder.size() - 1)) {
+                index = 0;
             }
-            else if(shuffleIndex < 0) {
-                shuffleIndex = static_cast<int>(shuffleOrder.size() - 1);
+            else if(index < 0) {
+                index = static_cast<int>(shuffleOrder.size() - 1);
             }
         }
 
-        if(shuffleIndex >= 0 && shuffleIndex < static_cast<int>(shuffleOrder.size())) {
-            return shuffleOrder.at(shuffleIndex);
+        if(index >= 0 && index < static_cast<int>(shuffleOrder.size())) {
+            return shuffleOrder.at(index);
         }
 
         return -1;
     }
 
-    int getNextIndex(int delta, PlayModes mode)
+    // Finds the next index without moving the playback position, setting @p nextShuffleIndex to the position it
+    // would move to. The shuffle order is created if needed, so a later change agrees with the prediction.
+    int findNextIndex(int delta, PlayModes mode, int& nextShuffleIndex)
     {
+        nextShuffleIndex = shuffleIndex;
+
         if(tracks.empty()) {
             return -1;
         }
 
-        int nextIndex = currentTrackIndex;
-
-        if(nextTrackIndex >= 0) {
-            nextIndex      = nextTrackIndex;
-            nextTrackIndex = -1;
+        if(nextTrackIndex >= 0 && delta > 0) {
+            if((mode & ShuffleTracks) && !(mode & RepeatTrack) && !shuffleOrder.empty()) {
+                int followingIndex = shuffleIndex + 1;
+                if(shuffledIndex(followingIndex, mode) == nextTrackIndex) {
+                    // Scheduled from the shuffle order, so move along it
+                    nextShuffleIndex = followingIndex;
+                }
+            }
+            return nextTrackIndex;
         }
-        else {
-            const int count = static_cast<int>(tracks.size());
 
-            if(mode & ShuffleTracks) {
-                if(!(mode & RepeatTrack)) {
-                    shuffleIndex += delta;
-                }
-                nextIndex = getRandomIndex(mode);
+        const int count = static_cast<int>(tracks.size());
+        int nextIndex   = currentTrackIndex;
+
+        if(mode & ShuffleTracks) {
+            if(shuffleOrder.empty()) {
+                createShuffleOrder();
+                // The current track was moved to the start
+                shuffleIndex     = 0;
+                nextShuffleIndex = (mode & RepeatTrack) ? 0 : 1;
             }
-            else if(mode & RepeatPlaylist) {
-                nextIndex += delta;
-                if(nextIndex < 0) {
-                    nextIndex = count - 1;
-                }
-                else if(nextIndex >= count) {
-                    nextIndex = 0;
-                }
+            else if(!(mode & RepeatTrack)) {
+                nextShuffleIndex += delta;
             }
-            else if(mode == Default) {
-                nextIndex += delta;
-                if(nextIndex < 0 || nextIndex >= count) {
-                    nextIndex = -1;
-                }
+            nextIndex = shuffledIndex(nextShuffleIndex, mode);
+        }
+        else if(mode & RepeatPlaylist) {
+            nextIndex += delta;
+            if(nextIndex < 0) {
+                nextIndex = count - 1;
+            }
+            else if(nextIndex >= count) {
+                nextIndex = 0;
             }
         }
+        else if(mode == Default) {
+            nextIndex += delta;
+            if(nextIndex < 0 || nextIndex >= count) {
+                nextIndex = -1;
+            }
+        }
+
+        return nextIndex;
+    }
+
+    int getNextIndex(int delta, PlayModes mode)
+    {
+        int nextShuffleIndex{-1};
+        const int nextIndex = findNextIndex(delta, mode, nextShuffleIndex);
+        shuffleIndex        = nextShuffleIndex;
+
+        if(delta > 0) {
+            nextTrackIndex = -1;
+        }
 
         return nextIndex;
     }
@@ -248,7 +269,8 @@ void Playlist::scheduleNextIndex(int index)
 
 Track Playlist::nextTrack(int delta, PlayModes mode)
 {
-    const int index = p->getNextIndex(delta, mode);
+    int nextShuffleIndex{-1};
+    const int index = p->findNextIndex(delta, mode, nextShuffleIndex);
 
     if(index < 0) {
         return {};
@@ -259,6 +281,21 @@ Track Playlist::nextTrack(int delta, PlayModes mode)
     return p->tracks.at(index);
 }
 
+Track Playlist::scheduleNextTrack(PlayModes mode)
+{
+    int nextShuffleIndex{-1};
+    const int index = p->findNextIndex(1, mode, nextShuffleIndex);
+
+    if(index < 0) {
+        return {};
+    }
+
+    p->nextTrackIndex = index;
+    p->readTrack(index);
+
+    return p->tracks.at(index);
+}
+
 Track Playlist::nextTrackChange(int delta, PlayModes mode)
 {
     const int index = p->getNextIndex(delta, mode);
@@ -281,6 +318,7 @@ void Playlist::changeCurrentIndex(int index)
 void Playlist::reset()
 {
     p->shuffleOrder.clear();
+    p->nextTrackIndex = -1;
 }
 
 void Playlist::resetFlags()
@@ -380,6 +418,12 @@ std::vector<int> Playlist::removeTracks(const std::vector<int>& indexes)
     if(indexesToRemove.contains(p->nextTrackIndex)) {
         p->nextTrackIndex = -1;
     }
+    else if(p->nextTrackIndex >= 0) {
+        // Keep the scheduled track as rows before it are removed
+        const int nextIndex = p->nextTrackIndex;
+        p->nextTrackIndex -= static_cast<int>(std::ranges::count_if(
+            indexesToRemove, [nextIndex](const int index) { return index >= 0 && index < nextIndex; }));
+    }
 
     p->tracksModified = true;
 
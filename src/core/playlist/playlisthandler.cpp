@@ -20,15 +20,23 @@
 #include <core/playlist/playlisthandler.h>
 
 #include "database/playlistdatabase.h"
+#include "database/trackdatabase.h"
 #include "internalcoresettings.h"
 
 #include <core/coresettings.h>
+#include <core/library/musiclibrary.h>
 #include <core/player/playercontroller.h>
 #include <core/playlist/playlist.h>
+#include <utils/async.h>
+#include <utils/database/dbconnectionhandler.h>
 #include <utils/helpers.h>
 #include <utils/settings/settingsmanager.h>
 
+#include <QElapsedTimer>
+
 #include <ranges>
+#include <set>
+#include <unordered_map>
 #include <utility>
 
 constexpr auto ActiveIndex = "Player/ActivePlaylistIndex";
@@ -66,6 +74,14 @@ std::vector<int> updateCommonTracks(Fooyin::TrackList& tracks, const Fooyin::Tra
     tracks = result;
     return indexes;
 }
+
+Fooyin::TrackIds trackIdsOf(const Fooyin::TrackList& tracks)
+{
+    Fooyin::TrackIds ids;
+    ids.reserve(tracks.size());
+    std::ranges::transform(tracks, std::back_inserter(ids), [](const Fooyin::Track& track) { return track.id(); });
+    return ids;
+}
 } // namespace
 
 namespace Fooyin {
@@ -74,6 +90,7 @@ struct PlaylistHandler::Private
     PlaylistHandler* self;
 
     DbConnectionPoolPtr dbPool;
+    MusicLibrary* library;
     PlayerController* playerController;
     SettingsManager* settings;
     PlaylistDatabase playlistConnector;
@@ -84,10 +101,24 @@ struct PlaylistHandler::Private
     Playlist* activePlaylist{nullptr};
     Playlist* scheduledPlaylist{nullptr};
 
-    Private(PlaylistHandler* self_, DbConnectionPoolPtr dbPool_, PlayerController* playerController_,
-            SettingsManager* settings_)
+    // Set once playlistsPopulated has been emitted
+    bool restored{false};
+    // Set once the library has loaded, after which playlists are loaded as they're needed
+    bool libraryLoaded{false};
+    // Db ids of saved playlists whose tracks haven't been loaded from the library yet
+    std::set<int> unloadedPlaylists;
+    // Track ids of playlists being loaded, as they were when the load started
+    std::unordered_map<int, TrackIds> loadingPlaylists;
+    // Loads requested before the library had loaded
+    std::vector<int> requestedPlaylists;
+    // Track ids of playlists read straight from the db before the library had loaded
+    std::unordered_map<int, TrackIds> preloadedPlaylists;
+
+    Private(PlaylistHandler* self_, DbConnectionPoolPtr dbPool_, MusicLibrary* library_,
+            PlayerController* playerController_, SettingsManager* settings_)
         : self{self_}
         , dbPool{std::move(dbPool_)}
+        , library{library_}
         , playerController{playerController_}
         , settings{settings_}
     {
@@ -101,6 +132,201 @@ struct PlaylistHandler::Private
 
         for(const auto& info : infos) {
             playlists.emplace_back(Playlist::create(info.dbId, info.name, info.index));
+            unloadedPlaylists.emplace(info.dbId);
+        }
+    }
+
+    void emitAllTracksChanged(Playlist* playlist)
+    {
+        std::vector<int> changedIndexes(static_cast<size_t>(playlist->trackCount()));
+        std::iota(changedIndexes.begin(), changedIndexes.end(), 0);
+
+        emit self->playlistTracksChanged(playlist, changedIndexes);
+    }
+
+    void preloadActivePlaylist()
+    {
+        const int activeId = settings->value<Settings::Core::ActivePlaylistId>();
+        if(!self->playlistByDbId(activeId)) {
+            return;
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+
+        // Read the active playlist straight from the db so it can be shown before the library has loaded
+        Utils::asyncExec([pool = dbPool, activeId]() {
+            const DbConnectionHandler dbHandler{pool};
+            TrackDatabase trackDatabase;
+            trackDatabase.initialise(DbConnectionProvider{pool});
+            return trackDatabase.playlistTracks(activeId);
+        }).then(self, [this, activeId, timer](const TrackList& tracks) {
+            if(restored || libraryLoaded) {
+                return;
+            }
+
+            auto* playlist = self->playlistByDbId(activeId);
+            if(!playlist) {
+                return;
+            }
+
+            // Already read by ensureLoaded, and possibly modified since
+            if(!preloadedPlaylists.contains(activeId)) {
+                preloadPlaylist(playlist, tracks);
+            }
+
+            qDebug() << "[Playlist] Restored active playlist with" << tracks.size() << "tracks in" << timer.elapsed()
+                     << "ms";
+
+            restored = true;
+            restoreActivePlaylist();
+            emit self->playlistsPopulated();
+        });
+    }
+
+    void finishRestore()
+    {
+        if(!std::exchange(restored, true)) {
+            restoreActivePlaylist();
+            emit self->playlistsPopulated();
+        }
+    }
+
+    void preloadPlaylist(Playlist* playlist, const TrackList& tracks)
+    {
+        playlist->replaceTracks(tracks);
+        preloadedPlaylists.insert_or_assign(playlist->dbId(), trackIdsOf(tracks));
+    }
+
+    void populatePlaylist(int dbId, const TrackIds& trackIds)
+    {
+        unloadedPlaylists.erase(dbId);
+
+        auto* playlist = self->playlistByDbId(dbId);
+        if(!playlist) {
+            return;
+        }
+
+        const TrackList tracks = library->tracksForIds(trackIds);
+
+        if(const auto preloaded = preloadedPlaylists.extract(dbId)) {
+            if(trackIdsOf(playlist->tracks()) != preloaded.mapped()) {
+                // Changed since it was preloaded
+                return;
+            }
+            // Swap in the library's tracks, only notifying if the contents differ
+            const bool changed = trackIdsOf(tracks) != preloaded.mapped();
+            playlist->replaceTracks(tracks);
+            if(changed) {
+                emitAllTracksChanged(playlist);
+            }
+            return;
+        }
+
+        playlist->replaceTracks(tracks);
+        if(restored) {
+            emitAllTracksChanged(playlist);
+        }
+    }
+
+    void loadPlaylist(int dbId, bool restoreWhenLoaded = false)
+    {
+        if(!unloadedPlaylists.contains(dbId) || loadingPlaylists.contains(dbId)) {
+            if(restoreWhenLoaded) {
+                finishRestore();
+            }
+            return;
+        }
+
+        if(!libraryLoaded) {
+            requestedPlaylists.push_back(dbId);
+            return;
+        }
+
+        if(const auto* playlist = self->playlistByDbId(dbId)) {
+            loadingPlaylists.emplace(dbId, trackIdsOf(playlist->tracks()));
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+
+        Utils::asyncExec([pool = dbPool, dbId]() {
+            const DbConnectionHandler dbHandler{pool};
+            PlaylistDatabase playlistDatabase;
+            playlistDatabase.initialise(DbConnectionProvider{pool});
+            return playlistDatabase.getPlaylistTrackIds(dbId);
+        }).then(self, [this, dbId, restoreWhenLoaded, timer](const TrackIds& trackIds) {
+            const auto loading = loadingPlaylists.extract(dbId);
+
+            // May have been loaded synchronously in the meantime
+            if(unloadedPlaylists.contains(dbId)) {
+                auto* playlist = self->playlistByDbId(dbId);
+                if(playlist && loading && trackIdsOf(playlist->tracks()) != loading.mapped()) {
+                    // Changed while the ids were being read, so keep the changes
+                    unloadedPlaylists.erase(dbId);
+                    preloadedPlaylists.erase(dbId);
+                    refreshPlaylist(playlist);
+                }
+                else {
+                    populatePlaylist(dbId, trackIds);
+                    qDebug() << "[Playlist] Loaded playlist" << dbId << "with" << trackIds.size() << "tracks in"
+                             << timer.elapsed() << "ms";
+                }
+            }
+
+            if(restoreWhenLoaded) {
+                finishRestore();
+            }
+        });
+    }
+
+    // Used before modifying or playing a playlist, which needs its tracks straight away
+    void ensureLoaded(Playlist* playlist)
+    {
+        if(!playlist || !unloadedPlaylists.contains(playlist->dbId())) {
+            return;
+        }
+
+        if(!libraryLoaded) {
+            if(preloadedPlaylists.contains(playlist->dbId())) {
+                return;
+            }
+            // Ids can't be resolved until the library has loaded, so read the tracks straight from the db.
+            // Any changes made before then are kept when the playlist is populated.
+            TrackDatabase trackDatabase;
+            trackDatabase.initialise(DbConnectionProvider{dbPool});
+            preloadPlaylist(playlist, trackDatabase.playlistTracks(playlist->dbId()));
+            if(restored) {
+                emitAllTracksChanged(playlist);
+            }
+            return;
+        }
+
+        populatePlaylist(playlist->dbId(), playlistConnector.getPlaylistTrackIds(playlist->dbId()));
+    }
+
+    // Swaps in the library's current version of each track in a loaded playlist.
+    // The playlist's own ids are used rather than the saved ones, so unsaved changes are kept.
+    void refreshPlaylist(Playlist* playlist)
+    {
+        const TrackIds trackIds = trackIdsOf(playlist->tracks());
+        const TrackList tracks  = library->tracksForIds(trackIds);
+        const bool modified     = playlist->tracksModified();
+
+        playlist->replaceTracks(tracks);
+
+        if(trackIdsOf(tracks) == trackIds) {
+            playlist->setTracksModified(modified);
+        }
+        emitAllTracksChanged(playlist);
+    }
+
+    // The saved tracks of @p playlist are being replaced, so they no longer need loading
+    void markLoaded(const Playlist* playlist)
+    {
+        if(playlist) {
+            unloadedPlaylists.erase(playlist->dbId());
+            preloadedPlaylists.erase(playlist->dbId());
         }
     }
 
@@ -151,7 +377,7 @@ struct PlaylistHandler::Private
             return {};
         }
 
-        return activePlaylist->nextTrack(delta, playerController->playMode());
+        return playlist->nextTrack(delta, playerController->playMode());
     }
 
     void next()
@@ -280,10 +506,10 @@ struct PlaylistHandler::Private
     }
 };
 
-PlaylistHandler::PlaylistHandler(DbConnectionPoolPtr dbPool, PlayerController* playerController,
+PlaylistHandler::PlaylistHandler(DbConnectionPoolPtr dbPool, MusicLibrary* library, PlayerController* playerController,
                                  SettingsManager* settings, QObject* parent)
     : QObject{parent}
-    , p{std::make_unique<Private>(this, std::move(dbPool), playerController, settings)}
+    , p{std::make_unique<Private>(this, std::move(dbPool), library, playerController, settings)}
 {
     p->reloadPlaylists();
 
@@ -291,6 +517,8 @@ PlaylistHandler::PlaylistHandler(DbConnectionPoolPtr dbPool, PlayerController* p
         PlaylistHandler::createPlaylist(QStringLiteral("Default"), {});
     }
 
+    p->preloadActivePlaylist();
+
     QObject::connect(p->playerController, &PlayerController::nextTrack, this, [this]() { p->next(); });
     QObject::connect(p->playerController, &PlayerController::previousTrack, this, [this]() { p->previous(); });
 }
@@ -400,6 +628,7 @@ Playlist* PlaylistHandler::createPlaylist(const QString& name, const TrackList&
     auto* playlist   = p->addNewPlaylist(name);
 
     if(playlist) {
+        p->markLoaded(playlist);
         playlist->replaceTracks(tracks);
         if(isNew) {
             emit playlistAdded(playlist);
@@ -428,6 +657,7 @@ Playlist* PlaylistHandler::createTempPlaylist(const QString& name, const TrackLi
 void PlaylistHandler::appendToPlaylist(const Id& id, const TrackList& tracks)
 {
     if(auto* playlist = playlistById(id)) {
+        p->ensureLoaded(playlist);
         const int index = playlist->trackCount();
         playlist->appendTracks(tracks);
         emit playlistTracksAdded(playlist, tracks, index);
@@ -437,6 +667,7 @@ void PlaylistHandler::appendToPlaylist(const Id& id, const TrackList& tracks)
 void PlaylistHandler::replacePlaylistTracks(const Id& id, const TrackList& tracks)
 {
     if(auto* playlist = playlistById(id)) {
+        p->markLoaded(playlist);
         const auto size = tracks.empty() ? playlist->tracks().size() : tracks.size();
 
         playlist->replaceTracks(tracks);
@@ -462,6 +693,7 @@ void PlaylistHandler::movePlaylistTracks(const Id& id, const Id& replaceId)
 
     if(auto* playlist = playlistById(id)) {
         if(auto* replacePlaylist = playlistById(replaceId)) {
+            p->ensureLoaded(playlist);
             createPlaylist(replacePlaylist->name(), playlist->tracks());
             replacePlaylist->changeCurrentIndex(playlist->currentTrackIndex());
 
@@ -477,6 +709,7 @@ void PlaylistHandler::movePlaylistTracks(const Id& id, const Id& replaceId)
 void PlaylistHandler::removePlaylistTracks(const Id& id, const std::vector<int>& indexes)
 {
     if(auto* playlist = playlistById(id)) {
+        p->ensureLoaded(playlist);
         const auto removedIndexes = playlist->removeTracks(indexes);
         emit playlistTracksRemoved(playlist, removedIndexes);
     }
@@ -501,6 +734,7 @@ void PlaylistHandler::changeActivePlaylist(const Id& id)
 {
     auto playlist = std::ranges::find_if(std::as_const(p->playlists), [id](const auto& pl) { return pl->id() == id; });
     if(playlist != p->playlists.cend()) {
+        p->ensureLoaded(playlist->get());
         p->activePlaylist = playlist->get();
         emit activePlaylistChanged(playlist->get());
     }
@@ -508,6 +742,7 @@ void PlaylistHandler::changeActivePlaylist(const Id& id)
 
 void PlaylistHandler::changeActivePlaylist(Playlist* playlist)
 {
+    p->ensureLoaded(playlist);
     p->activePlaylist = playlist;
     emit activePlaylistChanged(playlist);
 }
@@ -517,12 +752,14 @@ void PlaylistHandler::schedulePlaylist(const Id& id)
     const auto playlist
         = std::ranges::find_if(std::as_const(p->playlists), [id](const auto& pl) { return pl->id() == id; });
     if(playlist != p->playlists.cend()) {
+        p->ensureLoaded(playlist->get());
         p->scheduledPlaylist = playlist->get();
     }
 }
 
 void PlaylistHandler::schedulePlaylist(Playlist* playlist)
 {
+    p->ensureLoaded(playlist);
     p->scheduledPlaylist = playlist;
 }
 
@@ -676,21 +913,35 @@ void PlaylistHandler::startPlayback(Playlist* playlist)
     p->startNextTrack(playlist->currentTrack(), playlist->currentTrackIndex());
 }
 
-void PlaylistHandler::populatePlaylists(const TrackList& tracks)
+void PlaylistHandler::loadPlaylist(Playlist* playlist)
 {
-    TrackIdMap idTracks;
-    for(const Track& track : tracks) {
-        idTracks.emplace(track.id(), track);
+    if(playlist && !playlist->isTemporary()) {
+        p->loadPlaylist(playlist->dbId());
     }
+}
 
-    for(const auto& playlist : p->playlists) {
-        const TrackList playlistTracks = p->playlistConnector.getPlaylistTracks(*playlist, idTracks);
-        playlist->replaceTracks(playlistTracks);
+void PlaylistHandler::populatePlaylists()
+{
+    std::vector<int> playlistIds;
+
+    if(std::exchange(p->libraryLoaded, true)) {
+        // The library was reloaded, so refresh the playlists which have already been loaded
+        for(const auto& playlist : p->playlists) {
+            if(!playlist->isTemporary() && !p->unloadedPlaylists.contains(playlist->dbId())) {
+                p->refreshPlaylist(playlist.get());
+            }
+        }
     }
 
-    p->restoreActivePlaylist();
+    playlistIds.insert(playlistIds.begin(), p->requestedPlaylists.cbegin(), p->requestedPlaylists.cend());
+    p->requestedPlaylists.clear();
+
+    // The active playlist is needed to restore playback, so it's loaded first
+    p->loadPlaylist(p->settings->value<Settings::Core::ActivePlaylistId>(), true);
 
-    emit playlistsPopulated();
+    for(const int id : playlistIds) {
+        p->loadPlaylist(id);
+    }
 }
 
 void PlaylistHandler::tracksUpdated(const TrackList& tracks)
@@ -732,9 +983,20 @@ void PlaylistHandler::tracksRemoved(const TrackList& tracks)
     }
 }
 
-void PlaylistHandler::trackAboutToFinish()
+Track PlaylistHandler::scheduleNextTrack()
+{
+    auto* playlist = p->scheduledPlaylist ? p->scheduledPlaylist : p->activePlaylist;
+    if(!playlist) {
+        return {};
+    }
+
+    return playlist->scheduleNextTrack(p->playerController->playMode());
+}
+
+void PlaylistHandler::prepareNextTrack()
 {
-    p->nextTrack(1);
+    const auto queue = p->playerController->playbackQueue();
+    emit nextTrackPrepared(queue.empty() ? scheduleNextTrack() : queue.track(0).track);
 }
 } // namespace Fooyin
 
@@ -23,6 +23,8 @@
 
 #include <core/constants.h>
 #include <core/track.h>
+#include <utils/fileutils.h>
+#include <utils/stringpool.h>
 
 #include <taglib/aifffile.h>
 #include <taglib/apefile.h>
@@ -33,7 +35,9 @@
 #include <taglib/attachedpictureframe.h>
 #include <taglib/fileref.h>
 #include <taglib/flacfile.h>
+#include <taglib/id3v2frame.h>
 #include <taglib/id3v2framefactory.h>
+#include <taglib/id3v2header.h>
 #include <taglib/id3v2tag.h>
 #include <taglib/mp4file.h>
 #include <taglib/mp4tag.h>
@@ -48,15 +52,28 @@
 #include <taglib/wavfile.h>
 #include <taglib/wavpackfile.h>
 
+#include <QCache>
 #include <QCryptographicHash>
 #include <QDir>
+#include <QFile>
 #include <QFileInfo>
 #include <QMimeDatabase>
 #include <QPixmap>
 
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <optional>
 #include <set>
 
 namespace {
+// Embedded covers are located by searching for their first bytes near the start and end of the file
+constexpr auto CoverSearchPrefix = 64;
+constexpr auto CoverSearchChunk  = 256 * 1024;
+constexpr auto CoverSearchWindow = 4 * 1024 * 1024;
+// Number of files to remember the located covers of
+constexpr auto CoverLocationCacheSize = 4096;
+
 constexpr std::array supportedMp4Tags{
     std::pair(Fooyin::Mp4::Title, Fooyin::Tag::Title),
     std::pair(Fooyin::Mp4::Artist, Fooyin::Tag::Artist),
@@ -160,6 +177,16 @@ QStringList convertStringList(const TagLib::StringList& strList)
     return list;
 }
 
+QString internString(const TagLib::String& str)
+{
+    return Fooyin::StringPool::shared().intern(convertString(str));
+}
+
+QStringList internStringList(const TagLib::StringList& strList)
+{
+    return Fooyin::StringPool::shared().intern(convertStringList(strList));
+}
+
 Fooyin::Track::Type typeForMime(const QString& mimeType)
 {
     if(mimeType == QStringLiteral("audio/mpeg") || mimeType == QStringLiteral("audio/mpeg3")
@@ -201,6 +228,122 @@ Fooyin::Track::Type typeForMime(const QString& mimeType)
     return Fooyin::Track::Type::Unknown;
 }
 
+// Stands in for a frame which wasn't parsed, keeping its size so the rest of the tag is still read
+class SkippedFrame : public TagLib::ID3v2::Frame
+{
+public:
+    explicit SkippedFrame(TagLib::ID3v2::Frame::Header* header)
+        : Frame{header}
+    { }
+
+    [[nodiscard]] TagLib::String toString() const override
+    {
+        return {};
+    }
+
+protected:
+    void parseFields(const TagLib::ByteVector& /*data*/) override { }
+
+    [[nodiscard]] TagLib::ByteVector renderFields() const override
+    {
+        return {};
+    }
+};
+
+/*!
+ * Skips attached pictures when parsing ID3v2 tags.
+ * Pictures can be several MB and are read separately by readCover, so there's no need to copy them
+ * when reading metadata.
+ */
+class NoPictureFrameFactory : public TagLib::ID3v2::FrameFactory
+{
+public:
+    static NoPictureFrameFactory* instance()
+    {
+        static NoPictureFrameFactory factory;
+        return &factory;
+    }
+
+    TagLib::ID3v2::Frame* createFrame(const TagLib::ByteVector& data,
+                                      const TagLib::ID3v2::Header* tagHeader) const override
+    {
+        auto* header                = new TagLib::ID3v2::Frame::Header(data, tagHeader->majorVersion());
+        const TagLib::ByteVector id = header->frameID();
+
+        // ID3v2.2 uses three character frame ids
+        if(id == "APIC" || id == "PIC") {
+            return new SkippedFrame(header);
+        }
+
+        delete header;
+        return FrameFactory::createFrame(data, tagHeader);
+    }
+};
+
+struct FileType
+{
+    const char* extension;
+    Fooyin::Track::Type type;
+};
+
+// Checked before falling back to the (much slower) mime database
+constexpr std::array fileTypes{
+    FileType{"mp3", Fooyin::Track::Type::MPEG},      FileType{"mp2", Fooyin::Track::Type::MPEG},
+    FileType{"flac", Fooyin::Track::Type::FLAC},     FileType{"ogg", Fooyin::Track::Type::OggVorbis},
+    FileType{"oga", Fooyin::Track::Type::OggVorbis}, FileType{"opus", Fooyin::Track::Type::OggOpus},
+    FileType{"m4a", Fooyin::Track::Type::MP4},       FileType{"m4b", Fooyin::Track::Type::MP4},
+    FileType{"mp4", Fooyin::Track::Type::MP4},       FileType{"wav", Fooyin::Track::Type::WAV},
+    FileType{"aiff", Fooyin::Track::Type::AIFF},     FileType{"aif", Fooyin::Track::Type::AIFF},
+    FileType{"aifc", Fooyin::Track::Type::AIFF},     FileType{"mpc", Fooyin::Track::Type::MPC},
+    FileType{"ape", Fooyin::Track::Type::APE},       FileType{"wv", Fooyin::Track::Type::WavPack},
+    FileType{"wma", Fooyin::Track::Type::ASF},
+};
+
+Fooyin::Track::Type typeForExtension(const QString& extension)
+{
+    for(const auto& [ext, type] : fileTypes) {
+        if(extension.compare(QLatin1String{ext}, Qt::CaseInsensitive) == 0) {
+            return type;
+        }
+    }
+    return Fooyin::Track::Type::Unknown;
+}
+
+Fooyin::Track::Type sniffOggType(TagLib::IOStream& stream)
+{
+    // The codec identification header follows the 28 byte header of the first page
+    stream.seek(28);
+    const TagLib::ByteVector codecHeader = stream.readBlock(8);
+    stream.seek(0);
+
+    if(codecHeader.startsWith("OpusHead")) {
+        return Fooyin::Track::Type::OggOpus;
+    }
+    if(codecHeader.startsWith("\x01vorbis")) {
+        return Fooyin::Track::Type::OggVorbis;
+    }
+    // Other codecs (FLAC, Speex...) are left to the mime database
+    return Fooyin::Track::Type::Unknown;
+}
+
+Fooyin::Track::Type resolveType(const QFileInfo& fileInfo, TagLib::IOStream& stream)
+{
+    auto type = typeForExtension(fileInfo.suffix());
+
+    if(type == Fooyin::Track::Type::OggVorbis || type == Fooyin::Track::Type::OggOpus) {
+        // Opus files may use the ogg extension and vice versa
+        type = sniffOggType(stream);
+    }
+
+    if(type == Fooyin::Track::Type::Unknown) {
+        // Missing or unknown extension, or an ogg container we can't identify
+        const QMimeDatabase mimeDb;
+        type = typeForMime(mimeDb.mimeTypeForFile(fileInfo).name());
+    }
+
+    return type;
+}
+
 TagLib::AudioProperties::ReadStyle readStyle(Fooyin::Tagging::Quality quality)
 {
     switch(quality) {
@@ -248,28 +391,28 @@ void readGeneralProperties(const TagLib::PropertyMap& props, Fooyin::Track& trac
         track.setTitle(convertString(props[Fooyin::Tag::Title].toString()));
     }
     if(props.contains(Fooyin::Tag::Artist)) {
-        track.setArtists(convertStringList(props[Fooyin::Tag::Artist]));
+        track.setArtists(internStringList(props[Fooyin::Tag::Artist]));
     }
     if(props.contains(Fooyin::Tag::Album)) {
-        track.setAlbum(convertString(props[Fooyin::Tag::Album].toString()));
+        track.setAlbum(internString(props[Fooyin::Tag::Album].toString()));
     }
     if(props.contains(Fooyin::Tag::AlbumArtist)) {
-        track.setAlbumArtists(convertStringList(props[Fooyin::Tag::AlbumArtist]));
+        track.setAlbumArtists(internStringList(props[Fooyin::Tag::AlbumArtist]));
     }
     if(props.contains(Fooyin::Tag::Genre)) {
-        track.setGenres(convertStringList(props[Fooyin::Tag::Genre]));
+        track.setGenres(internStringList(props[Fooyin::Tag::Genre]));
     }
     if(props.contains(Fooyin::Tag::Composer)) {
-        track.setComposer(convertString(props[Fooyin::Tag::Composer].toString()));
+        track.setComposer(internString(props[Fooyin::Tag::Composer].toString()));
     }
     if(props.contains(Fooyin::Tag::Performer)) {
-        track.setPerformer(convertString(props[Fooyin::Tag::Performer].toString()));
+        track.setPerformer(internString(props[Fooyin::Tag::Performer].toString()));
     }
     if(props.contains(Fooyin::Tag::Comment)) {
         track.setComment(convertString(props[Fooyin::Tag::Comment].toString()));
     }
     if(props.contains(Fooyin::Tag::Date)) {
-        track.setDate(convertString(props[Fooyin::Tag::Date].toString()));
+        track.setDate(internString(props[Fooyin::Tag::Date].toString()));
     }
     if(props.contains(Fooyin::Tag::Rating)) {
         // TODO
@@ -653,10 +796,292 @@ QByteArray readAsfCover(const TagLib::ASF::Tag* asfTags, Fooyin::Track::Cover co
 
     return {};
 }
+
+QString coverHash(const QByteArray& data)
+{
+    return QString::fromLatin1(QCryptographicHash::hash(data, QCryptographicHash::Md5).toHex());
+}
+
+int64_t searchForCover(TagLib::IOStream& stream, const QByteArray& data, int64_t start, int64_t end)
+{
+    const auto prefixSize = std::min<qsizetype>(data.size(), CoverSearchPrefix);
+    const TagLib::ByteVector prefix(data.constData(), static_cast<unsigned int>(prefixSize));
+
+    for(int64_t chunkStart{start}; chunkStart < end; chunkStart += CoverSearchChunk) {
+        stream.seek(chunkStart);
+        // Overlap chunks so a prefix straddling the boundary is still found
+        const TagLib::ByteVector chunk = stream.readBlock(CoverSearchChunk + prefixSize - 1);
+        if(chunk.isEmpty()) {
+            break;
+        }
+
+        int pos = chunk.find(prefix);
+        while(pos >= 0) {
+            const int64_t candidate = chunkStart + pos;
+            stream.seek(candidate);
+            const TagLib::ByteVector block = stream.readBlock(data.size());
+
+            if(block.size() == static_cast<unsigned int>(data.size())
+               && std::memcmp(block.data(), data.constData(), data.size()) == 0) {
+                return candidate;
+            }
+            pos = chunk.find(prefix, pos + 1);
+        }
+    }
+
+    return -1;
+}
+
+int64_t findCover(TagLib::IOStream& stream, const QByteArray& data)
+{
+    // Tags live at either end of the file, so only search the head and tail
+    const int64_t length = stream.length();
+
+    if(length <= 2 * CoverSearchWindow) {
+        return searchForCover(stream, data, 0, length);
+    }
+
+    const int64_t offset = searchForCover(stream, data, 0, CoverSearchWindow);
+    if(offset >= 0) {
+        return offset;
+    }
+
+    return searchForCover(stream, data, std::max<int64_t>(0, length - CoverSearchWindow - data.size()), length);
+}
+
+// Covers located by readCover, keyed by file path
+struct LocatedCovers
+{
+    uint64_t modifiedTime{0};
+    // Includes covers which couldn't be located, so they aren't searched for again
+    Fooyin::Track::CoverLocations locations;
+};
+
+struct CoverLocationCache
+{
+    std::mutex guard;
+    QCache<QString, LocatedCovers> files{CoverLocationCacheSize};
+};
+
+CoverLocationCache& coverLocationCache()
+{
+    static CoverLocationCache cache;
+    return cache;
+}
+
+struct CoverLocatedNotifier
+{
+    std::mutex guard;
+    Fooyin::Tagging::CoverLocatedHandler handler;
+};
+
+CoverLocatedNotifier& coverLocatedNotifier()
+{
+    static CoverLocatedNotifier notifier;
+    return notifier;
+}
+
+void notifyCoverLocated(const Fooyin::Track& track, const Fooyin::Track::CoverLocation& location)
+{
+    auto& notifier = coverLocatedNotifier();
+    const std::scoped_lock lock{notifier.guard};
+
+    if(!notifier.handler) {
+        return;
+    }
+
+    auto locations = track.coverLocations();
+    std::erase_if(locations, [&location](const auto& existing) { return existing.type == location.type; });
+    locations.push_back(location);
+
+    Fooyin::Track locatedTrack{track};
+    locatedTrack.setCoverLocations(locations);
+    notifier.handler(locatedTrack);
+}
+
+std::optional<Fooyin::Track::CoverLocation> cachedCoverLocation(const Fooyin::Track& track, Fooyin::Track::Cover cover)
+{
+    auto& cache = coverLocationCache();
+    const std::scoped_lock lock{cache.guard};
+
+    const LocatedCovers* located = cache.files.object(track.filepath());
+    if(!located || located->modifiedTime != track.modifiedTime()) {
+        return {};
+    }
+
+    for(const auto& location : located->locations) {
+        if(location.type == cover) {
+            return location;
+        }
+    }
+
+    return {};
+}
+
+void cacheCoverLocation(const Fooyin::Track& track, const Fooyin::Track::CoverLocation& location)
+{
+    auto& cache = coverLocationCache();
+    const std::scoped_lock lock{cache.guard};
+
+    LocatedCovers* located = cache.files.object(track.filepath());
+    if(!located || located->modifiedTime != track.modifiedTime()) {
+        located = new LocatedCovers{track.modifiedTime(), {}};
+        cache.files.insert(track.filepath(), located);
+    }
+
+    std::erase_if(located->locations, [&location](const auto& existing) { return existing.type == location.type; });
+    located->locations.push_back(location);
+}
+
+// Finds where the picture @p data read for @p cover is stored, so later reads only need its byte range
+void locateCover(const Fooyin::Track& track, Fooyin::Track::Cover cover, TagLib::IOStream& stream,
+                 const QByteArray& data)
+{
+    Fooyin::Track::CoverLocation location;
+    location.type = cover;
+
+    const int64_t offset = findCover(stream, data);
+    if(offset >= 0) {
+        location.offset = static_cast<uint64_t>(offset);
+        location.size   = static_cast<uint64_t>(data.size());
+        location.hash   = coverHash(data);
+    }
+
+    cacheCoverLocation(track, location);
+
+    if(location.isValid()) {
+        notifyCoverLocated(track, location);
+    }
+}
+
+QByteArray readCoverLocation(const QString& filepath, const Fooyin::Track::CoverLocation& location)
+{
+    QFile file{filepath};
+    if(!file.open(QIODevice::ReadOnly) || !file.seek(static_cast<qint64>(location.offset))) {
+        return {};
+    }
+
+    QByteArray data = file.read(static_cast<qint64>(location.size));
+
+    // The file may have been modified since it was scanned
+    if(static_cast<uint64_t>(data.size()) != location.size || coverHash(data) != location.hash) {
+        return {};
+    }
+
+    return data;
+}
+// Reads the fingerprint from the already open @p stream, rather than opening the file again
+QString readFingerprint(TagLib::IOStream& stream, int64_t size)
+{
+    const auto [offset, length] = Fooyin::Utils::File::fingerprintBlock(size);
+
+    stream.seek(offset);
+    const TagLib::ByteVector block = stream.readBlock(static_cast<size_t>(length));
+    stream.seek(0);
+
+    return Fooyin::Utils::File::fingerprint(size, QByteArray{block.data(), static_cast<qsizetype>(block.size())});
+}
+
+// Reads @p cover by parsing the tags of the file in @p stream
+QByteArray readEmbeddedCover(TagLib::IOStream& stream, Fooyin::Track::Type type, Fooyin::Track::Cover cover)
+{
+    const auto style = TagLib::AudioProperties::Fast;
+
+    switch(type) {
+        case(Fooyin::Track::Type::MPEG): {
+#if(TAGLIB_MAJOR_VERSION >= 2)
+            TagLib::MPEG::File file(&stream, false, style, TagLib::ID3v2::FrameFactory::instance());
+#else
+            TagLib::MPEG::File file(&stream, TagLib::ID3v2::FrameFactory::instance(), false, style);
+#endif
+            if(file.isValid() && file.hasID3v2Tag()) {
+                return readId3Cover(file.ID3v2Tag(), cover);
+            }
+            break;
+        }
+        case(Fooyin::Track::Type::AIFF): {
+            const TagLib::RIFF::AIFF::File file(&stream, false);
+            if(file.isValid() && file.hasID3v2Tag()) {
+                return readId3Cover(file.tag(), cover);
+            }
+            break;
+        }
+        case(Fooyin::Track::Type::WAV): {
+            const TagLib::RIFF::WAV::File file(&stream, false);
+            if(file.isValid() && file.hasID3v2Tag()) {
+                return readId3Cover(file.ID3v2Tag(), cover);
+            }
+            break;
+        }
+        case(Fooyin::Track::Type::MPC): {
+            TagLib::MPC::File file(&stream, false);
+            if(file.isValid() && file.APETag()) {
+                return readApeCover(file.APETag(), cover);
+            }
+            break;
+        }
+        case(Fooyin::Track::Type::APE): {
+            TagLib::APE::File file(&stream, false);
+            if(file.isValid() && file.APETag()) {
+                return readApeCover(file.APETag(), cover);
+            }
+            break;
+        }
+        case(Fooyin::Track::Type::WavPack): {
+            TagLib::WavPack::File file(&stream, false);
+            if(file.isValid() && file.APETag()) {
+                return readApeCover(file.APETag(), cover);
+            }
+            break;
+        }
+        case(Fooyin::Track::Type::MP4): {
+            const TagLib::MP4::File file(&stream, false);
+            if(file.isValid() && file.tag()) {
+                return readMp4Cover(file.tag(), cover);
+            }
+            break;
+        }
+        case(Fooyin::Track::Type::FLAC): {
+#if(TAGLIB_MAJOR_VERSION >= 2)
+            TagLib::FLAC::File file(&stream, false, style, TagLib::ID3v2::FrameFactory::instance());
+#else
+            TagLib::FLAC::File file(&stream, TagLib::ID3v2::FrameFactory::instance(), false, style);
+#endif
+            if(file.isValid()) {
+                return readFlacCover(file.pictureList(), cover);
+            }
+            break;
+        }
+        case(Fooyin::Track::Type::OggVorbis): {
+            const TagLib::Ogg::Vorbis::File file(&stream, false);
+            if(file.isValid() && file.tag()) {
+                return readFlacCover(file.tag()->pictureList(), cover);
+            }
+            break;
+        }
+        case(Fooyin::Track::Type::OggOpus): {
+            const TagLib::Ogg::Opus::File file(&stream, false);
+            if(file.isValid() && file.tag()) {
+                return readFlacCover(file.tag()->pictureList(), cover);
+            }
+            break;
+        }
+        case(Fooyin::Track::Type::ASF): {
+            const TagLib::ASF::File file(&stream, false);
+            if(file.isValid() && file.tag()) {
+                return readAsfCover(file.tag(), cover);
+            }
+            break;
+        }
+        case(Fooyin::Track::Type::Unknown):
+            break;
+    }
+
+    return {};
+}
 } // namespace
 
 namespace Fooyin::Tagging {
-// TODO: Implement a file/mime type resolver
 bool readMetaData(Track& track, Quality quality)
 {
     const auto filepath = track.filepath();
@@ -668,6 +1093,10 @@ bool readMetaData(Track& track, Quality quality)
 
     track.setFileSize(fileInfo.size());
 
+    const auto fileId = Utils::File::fileId(filepath);
+    track.setDeviceId(fileId.device);
+    track.setInode(fileId.inode);
+
     track.setAddedTime(QDateTime::currentMSecsSinceEpoch());
     const QDateTime modifiedTime = fileInfo.lastModified();
     track.setModifiedTime(modifiedTime.isValid() ? modifiedTime.toMSecsSinceEpoch() : 0);
@@ -678,8 +1107,9 @@ bool readMetaData(Track& track, Quality quality)
         return false;
     }
 
-    const QMimeDatabase mimeDb;
-    QString mimeType = mimeDb.mimeTypeForFile(filepath).name();
+    track.setFingerprint(readFingerprint(stream, fileInfo.size()));
+
+    const auto type  = resolveType(fileInfo, stream);
     const auto style = readStyle(quality);
 
     const auto readProperties = [&track](const TagLib::File& file, bool skipExtra = false) {
@@ -687,124 +1117,131 @@ bool readMetaData(Track& track, Quality quality)
         readGeneralProperties(file.properties(), track, skipExtra);
     };
 
-    if(mimeType == QStringLiteral("audio/ogg") || mimeType == QStringLiteral("audio/x-vorbis+ogg")) {
-        // Workaround for opus files with ogg suffix returning incorrect type
-        mimeType = mimeDb.mimeTypeForFile(filepath, QMimeDatabase::MatchContent).name();
-    }
-    if(mimeType == QStringLiteral("audio/mpeg") || mimeType == QStringLiteral("audio/mpeg3")
-       || mimeType == QStringLiteral("audio/x-mpeg")) {
+    switch(type) {
+        case(Track::Type::MPEG): {
 #if(TAGLIB_MAJOR_VERSION >= 2)
-        TagLib::MPEG::File file(&stream, true, style, TagLib::ID3v2::FrameFactory::instance());
+            TagLib::MPEG::File file(&stream, true, style, NoPictureFrameFactory::instance());
 #else
-        TagLib::MPEG::File file(&stream, TagLib::ID3v2::FrameFactory::instance(), true, style);
+            TagLib::MPEG::File file(&stream, NoPictureFrameFactory::instance(), true, style);
 #endif
-        if(file.isValid()) {
-            readProperties(file);
-            if(file.hasID3v2Tag()) {
-                readId3Tags(file.ID3v2Tag(), track);
+            if(file.isValid()) {
+                readProperties(file);
+                if(file.hasID3v2Tag()) {
+                    readId3Tags(file.ID3v2Tag(), track);
+                }
             }
+            break;
         }
-    }
-    else if(mimeType == QStringLiteral("audio/x-aiff") || mimeType == QStringLiteral("audio/x-aifc")) {
-        const TagLib::RIFF::AIFF::File file(&stream, true, style);
-        if(file.isValid()) {
-            readProperties(file);
-            if(file.hasID3v2Tag()) {
-                readId3Tags(file.tag(), track);
+        case(Track::Type::AIFF): {
+            const TagLib::RIFF::AIFF::File file(&stream, true, style);
+            if(file.isValid()) {
+                readProperties(file);
+                if(file.hasID3v2Tag()) {
+                    readId3Tags(file.tag(), track);
+                }
             }
+            break;
         }
-    }
-    else if(mimeType == QStringLiteral("audio/vnd.wave") || mimeType == QStringLiteral("audio/wav")
-            || mimeType == QStringLiteral("audio/x-wav")) {
-        const TagLib::RIFF::WAV::File file(&stream, true, style);
-        if(file.isValid()) {
-            readProperties(file);
-            if(file.hasID3v2Tag()) {
-                readId3Tags(file.ID3v2Tag(), track);
+        case(Track::Type::WAV): {
+            const TagLib::RIFF::WAV::File file(&stream, true, style);
+            if(file.isValid()) {
+                readProperties(file);
+                if(file.hasID3v2Tag()) {
+                    readId3Tags(file.ID3v2Tag(), track);
+                }
             }
+            break;
         }
-    }
-    else if(mimeType == QStringLiteral("audio/x-musepack")) {
-        TagLib::MPC::File file(&stream, true, style);
-        if(file.isValid()) {
-            readProperties(file);
-            if(file.APETag()) {
-                readApeTags(file.APETag(), track);
+        case(Track::Type::MPC): {
+            TagLib::MPC::File file(&stream, true, style);
+            if(file.isValid()) {
+                readProperties(file);
+                if(file.APETag()) {
+                    readApeTags(file.APETag(), track);
+                }
             }
+            break;
         }
-    }
-    else if(mimeType == QStringLiteral("audio/x-ape")) {
-        TagLib::APE::File file(&stream, true, style);
-        if(file.isValid()) {
-            readProperties(file);
-            if(file.APETag()) {
-                readApeTags(file.APETag(), track);
+        case(Track::Type::APE): {
+            TagLib::APE::File file(&stream, true, style);
+            if(file.isValid()) {
+                readProperties(file);
+                if(file.APETag()) {
+                    readApeTags(file.APETag(), track);
+                }
             }
+            break;
         }
-    }
-    else if(mimeType == QStringLiteral("audio/x-wavpack")) {
-        TagLib::WavPack::File file(&stream, true, style);
-        if(file.isValid()) {
-            readProperties(file);
-            if(file.APETag()) {
-                readApeTags(file.APETag(), track);
+        case(Track::Type::WavPack): {
+            TagLib::WavPack::File file(&stream, true, style);
+            if(file.isValid()) {
+                readProperties(file);
+                if(file.APETag()) {
+                    readApeTags(file.APETag(), track);
+                }
             }
+            break;
         }
-    }
-    else if(mimeType == QStringLiteral("audio/mp4") || mimeType == QStringLiteral("audio/vnd.audible.aax")) {
-        const TagLib::MP4::File file(&stream, true, style);
-        if(file.isValid()) {
-            readProperties(file, true);
-            if(file.hasMP4Tag()) {
-                readMp4Tags(file.tag(), track);
+        case(Track::Type::MP4): {
+            const TagLib::MP4::File file(&stream, true, style);
+            if(file.isValid()) {
+                readProperties(file, true);
+                if(file.hasMP4Tag()) {
+                    readMp4Tags(file.tag(), track);
+                }
             }
+            break;
         }
-    }
-    else if(mimeType == QStringLiteral("audio/flac")) {
+        case(Track::Type::FLAC): {
 #if(TAGLIB_MAJOR_VERSION >= 2)
-        TagLib::FLAC::File file(&stream, true, style, TagLib::ID3v2::FrameFactory::instance());
+            TagLib::FLAC::File file(&stream, true, style, NoPictureFrameFactory::instance());
 #else
-        TagLib::FLAC::File file(&stream, TagLib::ID3v2::FrameFactory::instance(), true, style);
+            TagLib::FLAC::File file(&stream, NoPictureFrameFactory::instance(), true, style);
 #endif
-        if(file.isValid()) {
-            readProperties(file);
-            if(file.hasXiphComment()) {
-                readXiphComment(file.xiphComment(), track);
+            if(file.isValid()) {
+                readProperties(file);
+                if(file.hasXiphComment()) {
+                    readXiphComment(file.xiphComment(), track);
+                }
             }
+            break;
         }
-    }
-    else if(mimeType == QStringLiteral("audio/ogg") || mimeType == QStringLiteral("audio/x-vorbis+ogg")) {
-        const TagLib::Ogg::Vorbis::File file(&stream, true, style);
-        if(file.isValid()) {
-            readProperties(file);
-            if(file.tag()) {
-                readXiphComment(file.tag(), track);
+        case(Track::Type::OggVorbis): {
+            const TagLib::Ogg::Vorbis::File file(&stream, true, style);
+            if(file.isValid()) {
+                readProperties(file);
+                if(file.tag()) {
+                    readXiphComment(file.tag(), track);
+                }
             }
+            break;
         }
-    }
-    else if(mimeType == QStringLiteral("audio/opus") || mimeType == QStringLiteral("audio/x-opus+ogg")) {
-        const TagLib::Ogg::Opus::File file(&stream, true, style);
-        if(file.isValid()) {
-            readProperties(file);
-            if(file.tag()) {
-                readXiphComment(file.tag(), track);
+        case(Track::Type::OggOpus): {
+            const TagLib::Ogg::Opus::File file(&stream, true, style);
+            if(file.isValid()) {
+                readProperties(file);
+                if(file.tag()) {
+                    readXiphComment(file.tag(), track);
+                }
             }
+            break;
         }
-    }
-    else if(mimeType == QStringLiteral("audio/x-ms-wma")) {
-        const TagLib::ASF::File file(&stream, true, style);
-        if(file.isValid()) {
-            readProperties(file);
-            if(file.tag()) {
-                readAsfTags(file.tag(), track);
+        case(Track::Type::ASF): {
+            const TagLib::ASF::File file(&stream, true, style);
+            if(file.isValid()) {
+                readProperties(file);
+                if(file.tag()) {
+                    readAsfTags(file.tag(), track);
+                }
             }
+            break;
         }
-    }
-    else {
-        qDebug() << "Unsupported mime type: " << mimeType;
+        case(Track::Type::Unknown):
+            qDebug() << "Unsupported file type: " << filepath;
+            break;
     }
 
-    track.setType(typeForMime(mimeType));
+    track.setType(type);
     track.generateHash();
 
     return true;
@@ -819,97 +1256,46 @@ QByteArray readCover(const Track& track, Track::Cover cover)
         return {};
     }
 
+    if(const auto location = coverLocation(track, cover); location.isValid()) {
+        QByteArray data = readCoverLocation(filepath, location);
+        if(!data.isEmpty()) {
+            return data;
+        }
+    }
+
     TagLib::FileStream stream(filepath.toUtf8().constData(), true);
     if(!stream.isOpen()) {
         qWarning() << "Unable to open file readonly: " << filepath;
         return {};
     }
 
-    const QMimeDatabase mimeDb;
-    QString mimeType = mimeDb.mimeTypeForFile(filepath).name();
-    const auto style = TagLib::AudioProperties::Average;
+    const auto type   = resolveType(fileInfo, stream);
+    QByteArray data   = readEmbeddedCover(stream, type, cover);
+    const auto cached = cachedCoverLocation(track, cover);
 
-    if(mimeType == QStringLiteral("audio/ogg") || mimeType == QStringLiteral("audio/x-vorbis+ogg")) {
-        // Workaround for opus files with ogg suffix returning incorrect type
-        mimeType = mimeDb.mimeTypeForFile(filepath, QMimeDatabase::MatchContent).name();
-    }
-    if(mimeType == QStringLiteral("audio/mpeg") || mimeType == QStringLiteral("audio/mpeg3")
-       || mimeType == QStringLiteral("audio/x-mpeg")) {
-#if(TAGLIB_MAJOR_VERSION >= 2)
-        TagLib::MPEG::File file(&stream, true, style, TagLib::ID3v2::FrameFactory::instance());
-#else
-        TagLib::MPEG::File file(&stream, TagLib::ID3v2::FrameFactory::instance(), true, style);
-#endif
-        if(file.isValid() && file.hasID3v2Tag()) {
-            return readId3Cover(file.ID3v2Tag(), cover);
-        }
-    }
-    else if(mimeType == QStringLiteral("audio/x-aiff") || mimeType == QStringLiteral("audio/x-aifc")) {
-        const TagLib::RIFF::AIFF::File file(&stream, true);
-        if(file.isValid() && file.hasID3v2Tag()) {
-            return readId3Cover(file.tag(), cover);
-        }
-    }
-    else if(mimeType == QStringLiteral("audio/vnd.wave") || mimeType == QStringLiteral("audio/wav")
-            || mimeType == QStringLiteral("audio/x-wav")) {
-        const TagLib::RIFF::WAV::File file(&stream, true);
-        if(file.isValid() && file.hasID3v2Tag()) {
-            return readId3Cover(file.ID3v2Tag(), cover);
-        }
-    }
-    else if(mimeType == QStringLiteral("audio/x-musepack")) {
-        TagLib::MPC::File file(&stream, true);
-        if(file.isValid() && file.APETag()) {
-            return readApeCover(file.APETag(), cover);
-        }
-    }
-    else if(mimeType == QStringLiteral("audio/x-ape")) {
-        TagLib::APE::File file(&stream, true);
-        if(file.isValid() && file.APETag()) {
-            return readApeCover(file.APETag(), cover);
-        }
-    }
-    else if(mimeType == QStringLiteral("audio/x-wavpack")) {
-        TagLib::WavPack::File file(&stream, true);
-        if(file.isValid() && file.APETag()) {
-            return readApeCover(file.APETag(), cover);
-        }
-    }
-    else if(mimeType == QStringLiteral("audio/mp4") || mimeType == QStringLiteral("audio/vnd.audible.aax")) {
-        const TagLib::MP4::File file(&stream, true);
-        if(file.isValid() && file.tag()) {
-            return readMp4Cover(file.tag(), cover);
-        }
-    }
-    else if(mimeType == QStringLiteral("audio/flac")) {
-#if(TAGLIB_MAJOR_VERSION >= 2)
-        TagLib::FLAC::File file(&stream, true, style, TagLib::ID3v2::FrameFactory::instance());
-#else
-        TagLib::FLAC::File file(&stream, TagLib::ID3v2::FrameFactory::instance(), true, style);
-#endif
-        if(file.isValid()) {
-            return readFlacCover(file.pictureList(), cover);
-        }
-    }
-    else if(mimeType == QStringLiteral("audio/ogg") || mimeType == QStringLiteral("audio/x-vorbis+ogg")) {
-        const TagLib::Ogg::Vorbis::File file(&stream, true);
-        if(file.isValid() && file.tag()) {
-            return readFlacCover(file.tag()->pictureList(), cover);
-        }
-    }
-    else if(mimeType == QStringLiteral("audio/opus") || mimeType == QStringLiteral("audio/x-opus+ogg")) {
-        const TagLib::Ogg::Opus::File file(&stream, true);
-        if(file.isValid() && file.tag()) {
-            return readFlacCover(file.tag()->pictureList(), cover);
-        }
+    // Ogg pictures are base64 encoded within the comment packets, so have no raw byte range
+    const bool locatable = type != Track::Type::OggVorbis && type != Track::Type::OggOpus;
+    if(!data.isEmpty() && locatable && (!cached || cached->isValid())) {
+        locateCover(track, cover, stream, data);
     }
-    else if(mimeType == QStringLiteral("audio/x-ms-wma")) {
-        const TagLib::ASF::File file(&stream, true);
-        if(file.isValid() && file.tag()) {
-            return readAsfCover(file.tag(), cover);
-        }
+
+    return data;
+}
+
+Track::CoverLocation coverLocation(const Track& track, Track::Cover cover)
+{
+    if(auto location = track.coverLocation(cover); location.isValid()) {
+        return location;
     }
 
-    return {};
+    return cachedCoverLocation(track, cover).value_or(Track::CoverLocation{});
+}
+
+void setCoverLocatedHandler(CoverLocatedHandler handler)
+{
+    auto& notifier = coverLocatedNotifier();
+    const std::scoped_lock lock{notifier.guard};
+
+    notifier.handler = std::move(handler);
 }
 } // namespace Fooyin::Tagging
@@ -27,6 +27,8 @@
 
 #include <QString>
 
+#include <functional>
+
 class QPixmap;
 
 namespace Fooyin::Tagging {
@@ -39,4 +41,11 @@ enum class Quality : uint8_t
 
 FYCORE_EXPORT bool readMetaData(Track& track, Quality quality = Quality::Average);
 FYCORE_EXPORT QByteArray readCover(const Track& track, Track::Cover cover = Track::Cover::Front);
+/** Returns where @p cover is stored in the file of @p track, if it has been located by a previous readCover. */
+FYCORE_EXPORT Track::CoverLocation coverLocation(const Track& track, Track::Cover cover);
+
+using CoverLocatedHandler = std::function<void(const Track& track)>;
+/** Sets the handler called (from the reading thread) with a copy of the track whenever readCover locates a new cover.
+    The copy's cover locations include the new one, so they can be stored with the track. */
+FYCORE_EXPORT void setCoverLocatedHandler(CoverLocatedHandler handler);
 } // namespace Fooyin::Tagging
@@ -570,6 +570,8 @@ bool writeMetaData(Track& track)
 
     const QDateTime modifiedTime = QFileInfo{filepath}.lastModified();
     track.setModifiedTime(modifiedTime.isValid() ? modifiedTime.toMSecsSinceEpoch() : 0);
+    // Saving may have moved any embedded pictures
+    track.setCoverLocations({});
 
     return true;
 }
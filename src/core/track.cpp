@@ -20,6 +20,7 @@
 #include <core/track.h>
 
 #include <utils/crypto.h>
+#include <utils/stringpool.h>
 #include <utils/utils.h>
 
 #include <QDir>
@@ -56,8 +57,12 @@ struct Track::Private : public QSharedData
     int year{-1};
     ExtraTags extraTags;
     QStringList removedTags;
+    CoverLocations coverLocations;
 
     uint64_t filesize{0};
+    uint64_t deviceId{0};
+    uint64_t inode{0};
+    QString fingerprint;
     int bitrate{0};
     int sampleRate{0};
     int channels{2};
@@ -391,11 +396,60 @@ QByteArray Track::serialiseExtrasTags() const
     return out;
 }
 
+Track::CoverLocations Track::coverLocations() const
+{
+    return p->coverLocations;
+}
+
+Track::CoverLocation Track::coverLocation(Cover type) const
+{
+    for(const auto& location : p->coverLocations) {
+        if(location.type == type) {
+            return location;
+        }
+    }
+    return {};
+}
+
+QByteArray Track::serialiseCoverLocations() const
+{
+    if(p->coverLocations.empty()) {
+        return {};
+    }
+
+    QByteArray out;
+    QDataStream stream(&out, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    stream << static_cast<quint32>(p->coverLocations.size());
+    for(const auto& location : p->coverLocations) {
+        stream << static_cast<qint32>(location.type) << static_cast<quint64>(location.offset)
+               << static_cast<quint64>(location.size) << location.hash;
+    }
+
+    return out;
+}
+
 uint64_t Track::fileSize() const
 {
     return p->filesize;
 }
 
+uint64_t Track::deviceId() const
+{
+    return p->deviceId;
+}
+
+uint64_t Track::inode() const
+{
+    return p->inode;
+}
+
+QString Track::fingerprint() const
+{
+    return p->fingerprint;
+}
+
 int Track::bitrate() const
 {
     return p->bitrate;
@@ -478,8 +532,8 @@ void Track::setFilePath(const QString& path)
     if(!path.isEmpty()) {
         const QFileInfo fileInfo{path};
         p->filename  = fileInfo.completeBaseName();
-        p->extension = fileInfo.suffix();
-        p->directory = fileInfo.dir().dirName();
+        p->extension = StringPool::shared().intern(fileInfo.suffix());
+        p->directory = StringPool::shared().intern(fileInfo.dir().dirName());
     }
 }
 
@@ -641,11 +695,57 @@ void Track::storeExtraTags(const QByteArray& tags)
     stream >> p->extraTags;
 }
 
+void Track::setCoverLocations(const CoverLocations& locations)
+{
+    p->coverLocations = locations;
+}
+
+void Track::storeCoverLocations(const QByteArray& locations)
+{
+    p->coverLocations.clear();
+
+    if(locations.isEmpty()) {
+        return;
+    }
+
+    QByteArray in{locations};
+    QDataStream stream(&in, QIODevice::ReadOnly);
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    quint32 count{0};
+    stream >> count;
+
+    for(quint32 i{0}; i < count && stream.status() == QDataStream::Ok; ++i) {
+        qint32 type{0};
+        quint64 offset{0};
+        quint64 size{0};
+        QString hash;
+        stream >> type >> offset >> size >> hash;
+
+        p->coverLocations.push_back({static_cast<Cover>(type), offset, size, hash});
+    }
+}
+
 void Track::setFileSize(uint64_t fileSize)
 {
     p->filesize = fileSize;
 }
 
+void Track::setDeviceId(uint64_t id)
+{
+    p->deviceId = id;
+}
+
+void Track::setInode(uint64_t inode)
+{
+    p->inode = inode;
+}
+
+void Track::setFingerprint(const QString& fingerprint)
+{
+    p->fingerprint = fingerprint;
+}
+
 void Track::setBitrate(int rate)
 {
     p->bitrate = rate;
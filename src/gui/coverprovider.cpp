@@ -33,13 +33,16 @@
 #include <utils/utils.h>
 
 #include <QByteArray>
+#include <QCache>
 #include <QFileInfo>
 #include <QIcon>
 #include <QPixmapCache>
 
+#include <mutex>
 #include <set>
 
-constexpr auto MaxSize = 1024;
+constexpr auto MaxSize          = 1024;
+constexpr auto DecodedCacheSize = 64 * 1024; // KiB
 
 namespace {
 QString generateCoverKey(const Fooyin::Track& track, Fooyin::Track::Cover type)
@@ -64,6 +67,41 @@ void saveThumbnail(const QImage& cover, const QString& key)
     file.open(QIODevice::WriteOnly);
     cover.save(&file, "JPG", 85);
 }
+
+// Embedded covers decoded by any provider, keyed by the hash of the picture's data.
+// Identical artwork (i.e. across the tracks of an album) is only decoded once.
+// Entries are keyed by content, so they never go stale and are shared rather than removed per track.
+struct DecodedCoverCache
+{
+    std::mutex guard;
+    QCache<QString, QImage> covers{DecodedCacheSize};
+};
+
+DecodedCoverCache& decodedCoverCache()
+{
+    static DecodedCoverCache cache;
+    return cache;
+}
+
+QImage findDecodedCover(const QString& hash)
+{
+    auto& cache = decodedCoverCache();
+    const std::scoped_lock lock{cache.guard};
+
+    if(const QImage* cover = cache.covers.object(hash)) {
+        return *cover;
+    }
+    return {};
+}
+
+void insertDecodedCover(const QString& hash, const QImage& cover)
+{
+    auto& cache = decodedCoverCache();
+    const std::scoped_lock lock{cache.guard};
+
+    const auto cost = static_cast<qsizetype>(std::max<qsizetype>(1, cover.sizeInBytes() / 1024));
+    cache.covers.insert(hash, new QImage(cover), cost);
+}
 } // namespace
 
 namespace Fooyin {
@@ -201,10 +239,20 @@ struct CoverProvider::Private
                       }
                   }
 
+                  // Set if the embedded cover was decoded, so it can be shared with other tracks
+                  QString decodedHash;
+
                   if(image.isNull()) {
-                      const QByteArray coverData = Tagging::readCover(track, type);
-                      if(!coverData.isEmpty()) {
-                          image.loadFromData(coverData);
+                      if(const auto location = Tagging::coverLocation(track, type); location.isValid()) {
+                          image = findDecodedCover(location.hash);
+                      }
+
+                      if(image.isNull()) {
+                          const QByteArray coverData = Tagging::readCover(track, type);
+                          if(!coverData.isEmpty() && image.loadFromData(coverData)) {
+                              // Located by readCover
+                              decodedHash = Tagging::coverLocation(track, type).hash;
+                          }
                       }
                   }
 
@@ -212,6 +260,10 @@ struct CoverProvider::Private
                       image = Utils::scaleImage(image, MaxSize);
                   }
 
+                  if(!decodedHash.isEmpty()) {
+                      insertDecodedCover(decodedHash, image);
+                  }
+
                   if(isThumb) {
                       if(image.isNull()) {
                           QFile::remove(cachePath);
@@ -331,6 +383,10 @@ void CoverProvider::clearCache()
     cache.removeRecursively();
 
     QPixmapCache::clear();
+
+    auto& decodedCache = decodedCoverCache();
+    const std::scoped_lock lock{decodedCache.guard};
+    decodedCache.covers.clear();
 }
 
 void CoverProvider::removeFromCache(const Track& track)
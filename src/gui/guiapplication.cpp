@@ -61,6 +61,7 @@
 #include "settings/widgets/statuswidgetpage.h"
 #include "widgets/coverwidget.h"
 #include "widgets/dummy.h"
+#include "widgets/enginemetricswidget.h"
 #include "widgets/spacer.h"
 #include "widgets/splitterwidget.h"
 #include "widgets/statuswidget.h"
@@ -68,6 +69,8 @@
 
 #include <core/coresettings.h>
 #include <core/engine/enginehandler.h>
+#include <core/engine/replaygain.h>
+#include <core/engine/replaygainscanner.h>
 #include <core/library/librarymanager.h>
 #include <core/library/musiclibrary.h>
 #include <core/playlist/playlisthandler.h>
@@ -78,12 +81,14 @@
 #include <gui/guiconstants.h>
 #include <gui/guisettings.h>
 #include <gui/layoutprovider.h>
+#include <gui/metadatawriter.h>
 #include <gui/plugins/guiplugin.h>
 #include <gui/plugins/guiplugincontext.h>
 #include <gui/propertiesdialog.h>
 #include <gui/trackselectioncontroller.h>
 #include <gui/widgetprovider.h>
 #include <gui/windowcontroller.h>
+#include <utils/actions/actioncontainer.h>
 #include <utils/actions/actionmanager.h>
 #include <utils/settings/settingsdialogcontroller.h>
 #include <utils/settings/settingsmanager.h>
@@ -92,6 +97,7 @@
 #include <QAction>
 #include <QFileDialog>
 #include <QFileInfo>
+#include <QMenu>
 #include <QMessageBox>
 #include <QPixmapCache>
 #include <QPushButton>
@@ -151,6 +157,7 @@ struct GuiApplication::Private
     GuiPluginContext guiPluginContext;
 
     ScriptParser parser;
+    ReplayGainScanner* replayGainScanner;
 
     explicit Private(GuiApplication* self_, const CorePluginContext& core)
         : self{self_}
@@ -197,6 +204,7 @@ struct GuiApplication::Private
         , pluginPage{settingsManager, pluginManager}
         , guiPluginContext{actionManager,    &layoutProvider, &selectionController, searchController,
                            propertiesDialog, &widgetProvider, editableLayout.get(), windowController}
+        , replayGainScanner{new ReplayGainScanner(self)}
     {
         setupConnections();
         registerActions();
@@ -335,6 +343,49 @@ struct GuiApplication::Private
                     settingsManager->value<Settings::Core::Internal::MuteVolume>());
             }
         });
+
+        auto* selectionMenu  = actionManager->actionContainer(Constants::Menus::Context::TrackSelection);
+        auto* replayGainMenu = actionManager->createMenu(Constants::Menus::Context::ReplayGain);
+        replayGainMenu->menu()->setTitle(tr("ReplayGain"));
+        selectionMenu->addMenu(replayGainMenu);
+
+        auto* scanReplayGain = new QAction(tr("Scan ReplayGain"), mainWindow.get());
+        QObject::connect(scanReplayGain, &QAction::triggered, replayGainScanner, [this]() {
+            if(selectionController.hasTracks()) {
+                replayGainScanner->scan(selectionController.selectedTracks());
+            }
+        });
+        replayGainMenu->addAction(actionManager->registerAction(scanReplayGain, "TrackSelection.ScanReplayGain"));
+
+        auto* removeReplayGain = new QAction(tr("Remove ReplayGain information"), mainWindow.get());
+        QObject::connect(removeReplayGain, &QAction::triggered, self, [this]() { removeReplayGainInfo(); });
+        replayGainMenu->addAction(
+            actionManager->registerAction(removeReplayGain, "TrackSelection.RemoveReplayGain"));
+
+        QObject::connect(replayGainScanner, &ReplayGainScanner::finished, library,
+                         [this](const TrackList& tracks) { Gui::writeTrackMetadata(library, tracks); });
+    }
+
+    void removeReplayGainInfo()
+    {
+        TrackList tracks;
+
+        for(Track track : selectionController.selectedTracks()) {
+            bool hadTags{false};
+            for(const auto* tag : {ReplayGain::TrackGainTag, ReplayGain::TrackPeakTag, ReplayGain::AlbumGainTag,
+                                   ReplayGain::AlbumPeakTag}) {
+                const QString name = QString::fromLatin1(tag);
+                if(track.hasExtraTag(name)) {
+                    track.removeExtraTag(name);
+                    hadTags = true;
+                }
+            }
+            if(hadTags) {
+                tracks.push_back(track);
+            }
+        }
+
+        Gui::writeTrackMetadata(library, tracks);
     }
 
     void restoreIconTheme()
@@ -485,6 +536,11 @@ struct GuiApplication::Private
         widgetProvider.registerWidget(
             QStringLiteral("Spacer"), [this]() { return new Spacer(mainWindow.get()); }, tr("Spacer"));
 
+        widgetProvider.registerWidget(
+            QStringLiteral("EngineMetrics"), [this]() { return new EngineMetricsWidget(engine, mainWindow.get()); },
+            tr("Engine Metrics"));
+        widgetProvider.setSubMenus(QStringLiteral("EngineMetrics"), {tr("Debug")});
+
         widgetProvider.registerWidget(
             QStringLiteral("StatusBar"),
             [this]() {
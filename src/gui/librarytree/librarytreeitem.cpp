@@ -136,6 +136,7 @@ void LibraryTreeItem::sortChildren()
                   return cmp < 0;
               });
     m_children = sortedChildren;
+    updateChildRows();
 
     for(auto& child : m_children) {
         child->sortChildren();
@@ -30,6 +30,7 @@
 #include <QSize>
 #include <QThread>
 
+#include <atomic>
 #include <ranges>
 #include <set>
 #include <stack>
@@ -80,6 +81,8 @@ struct LibraryTreeModel::Private
 
     QThread populatorThread;
     LibraryTreePopulator populator;
+    // Incremented on reset, so queued additions made before it are dropped
+    std::atomic<int> populateId{0};
 
     LibraryTreeItem allNode;
     NodeKeyMap pendingNodes;
@@ -115,6 +118,7 @@ struct LibraryTreeModel::Private
     {
         std::set<LibraryTreeItem*, cmpItems> items;
         std::set<LibraryTreeItem*> pendingItems;
+        int removedCount{0};
 
         for(const Track& track : tracks) {
             const int id = track.id();
@@ -122,6 +126,8 @@ struct LibraryTreeModel::Private
                 continue;
             }
 
+            ++removedCount;
+
             const auto trackNodes = trackParents[id];
             for(const QString& node : trackNodes) {
                 if(nodes.contains(node)) {
@@ -158,7 +164,7 @@ struct LibraryTreeModel::Private
         }
 
         if(updateCount) {
-            trackCount -= static_cast<int>(tracks.size());
+            trackCount -= removedCount;
             updateAllNode();
         }
     }
@@ -499,7 +505,7 @@ QModelIndexList LibraryTreeModel::findIndexes(const QStringList& values) const
         auto* item = stack.top();
         stack.pop();
 
-        const auto children = item->children();
+        const auto& children = item->children();
         for(auto* child : children) {
             if(values.contains(child->title()) && !child->pending()) {
                 indexes.append(indexOfItem(child));
@@ -546,10 +552,14 @@ void LibraryTreeModel::addTracks(const TrackList& tracks)
         return;
     }
 
-    p->trackCount += static_cast<int>(tracks.size());
+    p->trackCount += static_cast<int>(tracksToAdd.size());
     p->populatorThread.start();
 
-    QMetaObject::invokeMethod(&p->populator, [this, tracksToAdd] { p->populator.run(p->grouping, tracksToAdd); });
+    QMetaObject::invokeMethod(&p->populator, [this, tracksToAdd, id = p->populateId.load()] {
+        if(id == p->populateId) {
+            p->populator.run(p->grouping, tracksToAdd);
+        }
+    });
 }
 
 void LibraryTreeModel::updateTracks(const TrackList& tracks)
@@ -568,7 +578,11 @@ void LibraryTreeModel::updateTracks(const TrackList& tracks)
 
     p->populatorThread.start();
 
-    QMetaObject::invokeMethod(&p->populator, [this, tracksToUpdate] { p->populator.run(p->grouping, tracksToUpdate); });
+    QMetaObject::invokeMethod(&p->populator, [this, tracksToUpdate, id = p->populateId.load()] {
+        if(id == p->populateId) {
+            p->populator.run(p->grouping, tracksToUpdate);
+        }
+    });
 
     addTracks(tracks);
 }
@@ -610,9 +624,16 @@ void LibraryTreeModel::reset(const TrackList& tracks)
 
     p->resetting  = true;
     p->trackCount = static_cast<int>(tracks.size());
+    p->tracksPendingRemoval.clear();
+    ++p->populateId;
 
     QMetaObject::invokeMethod(&p->populator, [this, tracks] { p->populator.run(p->grouping, tracks); });
 }
+
+bool LibraryTreeModel::isPopulating() const
+{
+    return p->populatorThread.isRunning();
+}
 } // namespace Fooyin
 
 #include "moc_librarytreemodel.cpp"
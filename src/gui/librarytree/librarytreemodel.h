@@ -62,6 +62,9 @@ public:
     void changeGrouping(const LibraryTreeGrouping& grouping);
     void reset(const TrackList& tracks);
 
+    /** Returns @c true if tracks are still queued to be added to the model. */
+    [[nodiscard]] bool isPopulating() const;
+
 signals:
     void modelUpdated();
 
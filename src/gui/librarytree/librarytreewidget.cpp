@@ -26,6 +26,7 @@
 
 #include <core/library/musiclibrary.h>
 #include <core/library/trackfilter.h>
+#include <core/library/tracksearchindex.h>
 #include <core/library/tracksort.h>
 #include <gui/trackselectioncontroller.h>
 #include <utils/actions/widgetcontext.h>
@@ -34,6 +35,7 @@
 
 #include <QActionGroup>
 #include <QContextMenuEvent>
+#include <QFuture>
 #include <QHeaderView>
 #include <QJsonObject>
 #include <QMenu>
@@ -41,6 +43,7 @@
 #include <QVBoxLayout>
 
 #include <stack>
+#include <unordered_set>
 
 namespace {
 QModelIndexList filterAncestors(const QModelIndexList& indexes)
@@ -94,6 +97,28 @@ Fooyin::TrackList getSelectedTracks(const QTreeView* treeView, Fooyin::MusicLibr
 
     return tracks;
 }
+
+struct SearchResult
+{
+    Fooyin::TrackList tracks;
+    Fooyin::TrackList added;
+    Fooyin::TrackList removed;
+};
+
+// Tracks in @p tracks but not in @p other
+Fooyin::TrackList difference(const Fooyin::TrackList& tracks, const Fooyin::TrackList& other)
+{
+    std::unordered_set<int> ids;
+    ids.reserve(other.size());
+    for(const Fooyin::Track& track : other) {
+        ids.emplace(track.id());
+    }
+
+    Fooyin::TrackList result;
+    std::ranges::copy_if(tracks, std::back_inserter(result),
+                         [&ids](const Fooyin::Track& track) { return !ids.contains(track.id()); });
+    return result;
+}
 } // namespace
 
 namespace Fooyin {
@@ -119,8 +144,13 @@ struct LibraryTreeWidget::Private
     TrackAction doubleClickAction;
     TrackAction middleClickAction;
 
-    QString prevSearch;
-    TrackList prevSearchTracks;
+    QString search;
+    // The search the model currently reflects, and its results
+    QString shownSearch;
+    TrackList shownTracks;
+    QFuture<SearchResult> searchFuture;
+    int searchId{0};
+    bool rebuildPending{false};
 
     bool updating{false};
 
@@ -176,8 +206,17 @@ struct LibraryTreeWidget::Private
         });
     }
 
-    void reset() const
+    void reset()
     {
+        if(!search.isEmpty()) {
+            runSearch(true);
+            return;
+        }
+
+        cancelSearch();
+        rebuildPending = false;
+        shownSearch.clear();
+        shownTracks.clear();
         model->reset(library->tracks());
     }
 
@@ -240,23 +279,92 @@ struct LibraryTreeWidget::Private
         }
     }
 
-    void searchChanged(const QString& search)
+    void searchChanged(const QString& newSearch)
     {
-        const bool reset = prevSearch.length() > search.length();
-        prevSearch       = search;
+        search = newSearch;
+        runSearch(false);
+    }
 
-        if(search.isEmpty()) {
-            prevSearchTracks.clear();
-            model->reset(library->tracks());
-            return;
-        }
+    void cancelSearch()
+    {
+        searchFuture.cancel();
+        ++searchId;
+    }
+
+    void runSearch(bool rebuild)
+    {
+        cancelSearch();
+
+        // A cancelled rebuild still needs to happen
+        rebuild        = rebuild || rebuildPending;
+        rebuildPending = rebuild;
+
+        const int id = searchId;
 
-        const TrackList tracksToFilter = !reset && !prevSearchTracks.empty() ? prevSearchTracks : library->tracks();
+        // Every track matching a search also matches any substring of it
+        const bool refine = !rebuild && !shownSearch.isEmpty() && search.contains(shownSearch, Qt::CaseInsensitive);
 
-        const auto tracks = Filter::filterTracks(tracksToFilter, search);
+        const TrackList tracksToFilter = refine ? shownTracks : library->tracks();
+        const TrackList shown          = shownSearch.isEmpty() ? TrackList{} : shownTracks;
+        const bool showingAll          = shownSearch.isEmpty();
 
-        prevSearchTracks = tracks;
-        model->reset(tracks);
+        const TrackSearchIndex* index = &library->searchIndex();
+
+        searchFuture = Utils::asyncExec(
+            [search = search, tracksToFilter, shown, showingAll, refine, index](QPromise<SearchResult>& promise) {
+                SearchResult result;
+                const auto isCancelled = [&promise]() {
+                    return promise.isCanceled();
+                };
+
+                if(search.isEmpty()) {
+                    result.tracks = tracksToFilter;
+                }
+                else if(refine) {
+                    result.tracks = Filter::filterTracks(tracksToFilter, search, *index, isCancelled);
+                }
+                else {
+                    result.tracks = Filter::filterIndexedTracks(*index, search, tracksToFilter, isCancelled);
+                }
+
+                if(promise.isCanceled()) {
+                    return;
+                }
+
+                if(showingAll) {
+                    result.removed = difference(tracksToFilter, result.tracks);
+                }
+                else {
+                    result.added   = difference(result.tracks, shown);
+                    result.removed = difference(shown, result.tracks);
+                }
+
+                promise.addResult(std::move(result));
+            });
+
+        searchFuture.then(self, [this, id, search = search, rebuild](const SearchResult& result) {
+            if(id == searchId) {
+                applySearch(search, result, rebuild);
+            }
+        });
+    }
+
+    void applySearch(const QString& appliedSearch, const SearchResult& result, bool rebuild)
+    {
+        shownSearch    = appliedSearch;
+        shownTracks    = appliedSearch.isEmpty() ? TrackList{} : result.tracks;
+        rebuildPending = false;
+
+        // Rebuilding is cheaper than touching more rows than the result contains.
+        // Tracks still queued for the populator can't be removed yet, so rebuild rather than diff against them.
+        const size_t changes = result.added.size() + result.removed.size();
+        if(rebuild || changes > result.tracks.size() || model->isPopulating()) {
+            model->reset(result.tracks);
+            return;
+        }
+
+        model->removeTracks(result.removed);
+        model->addTracks(result.added);
     }
 
     [[nodiscard]] QString playlistNameFromSelection() const
@@ -308,13 +416,27 @@ struct LibraryTreeWidget::Private
             return;
         }
 
-        if(!prevSearch.isEmpty()) {
-            const auto filteredTracks = Filter::filterTracks(tracks, prevSearch);
+        if(!shownSearch.isEmpty()) {
+            const auto filteredTracks = Filter::filterTracks(tracks, shownSearch);
+            shownTracks.insert(shownTracks.end(), filteredTracks.cbegin(), filteredTracks.cend());
             model->addTracks(filteredTracks);
         }
         else {
             model->addTracks(tracks);
         }
+
+        if(searchFuture.isRunning()) {
+            // The pending search was started before these tracks existed
+            runSearch(false);
+        }
+    }
+
+    void handleTracksDeleted(const TrackList& tracks)
+    {
+        if(!shownTracks.empty()) {
+            shownTracks = difference(shownTracks, tracks);
+        }
+        model->removeTracks(tracks);
     }
 
     void handleTracksUpdated(const TrackList& tracks)
@@ -426,7 +548,8 @@ LibraryTreeWidget::LibraryTreeWidget(MusicLibrary* library, TrackSelectionContro
                      [this](const TrackList& tracks) { p->handleTracksUpdated(tracks); });
     QObject::connect(library, &MusicLibrary::tracksPlayed, this,
                      [this](const TrackList& tracks) { p->model->refreshTracks(tracks); });
-    QObject::connect(library, &MusicLibrary::tracksDeleted, p->model, &LibraryTreeModel::removeTracks);
+    QObject::connect(library, &MusicLibrary::tracksDeleted, this,
+                     [this](const TrackList& tracks) { p->handleTracksDeleted(tracks); });
     QObject::connect(library, &MusicLibrary::tracksSorted, this, [this]() { p->reset(); });
 }
 
@@ -0,0 +1,52 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <gui/metadatawriter.h>
+
+#include <core/library/musiclibrary.h>
+
+#include <QProgressDialog>
+
+namespace Fooyin::Gui {
+void writeTrackMetadata(MusicLibrary* library, const TrackList& tracks)
+{
+    if(!library || tracks.empty()) {
+        return;
+    }
+
+    auto* writeDialog
+        = new QProgressDialog(QStringLiteral("Writing metadata..."), QStringLiteral("Abort"), 0, 100, nullptr);
+    writeDialog->setAttribute(Qt::WA_DeleteOnClose);
+    writeDialog->setWindowModality(Qt::WindowModal);
+
+    const WriteRequest request = library->updateTrackMetadata(tracks);
+
+    QObject::connect(library, &MusicLibrary::writeProgress, writeDialog, [writeDialog, request](int id, int percent) {
+        if(id == request.id) {
+            writeDialog->setValue(percent);
+        }
+    });
+    QObject::connect(writeDialog, &QProgressDialog::canceled, writeDialog, [request]() { request.cancel(); });
+    QObject::connect(library, &MusicLibrary::writeFinished, writeDialog, [writeDialog, request](int id) {
+        if(id == request.id) {
+            writeDialog->deleteLater();
+        }
+    });
+}
+} // namespace Fooyin::Gui
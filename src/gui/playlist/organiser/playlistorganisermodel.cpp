@@ -296,7 +296,7 @@ QByteArray PlaylistOrganiserModel::saveModel()
         }
 
         if(item->type() != PlaylistOrganiserItem::PlaylistItem) {
-            const auto children = item->children();
+            const auto& children = item->children();
             stream << static_cast<qsizetype>(children.size());
             for(PlaylistOrganiserItem* child : children | std::views::reverse) {
                 itemsToSave.push(child);
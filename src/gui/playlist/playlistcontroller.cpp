@@ -71,6 +71,8 @@ struct PlaylistController::Private
             }
         }
 
+        handler->loadPlaylist(currentPlaylist);
+
         loaded = true;
         emit self->playlistsLoaded();
     }
@@ -400,6 +402,8 @@ void PlaylistController::changeCurrentPlaylist(Playlist* playlist)
         return;
     }
 
+    p->handler->loadPlaylist(playlist);
+
     auto* prevPlaylist = std::exchange(p->currentPlaylist, playlist);
 
     if(prevPlaylist == playlist) {
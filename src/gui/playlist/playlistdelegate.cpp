@@ -24,31 +24,106 @@
 #include <utils/utils.h>
 
 #include <QApplication>
+#include <QCache>
 #include <QPainter>
+#include <QStaticText>
+
+#include <tuple>
+
+namespace {
+constexpr auto MaxCachedLayouts = 8192;
+
+struct TextLayoutKey
+{
+    QString text;
+    QFont font;
+    QSize size;
+    int alignment{0};
+
+    bool operator==(const TextLayoutKey& other) const
+    {
+        return std::tie(text, font, size, alignment) == std::tie(other.text, other.font, other.size, other.alignment);
+    }
+};
+
+size_t qHash(const TextLayoutKey& key, size_t seed = 0)
+{
+    return qHashMulti(seed, key.text, key.font, key.size.width(), key.size.height(), key.alignment);
+}
+
+// Elided text and bounds of a single block, relative to the rect it is drawn in
+struct TextLayout
+{
+    QStaticText text;
+    QPoint textPos;
+    QRect bound;
+};
+
+using TextLayoutCache = QCache<TextLayoutKey, TextLayout>;
+
+const Fooyin::RichText& richText(const QVariant& var)
+{
+    static const Fooyin::RichText empty;
+
+    if(var.metaType() != QMetaType::fromType<Fooyin::RichText>()) {
+        return empty;
+    }
+    return *static_cast<const Fooyin::RichText*>(var.constData());
+}
+} // namespace
 
 namespace Fooyin {
+struct PlaylistDelegate::Private
+{
+    mutable TextLayoutCache layoutCache{MaxCachedLayouts};
+};
+
 struct DrawTextResult
 {
     QRect bound;
     int totalWidth{0};
 };
 
+const TextLayout* textLayout(TextLayoutCache& cache, QPainter* painter, const QRect& rect, const QString& text,
+                             Qt::Alignment alignment)
+{
+    TextLayoutKey key{text, painter->font(), rect.size(), static_cast<int>(alignment)};
+
+    if(const auto* layout = cache.object(key)) {
+        return layout;
+    }
+
+    const QRect area{QPoint{}, rect.size()};
+    const QString elided = painter->fontMetrics().elidedText(text, Qt::ElideRight, rect.width());
+
+    auto* layout    = new TextLayout();
+    layout->bound   = painter->boundingRect(area, alignment | Qt::TextWrapAnywhere, text);
+    layout->textPos = painter->boundingRect(area, alignment, elided).topLeft();
+    layout->text.setTextFormat(Qt::PlainText);
+    layout->text.setText(elided);
+    layout->text.prepare(painter->transform(), painter->font());
+
+    cache.insert(std::move(key), layout);
+
+    return layout;
+}
+
 template <typename Range>
-DrawTextResult drawTextBlocks(QPainter* painter, const QStyleOptionViewItem& option, QRect rect, const Range& blocks,
-                              Qt::Alignment alignment)
+DrawTextResult drawTextBlocks(TextLayoutCache& cache, QPainter* painter, const QStyleOptionViewItem& option, QRect rect,
+                              const Range& blocks, Qt::Alignment alignment)
 {
     DrawTextResult result;
 
-    QStyle* style     = option.widget ? option.widget->style() : QApplication::style();
-    const auto colour = option.state & QStyle::State_Selected ? QPalette::HighlightedText : QPalette::NoRole;
+    const bool selected = option.state & QStyle::State_Selected;
 
     for(const auto& block : blocks) {
         painter->setFont(block.format.font);
-        painter->setPen(block.format.colour);
+        painter->setPen(selected ? option.palette.color(QPalette::HighlightedText) : block.format.colour);
 
-        result.bound = painter->boundingRect(rect, alignment | Qt::TextWrapAnywhere, block.text);
-        style->drawItemText(painter, rect, alignment, option.palette, true,
-                            painter->fontMetrics().elidedText(block.text, Qt::ElideRight, rect.width()), colour);
+        const TextLayout* layout = textLayout(cache, painter, rect, block.text, alignment);
+
+        result.bound = layout->bound.translated(rect.topLeft());
+        painter->drawStaticText(rect.topLeft() + layout->textPos, layout->text);
 
         if(alignment & Qt::AlignRight) {
             rect.moveRight((rect.x() + rect.width()) - result.bound.width());
@@ -64,7 +139,8 @@ DrawTextResult drawTextBlocks(QPainter* painter, const QStyleOptionViewItem& opt
     return result;
 }
 
-void paintHeader(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index)
+void paintHeader(TextLayoutCache& cache, QPainter* painter, const QStyleOptionViewItem& option,
+                 const QModelIndex& index)
 {
     QStyleOptionViewItem opt{option};
     opt.text.clear();
@@ -80,11 +156,16 @@ void paintHeader(QPainter* painter, const QStyleOptionViewItem& option, const QM
     lineColour.setAlpha(40);
     linePen.setColor(lineColour);
 
-    const auto title    = index.data(PlaylistItem::Role::Title).value<RichText>();
-    const auto subtitle = index.data(PlaylistItem::Role::Subtitle).value<RichText>();
-    const auto side     = index.data(PlaylistItem::Role::Right).value<RichText>();
-    const auto info     = index.data(PlaylistItem::Role::Info).value<RichText>();
-    const auto cover    = index.data(Qt::DecorationRole).value<QPixmap>();
+    const QVariant titleVar    = index.data(PlaylistItem::Role::Title);
+    const QVariant subtitleVar = index.data(PlaylistItem::Role::Subtitle);
+    const QVariant sideVar     = index.data(PlaylistItem::Role::Right);
+    const QVariant infoVar     = index.data(PlaylistItem::Role::Info);
+
+    const RichText& title    = richText(titleVar);
+    const RichText& subtitle = richText(subtitleVar);
+    const RichText& side     = richText(sideVar);
+    const RichText& info     = richText(infoVar);
+    const auto cover         = index.data(Qt::DecorationRole).value<QPixmap>();
 
     const QRect& rect           = opt.rect;
     const int halfWidth         = rect.width() / 2;
@@ -107,7 +188,8 @@ void paintHeader(QPainter* painter, const QStyleOptionViewItem& option, const QM
 
     const QRect rightRect{rect.left() + halfWidth, rect.top(), halfWidth - offset, rect.height()};
     const auto [rightBound, totalRightWidth]
-        = drawTextBlocks(painter, opt, rightRect, side | std::views::reverse, Qt::AlignVCenter | Qt::AlignRight);
+        = drawTextBlocks(cache, painter, opt, rightRect, side | std::views::reverse,
+                         Qt::AlignVCenter | Qt::AlignRight);
 
     const int leftWidth = rect.width() - coverFrameRect.width() - totalRightWidth;
 
@@ -116,13 +198,13 @@ void paintHeader(QPainter* painter, const QStyleOptionViewItem& option, const QM
         subtitleRect.setWidth(subtitleRect.width() - (5 * offset));
     }
     const auto [subtitleBound, _]
-        = drawTextBlocks(painter, opt, subtitleRect, subtitle, Qt::AlignVCenter | Qt::AlignLeft);
+        = drawTextBlocks(cache, painter, opt, subtitleRect, subtitle, Qt::AlignVCenter | Qt::AlignLeft);
 
     const QRect titleRect{coverFrameRect.right() + 2 * offset, rect.top() + titleOffset, leftWidth, rect.height()};
-    drawTextBlocks(painter, opt, titleRect, title, Qt::AlignTop);
+    drawTextBlocks(cache, painter, opt, titleRect, title, Qt::AlignTop);
 
     const QRect infoRect{coverFrameRect.right() + 2 * offset, rect.top() - infoOffset, leftWidth, rect.height()};
-    drawTextBlocks(painter, opt, infoRect, info, Qt::AlignBottom);
+    drawTextBlocks(cache, painter, opt, infoRect, info, Qt::AlignBottom);
 
     const QLineF headerLine(coverFrameRect.right() + 2 * offset, coverFrameRect.bottom() + coverFrameWidth,
                             rect.right() - offset, coverFrameRect.bottom() + coverFrameWidth);
@@ -153,7 +235,8 @@ void paintHeader(QPainter* painter, const QStyleOptionViewItem& option, const QM
     }
 }
 
-void paintSimpleHeader(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index)
+void paintSimpleHeader(TextLayoutCache& cache, QPainter* painter, const QStyleOptionViewItem& option,
+                       const QModelIndex& index)
 {
     QStyleOptionViewItem opt{option};
     opt.text.clear();
@@ -169,8 +252,10 @@ void paintSimpleHeader(QPainter* painter, const QStyleOptionViewItem& option, co
     lineColour.setAlpha(40);
     linePen.setColor(lineColour);
 
-    const auto title    = index.data(PlaylistItem::Role::Title).value<RichText>();
-    const auto subtitle = index.data(PlaylistItem::Role::Right).value<RichText>();
+    const QVariant titleVar    = index.data(PlaylistItem::Role::Title);
+    const QVariant subtitleVar = index.data(PlaylistItem::Role::Right);
+    const RichText& title      = richText(titleVar);
+    const RichText& subtitle   = richText(subtitleVar);
 
     const QRect& rect           = opt.rect;
     const int height            = rect.height();
@@ -179,13 +264,14 @@ void paintSimpleHeader(QPainter* painter, const QStyleOptionViewItem& option, co
 
     const QRect rightRect{rect.left() + halfWidth, rect.top(), halfWidth - offset, height};
     auto [rightBound, totalRightWidth]
-        = drawTextBlocks(painter, opt, rightRect, subtitle | std::views::reverse, Qt::AlignVCenter | Qt::AlignRight);
+        = drawTextBlocks(cache, painter, opt, rightRect, subtitle | std::views::reverse,
+                         Qt::AlignVCenter | Qt::AlignRight);
 
     QRect leftRect{rect.left() + offset, rect.top(), rect.width() - totalRightWidth, height};
     if(totalRightWidth > 0) {
         leftRect.setWidth(leftRect.width() - (4 * offset));
     }
-    auto [leftBound, _] = drawTextBlocks(painter, opt, leftRect, title, Qt::AlignVCenter | Qt::AlignLeft);
+    auto [leftBound, _] = drawTextBlocks(cache, painter, opt, leftRect, title, Qt::AlignVCenter | Qt::AlignLeft);
 
     if(!title.empty()) {
         if(subtitle.empty()) {
@@ -202,7 +288,8 @@ void paintSimpleHeader(QPainter* painter, const QStyleOptionViewItem& option, co
     }
 }
 
-void paintSubheader(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index)
+void paintSubheader(TextLayoutCache& cache, QPainter* painter, const QStyleOptionViewItem& option,
+                    const QModelIndex& index)
 {
     QStyleOptionViewItem opt{option};
 
@@ -216,8 +303,10 @@ void paintSubheader(QPainter* painter, const QStyleOptionViewItem& option, const
     lineColour.setAlpha(40);
     linePen.setColor(lineColour);
 
-    const auto title    = index.data(PlaylistItem::Role::Title).value<RichText>();
-    const auto subtitle = index.data(PlaylistItem::Role::Subtitle).value<RichText>();
+    const QVariant titleVar    = index.data(PlaylistItem::Role::Title);
+    const QVariant subtitleVar = index.data(PlaylistItem::Role::Subtitle);
+    const RichText& title      = richText(titleVar);
+    const RichText& subtitle   = richText(subtitleVar);
 
     const QRect& rect           = opt.rect;
     const int height            = rect.height();
@@ -226,13 +315,14 @@ void paintSubheader(QPainter* painter, const QStyleOptionViewItem& option, const
 
     const QRect rightRect{rect.left() + halfWidth, rect.top(), halfWidth - offset, height};
     auto [rightBound, totalRightWidth]
-        = drawTextBlocks(painter, opt, rightRect, subtitle | std::views::reverse, Qt::AlignVCenter | Qt::AlignRight);
+        = drawTextBlocks(cache, painter, opt, rightRect, subtitle | std::views::reverse,
+                         Qt::AlignVCenter | Qt::AlignRight);
 
     QRect leftRect{rect.left() + offset, rect.top(), rect.width() - totalRightWidth, height};
     if(totalRightWidth > 0) {
         leftRect.setWidth(leftRect.width() - (4 * offset));
     }
-    auto [leftBound, _] = drawTextBlocks(painter, opt, leftRect, title, Qt::AlignVCenter | Qt::AlignLeft);
+    auto [leftBound, _] = drawTextBlocks(cache, painter, opt, leftRect, title, Qt::AlignVCenter | Qt::AlignLeft);
 
     if(title.empty()) {
         leftBound = {rect.left(), rect.top(), 0, height};
@@ -251,7 +341,8 @@ void paintSubheader(QPainter* painter, const QStyleOptionViewItem& option, const
     painter->drawLine(titleLine);
 }
 
-void paintTrack(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index)
+void paintTrack(TextLayoutCache& cache, QPainter* painter, const QStyleOptionViewItem& option,
+                const QModelIndex& index)
 {
     QStyleOptionViewItem opt{option};
 
@@ -272,17 +363,19 @@ void paintTrack(QPainter* painter, const QStyleOptionViewItem& option, const QMo
     opt.decorationAlignment = opt.displayAlignment;
 
     if(singleColumn) {
-        const auto icon      = QIcon{index.data(Qt::DecorationRole).value<QPixmap>()};
-        const int indent     = icon.isNull() ? 0 : opt.decorationSize.width() + textMargin;
-        const auto leftSide  = index.data(PlaylistItem::Role::Left).value<RichText>();
-        const auto rightSide = index.data(PlaylistItem::Role::Right).value<RichText>();
+        const auto icon             = QIcon{index.data(Qt::DecorationRole).value<QPixmap>()};
+        const int indent            = icon.isNull() ? 0 : opt.decorationSize.width() + textMargin;
+        const QVariant leftSideVar  = index.data(PlaylistItem::Role::Left);
+        const QVariant rightSideVar = index.data(PlaylistItem::Role::Right);
+        const RichText& leftSide    = richText(leftSideVar);
+        const RichText& rightSide   = richText(rightSideVar);
 
         const QRect rightRect     = textRect.adjusted(textRect.center().x() - textRect.left(), 0, -textMargin, 0);
-        auto [_, totalRightWidth] = drawTextBlocks(painter, opt, rightRect, rightSide | std::views::reverse,
+        auto [_, totalRightWidth] = drawTextBlocks(cache, painter, opt, rightRect, rightSide | std::views::reverse,
                                                    Qt::AlignVCenter | Qt::AlignRight);
 
         const QRect leftRect = textRect.adjusted(indent + textMargin, 0, -totalRightWidth, 0);
-        drawTextBlocks(painter, opt, leftRect, leftSide, Qt::AlignVCenter | Qt::AlignLeft);
+        drawTextBlocks(cache, painter, opt, leftRect, leftSide, Qt::AlignVCenter | Qt::AlignLeft);
 
         if(!icon.isNull()) {
             opt.rect.setX(opt.rect.x() + textMargin);
@@ -304,10 +397,11 @@ void paintTrack(QPainter* painter, const QStyleOptionViewItem& option, const QMo
             }
         }
         else {
-            const auto columnText = index.data(PlaylistItem::Role::Column).value<RichText>();
+            const QVariant columnTextVar = index.data(PlaylistItem::Role::Column);
+            const RichText& columnText   = richText(columnTextVar);
 
             const QRect columnRect = textRect.adjusted(textMargin, 0, -textMargin, 0);
-            drawTextBlocks(painter, opt, columnRect, columnText, Qt::AlignVCenter | opt.displayAlignment);
+            drawTextBlocks(cache, painter, opt, columnRect, columnText, Qt::AlignVCenter | opt.displayAlignment);
 
             const auto icon = QIcon{index.data(Qt::DecorationRole).value<QPixmap>()};
             if(!icon.isNull()) {
@@ -317,6 +411,13 @@ void paintTrack(QPainter* painter, const QStyleOptionViewItem& option, const QMo
     }
 }
 
+PlaylistDelegate::PlaylistDelegate(QObject* parent)
+    : QStyledItemDelegate{parent}
+    , p{std::make_unique<Private>()}
+{ }
+
+PlaylistDelegate::~PlaylistDelegate() = default;
+
 void PlaylistDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const
 {
     painter->save();
@@ -327,15 +428,16 @@ void PlaylistDelegate::paint(QPainter* painter, const QStyleOptionViewItem& opti
     const auto type = index.data(PlaylistItem::Type).toInt();
     switch(type) {
         case(PlaylistItem::Track):
-            paintTrack(painter, opt, index);
+            paintTrack(p->layoutCache, painter, opt, index);
             break;
         case(PlaylistItem::Header): {
             const auto simple = index.data(PlaylistItem::Simple).toBool();
-            simple ? paintSimpleHeader(painter, opt, index) : paintHeader(painter, opt, index);
+            simple ? paintSimpleHeader(p->layoutCache, painter, opt, index)
+                   : paintHeader(p->layoutCache, painter, opt, index);
             break;
         }
         case(PlaylistItem::Subheader):
-            paintSubheader(painter, opt, index);
+            paintSubheader(p->layoutCache, painter, opt, index);
             break;
         default:
             break;
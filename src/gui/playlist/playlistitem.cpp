@@ -127,9 +127,31 @@ void PlaylistItem::insertChild(int row, PlaylistItem* child)
     m_state = State::Update;
 }
 
+void PlaylistItem::insertChildren(int row, const std::vector<PlaylistItem*>& children)
+{
+    TreeItem::insertChildren(row, children);
+    m_state = State::Update;
+}
+
 void PlaylistItem::removeChild(int index)
 {
     TreeItem::removeChild(index);
     m_state = childCount() == 0 ? State::Delete : State::Update;
 }
+
+void PlaylistItem::removeChildren(int index, int count)
+{
+    TreeItem::removeChildren(index, count);
+    m_state = childCount() == 0 ? State::Delete : State::Update;
+}
+
+int PlaylistItem::moveChildren(PlaylistItem* source, const std::vector<PlaylistItem*>& children, int row)
+{
+    const int nextRow = TreeItem::moveChildren(source, children, row);
+    if(source) {
+        source->m_state = source->childCount() == 0 ? State::Delete : State::Update;
+    }
+    m_state = State::Update;
+    return nextRow;
+}
 } // namespace Fooyin
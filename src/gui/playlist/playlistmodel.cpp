@@ -47,6 +47,7 @@
 #include <queue>
 #include <span>
 #include <stack>
+#include <unordered_set>
 
 namespace {
 bool cmpItemsPlaylistItems(Fooyin::PlaylistItem* pItem1, Fooyin::PlaylistItem* pItem2, bool reverse = false)
@@ -94,6 +95,23 @@ struct cmpItemsReverse
 
 using ItemPtrSet = std::set<Fooyin::PlaylistItem*, cmpItemsReverse>;
 
+// Returns the item after item in display order, or nullptr if item is the last
+Fooyin::PlaylistItem* nextItem(Fooyin::PlaylistItem* item)
+{
+    if(item->childCount() > 0) {
+        return item->child(0);
+    }
+
+    while(Fooyin::PlaylistItem* parent = item->parent()) {
+        if(Fooyin::PlaylistItem* sibling = parent->child(item->row() + 1)) {
+            return sibling;
+        }
+        item = parent;
+    }
+
+    return nullptr;
+}
+
 bool cmpTrackIndices(const QModelIndex& index1, const QModelIndex& index2)
 {
     QModelIndex item1{index1};
@@ -908,8 +926,7 @@ MoveOperation PlaylistModel::moveTracks(const MoveOperation& operation)
             row = dropMoveRows(sourceParent, children, targetParent, row);
             endMoveRows();
 
-            updateTrackIndexes();
-            rootItem()->resetChildren();
+            updateTrackIndexes(children, std::max(0, std::min(sourceIndex, targetIndex)));
 
             pendingGroups.emplace_back(reverseIndex, MoveOperationItemGroups{children});
         }
@@ -1662,8 +1679,8 @@ PlaylistModel::DropTargetResult PlaylistModel::findDropTarget(PlaylistItem* sour
                 PlaylistItem* newParent = cloneParent(m_nodes, parent);
 
                 PlaylistItemList children;
-                PlaylistItemList parentChildren = parent->children();
-                const auto childrenToMove       = parentChildren | std::views::drop(row);
+                const auto& parentChildren = parent->children();
+                const auto childrenToMove  = parentChildren | std::views::drop(row);
                 std::ranges::copy(childrenToMove, std::back_inserter(children));
 
                 splitParents.emplace_back(parent, newParent, row, finalRow, children);
@@ -1821,8 +1838,6 @@ void PlaylistModel::handleTrackGroup(PendingData& data)
         }
     }
 
-    rootItem()->resetChildren();
-
     mergeTrackParents(data.trackParents);
 
     cleanupHeaders();
@@ -1846,61 +1861,39 @@ int PlaylistModel::dropInsertRows(const PlaylistItemList& rows, const QModelInde
         return row;
     }
 
+    PlaylistItemList newChildren;
+    newChildren.reserve(rows.size());
+
     for(Fooyin::PlaylistItem* childItem : rows) {
-        childItem->resetRow();
         auto* newChild = &m_nodes.emplace(childItem->key(), *childItem).first->second;
-
-        targetParent->insertChild(row, newChild);
         newChild->setPending(false);
-        row++;
+        newChildren.emplace_back(newChild);
     }
-    targetParent->resetChildren();
 
-    return row;
+    targetParent->insertChildren(row, newChildren);
+
+    return row + static_cast<int>(newChildren.size());
 }
 
 int PlaylistModel::dropMoveRows(const QModelIndex& source, const PlaylistItemList& rows, const QModelIndex& target,
                                 int row)
 {
-    int currRow{row};
     auto* targetParent = itemForIndex(target);
     if(!targetParent) {
-        return currRow;
+        return row;
     }
 
     auto* sourceParent = itemForIndex(source);
-    for(Fooyin::PlaylistItem* childItem : rows) {
-        childItem->resetRow();
-        const int oldRow = childItem->row();
-        if(oldRow < currRow) {
-            targetParent->insertChild(currRow, childItem);
-            sourceParent->removeChild(oldRow);
-
-            if(source != target) {
-                ++currRow;
-            }
-        }
-        else {
-            sourceParent->removeChild(oldRow);
-            targetParent->insertChild(currRow, childItem);
-
-            ++currRow;
-        }
-    }
-    sourceParent->resetChildren();
-    targetParent->resetChildren();
-
-    return currRow;
+    return targetParent->moveChildren(sourceParent, rows, row);
 }
 
-int PlaylistModel::dropCopyRows(const QModelIndex& source, const PlaylistItemList& rows, const QModelIndex& target,
-                                int row)
+int PlaylistModel::dropCopyRows(const QModelIndex& /*source*/, const PlaylistItemList& rows,
+                                const QModelIndex& target, int row)
 {
-    return dropCopyRowsRecursive(source, rows, target, row);
+    return dropCopyRowsRecursive(rows, target, row);
 }
 
-int PlaylistModel::dropCopyRowsRecursive(const QModelIndex& source, const PlaylistItemList& rows,
-                                         const QModelIndex& target, int row)
+int PlaylistModel::dropCopyRowsRecursive(const PlaylistItemList& rows, const QModelIndex& target, int row)
 {
     int currRow{row};
     auto* targetParent = itemForIndex(target);
@@ -1908,9 +1901,7 @@ int PlaylistModel::dropCopyRowsRecursive(const QModelIndex& source, const Playli
         return currRow;
     }
 
-    auto* sourceParent = itemForIndex(source);
     for(Fooyin::PlaylistItem* childItem : rows) {
-        childItem->resetRow();
         const QString newKey = Fooyin::Utils::generateRandomHash();
         auto* newChild       = &m_nodes.emplace(newKey, *childItem).first->second;
         newChild->clearChildren();
@@ -1918,17 +1909,11 @@ int PlaylistModel::dropCopyRowsRecursive(const QModelIndex& source, const Playli
 
         targetParent->insertChild(currRow, newChild);
 
-        const QModelIndex childSourceIndex = indexOfItem(childItem);
-        const QModelIndex childTargetIndex = indexOfItem(newChild);
-
-        dropCopyRowsRecursive(childSourceIndex, childItem->children(), childTargetIndex, 0);
+        dropCopyRowsRecursive(childItem->children(), indexOfItem(newChild), 0);
 
         ++currRow;
     }
 
-    sourceParent->resetChildren();
-    targetParent->resetChildren();
-
     return currRow;
 }
 
@@ -1943,10 +1928,9 @@ bool PlaylistModel::insertPlaylistRows(const QModelIndex& target, int firstRow,
     auto* parent = itemForIndex(target);
 
     beginInsertRows(target, firstRow, lastRow);
+    parent->insertChildren(firstRow, children);
     for(PlaylistItem* child : children) {
-        parent->insertChild(firstRow, child);
         child->setPending(false);
-        firstRow += 1;
     }
     endInsertRows();
 
@@ -1980,14 +1964,11 @@ bool PlaylistModel::removePlaylistRows(int row, int count, const QModelIndex& pa
         return false;
     }
 
-    int lastRow = row + count - 1;
-    beginRemoveRows(parent, row, lastRow);
-    while(lastRow >= row) {
-        deleteNodes(itemForIndex(index(lastRow, 0, parent)));
-        parentItem->removeChild(lastRow);
-        --lastRow;
+    beginRemoveRows(parent, row, row + count - 1);
+    for(int i{row}; i < row + count; ++i) {
+        deleteNodes(parentItem->child(i));
     }
-    parentItem->resetChildren();
+    parentItem->removeChildren(row, count);
     endRemoveRows();
 
     return true;
@@ -2044,7 +2025,7 @@ void PlaylistModel::mergeHeaders()
     headers.emplace_back(rootItem());
 
     auto addChildren = [&headers](PlaylistItem* parent) {
-        const auto children = parent->children();
+        const auto& children = parent->children();
         for(PlaylistItem* child : children) {
             headers.emplace_back(child);
         }
@@ -2096,8 +2077,6 @@ void PlaylistModel::mergeHeaders()
             }
         }
     }
-
-    rootItem()->resetChildren();
 }
 
 void PlaylistModel::updateHeaders()
@@ -2149,21 +2128,72 @@ void PlaylistModel::updateTrackIndexes()
             node->setIndex(index++);
         }
 
-        const auto children = node->children();
+        const auto& children = node->children();
         for(PlaylistItem* child : children | std::views::reverse) {
             trackNodes.push(child);
         }
     }
 }
 
+void PlaylistModel::updateTrackIndexes(const PlaylistItemList& moved, int first)
+{
+    // Only tracks from first up to the end of the moved range change index,
+    // so stop once every moved track has been seen and the indexes line up again
+    std::unordered_set<PlaylistItem*> movedTracks;
+    std::stack<PlaylistItem*> movedNodes;
+    for(PlaylistItem* item : moved) {
+        movedNodes.push(item);
+    }
+    while(!movedNodes.empty()) {
+        PlaylistItem* node = movedNodes.top();
+        movedNodes.pop();
+        if(node->type() == PlaylistItem::Track) {
+            movedTracks.emplace(node);
+        }
+        for(PlaylistItem* child : node->children()) {
+            movedNodes.push(child);
+        }
+    }
+
+    PlaylistItem* node{nullptr};
+    if(first == 0) {
+        node = nextItem(rootItem());
+    }
+    else if(m_trackIndexes.contains(first - 1) && m_nodes.contains(m_trackIndexes.at(first - 1))) {
+        node = nextItem(&m_nodes.at(m_trackIndexes.at(first - 1)));
+    }
+    else {
+        updateTrackIndexes();
+        return;
+    }
+
+    int index{first};
+    auto remaining = movedTracks.size();
+
+    for(; node; node = nextItem(node)) {
+        if(node->type() != PlaylistItem::Track) {
+            continue;
+        }
+
+        if(movedTracks.contains(node)) {
+            --remaining;
+        }
+        else if(remaining == 0 && node->index() == index) {
+            break;
+        }
+
+        m_trackIndexes.insert_or_assign(index, node->key());
+        node->setIndex(index++);
+    }
+}
+
 void PlaylistModel::deleteNodes(PlaylistItem* node)
 {
     if(!node) {
         return;
     }
 
-    const auto children = node->children();
-    for(PlaylistItem* child : children) {
+    for(PlaylistItem* child : node->children()) {
         deleteNodes(child);
     }
 
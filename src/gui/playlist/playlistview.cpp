@@ -22,6 +22,7 @@
 #include "playlistitem.h"
 #include "playlistmodel.h"
 
+#include <utils/fenwicktree.h>
 #include <utils/widgets/autoheaderview.h>
 
 #include <QDrag>
@@ -133,6 +134,8 @@ public:
     int itemAbove(int item) const;
     int itemBelow(int item) const;
     void invalidateHeightCache(int item) const;
+    void invalidateHeightIndex() const;
+    void updateHeightIndex() const;
     int pageUp(int i) const;
     int pageDown(int i) const;
     int itemForHomeKey() const;
@@ -181,6 +184,9 @@ public:
     bool m_playlistLoaded{false};
 
     mutable std::vector<PlaylistViewItem> m_viewItems;
+    // Height + padding of each view item, for O(log n) coordinate lookups
+    mutable FenwickTree<int> m_heightIndex;
+    mutable bool m_heightIndexValid{false};
     mutable int m_lastViewedItem{0};
     int m_defaultItemHeight{20};
 
@@ -255,10 +261,8 @@ void PlaylistView::Private::updateScrollBars() const
 
     auto* verticalBar = m_self->verticalScrollBar();
 
-    int contentsHeight{0};
-    for(int i{0}; i < itemCount; ++i) {
-        contentsHeight += itemHeight(i) + itemPadding(i);
-    }
+    updateHeightIndex();
+    const int contentsHeight = m_heightIndex.total();
 
     verticalBar->setRange(0, contentsHeight - viewportSize.height());
     verticalBar->setPageStep(viewportSize.height());
@@ -302,23 +306,23 @@ int PlaylistView::Private::itemAtCoordinate(int coordinate, bool includePadding)
         return -1;
     }
 
+    updateHeightIndex();
+
     const int contentsCoord = coordinate + m_self->verticalScrollBar()->value();
 
-    int itemCoord{0};
-    for(int index{0}; index < itemCount; ++index) {
-        const int height  = itemHeight(index);
-        const int padding = itemPadding(index);
-        itemCoord += height + padding;
+    const int index = m_heightIndex.upperBound(contentsCoord);
+    if(index >= itemCount) {
+        return -1;
+    }
 
-        if(itemCoord > contentsCoord) {
-            if(includePadding && (itemCoord - padding) < contentsCoord) {
-                return -1;
-            }
-            return index >= itemCount ? -1 : index;
+    if(includePadding) {
+        const int itemCoord = m_heightIndex.prefixSum(index + 1);
+        if((itemCoord - itemPadding(index)) < contentsCoord) {
+            return -1;
         }
     }
 
-    return -1;
+    return index;
 }
 
 QModelIndex PlaylistView::Private::modelIndex(int i, int column) const
@@ -587,6 +591,10 @@ int PlaylistView::Private::itemHeight(int item) const
     if(height <= 0) {
         height                   = indexRowSizeHint(index);
         m_viewItems[item].height = height;
+
+        if(m_heightIndexValid && m_heightIndex.size() == itemCount()) {
+            m_heightIndex.set(item, std::max(height, 0) + itemPadding(item));
+        }
     }
 
     return std::max(height, 0);
@@ -603,20 +611,30 @@ int PlaylistView::Private::itemPadding(int item) const
 
 int PlaylistView::Private::coordinateForItem(int item) const
 {
-    for(int index{0}, y{0}; const auto& viewItem : m_viewItems) {
-        if(index == item) {
-            return y - m_self->verticalScrollBar()->value();
-        }
-        y += itemHeight(index++) + viewItem.padding;
+    if(item < 0 || item >= itemCount()) {
+        return 0;
     }
 
-    return 0;
+    updateHeightIndex();
+
+    return m_heightIndex.prefixSum(item) - m_self->verticalScrollBar()->value();
 }
 
 void PlaylistView::Private::insertViewItems(int pos, int count, const PlaylistViewItem& viewItem)
 {
+    const bool indexValid = m_heightIndexValid && m_heightIndex.size() == itemCount();
+
     m_viewItems.insert(m_viewItems.begin() + pos, count, viewItem);
 
+    // The new items are measured as they're laid out, which updates their heights in place
+    if(indexValid) {
+        m_heightIndex.insert(pos, count, 0);
+    }
+    else {
+        invalidateHeightIndex();
+    }
+
+    // Shifting the items is already linear in those after pos, so renumbering their parents doesn't add to it
     const int itemCount = this->itemCount();
     for(int i{pos + count}; i < itemCount; i++) {
         if(m_viewItems.at(i).parentItem >= pos) {
@@ -675,6 +693,8 @@ void PlaylistView::Private::recalculatePadding()
             item.padding            = (max > sectionHeight) ? max - sectionHeight : 0;
         }
     }
+
+    invalidateHeightIndex();
 }
 
 void PlaylistView::Private::layout(int i, bool afterIsUninitialised)
@@ -706,6 +726,7 @@ void PlaylistView::Private::layout(int i, bool afterIsUninitialised)
 
     if(i == -1) {
         m_viewItems.resize(count);
+        invalidateHeightIndex();
         afterIsUninitialised = true;
     }
     else if(m_viewItems[i].childCount != count) {
@@ -714,6 +735,7 @@ void PlaylistView::Private::layout(int i, bool afterIsUninitialised)
         }
         else if(count > 0) {
             m_viewItems.resize(itemCount() + count);
+            invalidateHeightIndex();
         }
     }
 
@@ -739,6 +761,11 @@ void PlaylistView::Private::layout(int i, bool afterIsUninitialised)
         item->hasMoreSiblings = false;
         item->hasChildren     = m_model->hasChildren(currentIndex);
 
+        // Items inserted into a valid height index start with no height, so measure them now
+        if(m_heightIndexValid) {
+            itemHeight(last);
+        }
+
         if(item->hasChildren) {
             layout(last, afterIsUninitialised);
             item = &m_viewItems[last];
@@ -793,6 +820,32 @@ int PlaylistView::Private::itemBelow(int item) const
 void PlaylistView::Private::invalidateHeightCache(int item) const
 {
     m_viewItems[item].height = 0;
+
+    if(m_heightIndexValid) {
+        itemHeight(item);
+    }
+}
+
+void PlaylistView::Private::invalidateHeightIndex() const
+{
+    m_heightIndexValid = false;
+}
+
+void PlaylistView::Private::updateHeightIndex() const
+{
+    const int count = itemCount();
+
+    if(m_heightIndexValid && m_heightIndex.size() == count) {
+        return;
+    }
+
+    std::vector<int> heights(count);
+    for(int i{0}; i < count; ++i) {
+        heights[i] = itemHeight(i) + itemPadding(i);
+    }
+
+    m_heightIndex.assign(heights);
+    m_heightIndexValid = true;
 }
 
 int PlaylistView::Private::pageUp(int i) const
@@ -1583,20 +1636,19 @@ bool PlaylistView::Private::isIndexValid(const QModelIndex& index) const
 
 int PlaylistView::Private::firstVisibleItem(int* offset) const
 {
+    updateHeightIndex();
+
     const int value = m_self->verticalScrollBar()->value();
 
-    int y{0};
-    for(int i{0}; i < itemCount(); ++i) {
-        const int itemHeight = this->itemHeight(i) + itemPadding(i);
-        y += itemHeight;
-        if(y > value) {
-            if(offset) {
-                *offset = y - value - itemHeight;
-            }
-            return i;
-        }
+    const int i = m_heightIndex.upperBound(value);
+    if(i >= itemCount()) {
+        return -1;
     }
-    return -1;
+
+    if(offset) {
+        *offset = m_heightIndex.prefixSum(i) - value;
+    }
+    return i;
 }
 
 int PlaylistView::Private::lastVisibleItem(int firstVisual, int offset) const
@@ -1608,19 +1660,16 @@ int PlaylistView::Private::lastVisibleItem(int firstVisual, int offset) const
         }
     }
 
-    int y{-offset};
-    const int value = m_self->viewport()->height();
+    updateHeightIndex();
 
+    const int value = m_self->viewport()->height();
     const int count = itemCount();
-    for(int i{firstVisual}; i < count; ++i) {
-        const int itemHeight = this->itemHeight(i) + itemPadding(i);
-        y += itemHeight;
-        if(y > value) {
-            return i;
-        }
-    }
 
-    return count - 1;
+    // First item whose bottom edge, relative to the viewport, is past the viewport height
+    const int target = value + offset + m_heightIndex.prefixSum(firstVisual);
+    const int i      = std::max(firstVisual, m_heightIndex.upperBound(target));
+
+    return std::min(i, count - 1);
 }
 
 std::pair<int, int> PlaylistView::Private::startAndEndColumns(const QRect& rect) const
@@ -1952,6 +2001,7 @@ void PlaylistView::doItemsLayout()
 
     p->m_layingOutItems = true;
     p->m_viewItems.clear();
+    p->invalidateHeightIndex();
 
     if(p->m_model && p->m_model->hasChildren(rootIndex())) {
         p->layout(-1);
@@ -2338,6 +2388,7 @@ void PlaylistView::rowsInserted(const QModelIndex& parent, int start, int end)
 void PlaylistView::rowsRemoved(const QModelIndex& /*parent*/, int /*first*/, int /*last*/)
 {
     p->m_viewItems.clear();
+    p->invalidateHeightIndex();
     p->doDelayedItemsLayout();
 
     setState(QAbstractItemView::NoState);
@@ -21,12 +21,14 @@
 
 #include <core/coresettings.h>
 #include <core/engine/enginehandler.h>
+#include <core/engine/replaygain.h>
 #include <gui/guiconstants.h>
 #include <utils/expandingcombobox.h>
 #include <utils/settings/settingsmanager.h>
 
 #include <QCheckBox>
 #include <QComboBox>
+#include <QDoubleSpinBox>
 #include <QGridLayout>
 #include <QGroupBox>
 #include <QLabel>
@@ -57,6 +59,13 @@ private:
 
     QCheckBox* m_gaplessPlayback;
     QSpinBox* m_bufferSize;
+    QSpinBox* m_nextTrackPreload;
+    QSpinBox* m_crossfadeLength;
+    QSpinBox* m_fadeLength;
+
+    QComboBox* m_replayGainMode;
+    QDoubleSpinBox* m_replayGainPreamp;
+    QCheckBox* m_preventClipping;
 };
 
 EnginePageWidget::EnginePageWidget(SettingsManager* settings, EngineController* engine)
@@ -66,6 +75,12 @@ EnginePageWidget::EnginePageWidget(SettingsManager* settings, EngineController*
     , m_deviceBox{new ExpandingComboBox(this)}
     , m_gaplessPlayback{new QCheckBox(tr("Gapless playback"), this)}
     , m_bufferSize{new QSpinBox(this)}
+    , m_nextTrackPreload{new QSpinBox(this)}
+    , m_crossfadeLength{new QSpinBox(this)}
+    , m_fadeLength{new QSpinBox(this)}
+    , m_replayGainMode{new QComboBox(this)}
+    , m_replayGainPreamp{new QDoubleSpinBox(this)}
+    , m_preventClipping{new QCheckBox(tr("Prevent clipping according to peak"), this)}
 {
     auto* outputLabel = new QLabel(tr("Output") + QStringLiteral(":"), this);
     auto* deviceLabel = new QLabel(tr("Device") + QStringLiteral(":"), this);
@@ -88,17 +103,73 @@ EnginePageWidget::EnginePageWidget(SettingsManager* settings, EngineController*
     generalLayout->addWidget(bufferLabel, 1, 0);
     generalLayout->addWidget(m_bufferSize, 1, 1);
 
+    auto* preloadLabel = new QLabel(tr("Open next track") + QStringLiteral(":"), this);
+    preloadLabel->setToolTip(tr("How long before the end of the current track to open and start decoding the next"));
+
+    m_nextTrackPreload->setSuffix(tr(" ms before end"));
+    m_nextTrackPreload->setSingleStep(500);
+    m_nextTrackPreload->setMinimum(0);
+    m_nextTrackPreload->setMaximum(60000);
+
+    generalLayout->addWidget(preloadLabel, 2, 0);
+    generalLayout->addWidget(m_nextTrackPreload, 2, 1);
+
+    auto* crossfadeLabel = new QLabel(tr("Crossfade") + QStringLiteral(":"), this);
+    crossfadeLabel->setToolTip(tr("Overlap consecutive tracks by this long. Requires gapless playback"));
+
+    m_crossfadeLength->setSuffix(QStringLiteral(" ms"));
+    m_crossfadeLength->setSingleStep(500);
+    m_crossfadeLength->setMinimum(0);
+    m_crossfadeLength->setMaximum(10000);
+
+    generalLayout->addWidget(crossfadeLabel, 3, 0);
+    generalLayout->addWidget(m_crossfadeLength, 3, 1);
+
+    auto* fadeLabel = new QLabel(tr("Fade on pause/stop/seek") + QStringLiteral(":"), this);
+
+    m_fadeLength->setSuffix(QStringLiteral(" ms"));
+    m_fadeLength->setSingleStep(50);
+    m_fadeLength->setMinimum(0);
+    m_fadeLength->setMaximum(2000);
+
+    generalLayout->addWidget(fadeLabel, 4, 0);
+    generalLayout->addWidget(m_fadeLength, 4, 1);
+
     generalLayout->setColumnStretch(2, 1);
 
+    auto* replayGainBox    = new QGroupBox(tr("ReplayGain"), this);
+    auto* replayGainLayout = new QGridLayout(replayGainBox);
+
+    auto* modeLabel = new QLabel(tr("Mode") + QStringLiteral(":"), this);
+
+    m_replayGainMode->addItem(tr("None"), static_cast<int>(ReplayGain::Mode::None));
+    m_replayGainMode->addItem(tr("Track gain"), static_cast<int>(ReplayGain::Mode::Track));
+    m_replayGainMode->addItem(tr("Album gain"), static_cast<int>(ReplayGain::Mode::Album));
+
+    auto* preampLabel = new QLabel(tr("Pre-amplification") + QStringLiteral(":"), this);
+
+    m_replayGainPreamp->setSuffix(QStringLiteral(" dB"));
+    m_replayGainPreamp->setSingleStep(0.5);
+    m_replayGainPreamp->setMinimum(-20.0);
+    m_replayGainPreamp->setMaximum(20.0);
+
+    replayGainLayout->addWidget(modeLabel, 0, 0);
+    replayGainLayout->addWidget(m_replayGainMode, 0, 1);
+    replayGainLayout->addWidget(preampLabel, 1, 0);
+    replayGainLayout->addWidget(m_replayGainPreamp, 1, 1);
+    replayGainLayout->addWidget(m_preventClipping, 2, 0, 1, 3);
+    replayGainLayout->setColumnStretch(2, 1);
+
     auto* mainLayout = new QGridLayout(this);
     mainLayout->addWidget(outputLabel, 0, 0);
     mainLayout->addWidget(m_outputBox, 0, 1);
     mainLayout->addWidget(deviceLabel, 1, 0);
     mainLayout->addWidget(m_deviceBox, 1, 1);
     mainLayout->addWidget(generalBox, 2, 0, 1, 2);
+    mainLayout->addWidget(replayGainBox, 3, 0, 1, 2);
 
     mainLayout->setColumnStretch(1, 1);
-    mainLayout->setRowStretch(3, 1);
+    mainLayout->setRowStretch(4, 1);
 
     QObject::connect(m_outputBox, &QComboBox::currentTextChanged, this, &EnginePageWidget::setupDevices);
 }
@@ -109,6 +180,12 @@ void EnginePageWidget::load()
     setupDevices(m_outputBox->currentText());
     m_gaplessPlayback->setChecked(m_settings->value<Settings::Core::GaplessPlayback>());
     m_bufferSize->setValue(m_settings->value<Settings::Core::BufferLength>());
+    m_nextTrackPreload->setValue(m_settings->value<Settings::Core::NextTrackPreload>());
+    m_crossfadeLength->setValue(m_settings->value<Settings::Core::CrossfadeLength>());
+    m_fadeLength->setValue(m_settings->value<Settings::Core::FadeLength>());
+    m_replayGainMode->setCurrentIndex(m_replayGainMode->findData(m_settings->value<Settings::Core::ReplayGainMode>()));
+    m_replayGainPreamp->setValue(m_settings->value<Settings::Core::ReplayGainPreamp>());
+    m_preventClipping->setChecked(m_settings->value<Settings::Core::ReplayGainNoClip>());
 }
 
 void EnginePageWidget::apply()
@@ -117,6 +194,12 @@ void EnginePageWidget::apply()
     m_settings->set<Settings::Core::AudioOutput>(output);
     m_settings->set<Settings::Core::GaplessPlayback>(m_gaplessPlayback->isChecked());
     m_settings->set<Settings::Core::BufferLength>(m_bufferSize->value());
+    m_settings->set<Settings::Core::NextTrackPreload>(m_nextTrackPreload->value());
+    m_settings->set<Settings::Core::CrossfadeLength>(m_crossfadeLength->value());
+    m_settings->set<Settings::Core::FadeLength>(m_fadeLength->value());
+    m_settings->set<Settings::Core::ReplayGainMode>(m_replayGainMode->currentData().toInt());
+    m_settings->set<Settings::Core::ReplayGainPreamp>(m_replayGainPreamp->value());
+    m_settings->set<Settings::Core::ReplayGainNoClip>(m_preventClipping->isChecked());
 }
 
 void EnginePageWidget::reset()
@@ -124,6 +207,12 @@ void EnginePageWidget::reset()
     m_settings->reset<Settings::Core::AudioOutput>();
     m_settings->reset<Settings::Core::GaplessPlayback>();
     m_settings->reset<Settings::Core::BufferLength>();
+    m_settings->reset<Settings::Core::NextTrackPreload>();
+    m_settings->reset<Settings::Core::CrossfadeLength>();
+    m_settings->reset<Settings::Core::FadeLength>();
+    m_settings->reset<Settings::Core::ReplayGainMode>();
+    m_settings->reset<Settings::Core::ReplayGainPreamp>();
+    m_settings->reset<Settings::Core::ReplayGainNoClip>();
 }
 
 void EnginePageWidget::setupOutputs()
@@ -103,6 +103,7 @@ void ShortcutItem::sortChildren()
     std::vector<ShortcutItem*> sortedChildren{m_children};
     std::ranges::sort(sortedChildren, sortShortcutItems);
     m_children = sortedChildren;
+    updateChildRows();
     std::ranges::for_each(m_children, &ShortcutItem::sortChildren);
 }
 
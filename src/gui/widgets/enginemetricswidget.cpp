@@ -0,0 +1,163 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "enginemetricswidget.h"
+
+#include <core/engine/enginecontroller.h>
+#include <core/engine/enginemetrics.h>
+
+#include <QApplication>
+#include <QClipboard>
+#include <QContextMenuEvent>
+#include <QHeaderView>
+#include <QJsonDocument>
+#include <QMenu>
+#include <QTimerEvent>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+namespace {
+constexpr auto UpdateInterval = 500;
+
+QTreeWidgetItem* histogramItem(const QString& name, const QString& unit,
+                               const Fooyin::MetricHistogram::Snapshot& histogram)
+{
+    auto* item = new QTreeWidgetItem();
+    item->setText(0, QStringLiteral("%1 (%2)").arg(name, unit));
+    item->setText(1, QString::number(histogram.count));
+    item->setText(2, QString::number(histogram.mean(), 'f', 1));
+    item->setText(3, QString::number(histogram.percentile(50)));
+    item->setText(4, QString::number(histogram.percentile(95)));
+    item->setText(5, QString::number(histogram.percentile(99)));
+    item->setText(6, QString::number(histogram.max));
+    return item;
+}
+
+QTreeWidgetItem* counterItem(const QString& name, const QString& value)
+{
+    auto* item = new QTreeWidgetItem();
+    item->setText(0, name);
+    item->setText(1, value);
+    return item;
+}
+} // namespace
+
+namespace Fooyin {
+EngineMetricsWidget::EngineMetricsWidget(EngineController* engine, QWidget* parent)
+    : FyWidget{parent}
+    , m_engine{engine}
+    , m_view{new QTreeWidget(this)}
+{
+    setObjectName(EngineMetricsWidget::name());
+
+    auto* layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addWidget(m_view);
+
+    m_view->setRootIsDecorated(false);
+    m_view->setSelectionMode(QAbstractItemView::NoSelection);
+    m_view->setHeaderLabels({tr("Metric"), tr("Count"), tr("Mean"), QStringLiteral("p50"), QStringLiteral("p95"),
+                             QStringLiteral("p99"), tr("Max")});
+    m_view->header()->setSectionResizeMode(QHeaderView::ResizeToContents);
+}
+
+QString EngineMetricsWidget::name() const
+{
+    return tr("Engine Metrics");
+}
+
+QString EngineMetricsWidget::layoutName() const
+{
+    return QStringLiteral("EngineMetrics");
+}
+
+void EngineMetricsWidget::showEvent(QShowEvent* event)
+{
+    updateMetrics();
+    m_updateTimer.start(UpdateInterval, this);
+
+    FyWidget::showEvent(event);
+}
+
+void EngineMetricsWidget::hideEvent(QHideEvent* event)
+{
+    m_updateTimer.stop();
+
+    FyWidget::hideEvent(event);
+}
+
+void EngineMetricsWidget::timerEvent(QTimerEvent* event)
+{
+    if(event->timerId() == m_updateTimer.timerId()) {
+        updateMetrics();
+    }
+
+    FyWidget::timerEvent(event);
+}
+
+void EngineMetricsWidget::contextMenuEvent(QContextMenuEvent* event)
+{
+    auto* menu = new QMenu(this);
+    menu->setAttribute(Qt::WA_DeleteOnClose);
+
+    auto* copyJson = new QAction(tr("Copy as JSON"), menu);
+    QObject::connect(copyJson, &QAction::triggered, this, [this]() {
+        const QJsonDocument json{m_engine->metrics().snapshot().toJson()};
+        QApplication::clipboard()->setText(QString::fromUtf8(json.toJson()));
+    });
+    menu->addAction(copyJson);
+
+    auto* reset = new QAction(tr("Reset"), menu);
+    QObject::connect(reset, &QAction::triggered, this, [this]() {
+        m_engine->resetMetrics();
+        updateMetrics();
+    });
+    menu->addAction(reset);
+
+    menu->popup(event->globalPos());
+}
+
+void EngineMetricsWidget::updateMetrics()
+{
+    const auto metrics = m_engine->metrics().snapshot();
+
+    m_view->clear();
+
+    m_view->addTopLevelItem(histogramItem(tr("Decode time"), QStringLiteral("µs"), metrics.decodeTime));
+    m_view->addTopLevelItem(histogramItem(tr("Queue depth"), QStringLiteral("ms"), metrics.queueDepth));
+    m_view->addTopLevelItem(histogramItem(tr("Output delay"), QStringLiteral("µs"), metrics.outputDelay));
+    m_view->addTopLevelItem(histogramItem(tr("Clock drift"), QStringLiteral("ms"), metrics.clockDrift));
+    m_view->addTopLevelItem(histogramItem(tr("Track open time"), QStringLiteral("µs"), metrics.trackOpenTime));
+
+    m_view->addTopLevelItem(counterItem(tr("Buffers decoded"), QString::number(metrics.buffersDecoded)));
+    m_view->addTopLevelItem(counterItem(tr("Output full"), QString::number(metrics.outputFull)));
+    m_view->addTopLevelItem(counterItem(tr("Queue underruns"), QString::number(metrics.queueUnderruns)));
+    m_view->addTopLevelItem(counterItem(tr("Output underruns"), QString::number(metrics.outputUnderruns)));
+    m_view->addTopLevelItem(counterItem(tr("Pre-opened tracks"), QString::number(metrics.preopenedTracks)));
+    m_view->addTopLevelItem(counterItem(tr("Gapless transitions"), QString::number(metrics.gaplessTransitions)));
+    m_view->addTopLevelItem(
+        counterItem(tr("Current queue depth"), QStringLiteral("%1 ms").arg(metrics.currentQueueDepth)));
+    m_view->addTopLevelItem(
+        counterItem(tr("Current output delay"), QStringLiteral("%1 µs").arg(metrics.currentOutputDelay)));
+    m_view->addTopLevelItem(
+        counterItem(tr("Current clock drift"), QStringLiteral("%1 ms").arg(metrics.currentClockDrift)));
+}
+} // namespace Fooyin
+
+#include "moc_enginemetricswidget.cpp"
@@ -0,0 +1,57 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <gui/fywidget.h>
+
+#include <QBasicTimer>
+
+class QTreeWidget;
+
+namespace Fooyin {
+class EngineController;
+
+/*!
+ * Shows the live playback pipeline metrics collected by the engine.
+ */
+class EngineMetricsWidget : public FyWidget
+{
+    Q_OBJECT
+
+public:
+    explicit EngineMetricsWidget(EngineController* engine, QWidget* parent = nullptr);
+
+    [[nodiscard]] QString name() const override;
+    [[nodiscard]] QString layoutName() const override;
+
+protected:
+    void showEvent(QShowEvent* event) override;
+    void hideEvent(QHideEvent* event) override;
+    void timerEvent(QTimerEvent* event) override;
+    void contextMenuEvent(QContextMenuEvent* event) override;
+
+private:
+    void updateMetrics();
+
+    EngineController* m_engine;
+    QTreeWidget* m_view;
+    QBasicTimer m_updateTimer;
+};
+} // namespace Fooyin
@@ -19,11 +19,23 @@
 
 #include "alsaoutput.h"
 
+#include <utils/ringbuffer.h>
+
 #include <alsa/asoundlib.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
 
 #include <QDebug>
 
+#include <atomic>
+#include <chrono>
+#include <thread>
+
 namespace {
+// Frames buffered between the renderer and the mmap thread
+constexpr snd_pcm_uframes_t MMapQueueSize = 8192;
+
 bool checkError(int error, const QString& message)
 {
     if(error < 0) {
@@ -131,6 +143,7 @@ using PcmHandleUPtr = std::unique_ptr<snd_pcm_t, PcmHandleDeleter>;
 namespace Fooyin::Alsa {
 struct AlsaOutput::Private
 {
+    Mode mode;
     AudioFormat format;
 
     bool initialised{false};
@@ -143,8 +156,31 @@ struct AlsaOutput::Private
     bool deviceLost;
     bool started{false};
 
+    // MMap mode: the renderer fills queue, which mmapThread copies into the device buffer.
+    // All PCM calls are made from mmapThread while it runs; requests are passed through atomics.
+    RingBuffer queue;
+    std::thread mmapThread;
+    int wakeFd{-1};
+    std::atomic<bool> stopThread{false};
+    std::atomic<bool> startRequested{false};
+    std::atomic<bool> pauseRequested{false};
+    std::atomic<int> resetRequests{0};
+    std::atomic<snd_pcm_sframes_t> deviceDelay{0};
+    std::atomic<int> underruns{0};
+
+    Private(Mode mode_, const MMapSizes& sizes)
+        : mode{mode_}
+    {
+        if(mode == Mode::MMap) {
+            bufferSize = sizes.bufferSize;
+            periodSize = std::min(sizes.periodSize, sizes.bufferSize / 2);
+        }
+    }
+
     void reset()
     {
+        stopMMapThread();
+
         if(pcmHandle) {
             snd_pcm_drop(pcmHandle.get());
             pcmHandle.reset();
@@ -152,6 +188,171 @@ struct AlsaOutput::Private
         started = false;
     }
 
+    void wakeMMapThread() const
+    {
+        if(wakeFd >= 0) {
+            const uint64_t value{1};
+            [[maybe_unused]] const auto ret = ::write(wakeFd, &value, sizeof(value));
+        }
+    }
+
+    bool startMMapThread()
+    {
+        wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if(wakeFd < 0) {
+            printError(QStringLiteral("Failed to create eventfd for mmap thread"));
+            return false;
+        }
+
+        queue.resize(MMapQueueSize * format.bytesPerFrame());
+        stopThread     = false;
+        startRequested = false;
+        pauseRequested = false;
+        resetRequests  = 0;
+        deviceDelay    = 0;
+        underruns      = 0;
+
+        mmapThread = std::thread{[this]() { runMMap(); }};
+        return true;
+    }
+
+    void stopMMapThread()
+    {
+        if(mmapThread.joinable()) {
+            stopThread = true;
+            wakeMMapThread();
+            mmapThread.join();
+        }
+
+        if(wakeFd >= 0) {
+            ::close(wakeFd);
+            wakeFd = -1;
+        }
+
+        queue.resize(0);
+    }
+
+    snd_pcm_uframes_t writeMMap(snd_pcm_uframes_t frames)
+    {
+        snd_pcm_t* handle    = pcmHandle.get();
+        const auto frameSize = static_cast<size_t>(format.bytesPerFrame());
+
+        snd_pcm_uframes_t written{0};
+
+        while(written < frames) {
+            const snd_pcm_channel_area_t* areas{nullptr};
+            snd_pcm_uframes_t offset{0};
+            snd_pcm_uframes_t count{frames - written};
+
+            if(snd_pcm_mmap_begin(handle, &areas, &offset, &count) < 0 || count == 0) {
+                break;
+            }
+
+            // Interleaved: every channel shares the first area
+            auto* dst = static_cast<std::byte*>(areas[0].addr) + (areas[0].first / 8) + (offset * frameSize);
+            const auto read = static_cast<snd_pcm_uframes_t>(queue.read(dst, count * frameSize) / frameSize);
+
+            const auto committed = snd_pcm_mmap_commit(handle, offset, read);
+            if(committed < 0 || static_cast<snd_pcm_uframes_t>(committed) != read) {
+                break;
+            }
+
+            written += read;
+            if(read < count) {
+                break;
+            }
+        }
+
+        return written;
+    }
+
+    void runMMap()
+    {
+        snd_pcm_t* handle    = pcmHandle.get();
+        const auto frameSize = static_cast<size_t>(format.bytesPerFrame());
+
+        const int pcmFdCount = snd_pcm_poll_descriptors_count(handle);
+        std::vector<pollfd> fds(static_cast<size_t>(std::max(pcmFdCount, 0)) + 1);
+        fds[0] = {.fd = wakeFd, .events = POLLIN, .revents = 0};
+        snd_pcm_poll_descriptors(handle, fds.data() + 1, static_cast<unsigned int>(pcmFdCount));
+
+        const int periodMs = std::max(1, static_cast<int>(periodSize * 1000 / format.sampleRate()));
+
+        int handledResets{0};
+        bool deviceStarted{false};
+        bool devicePaused{false};
+        // Set once audio has been written since the device was last started, paused or reset.
+        // The device running dry is only an underrun if more audio then arrives, not when playback simply ended.
+        bool expectingAudio{false};
+
+        while(!stopThread) {
+            if(const int resets = resetRequests; resets != handledResets) {
+                handledResets = resets;
+                checkError(snd_pcm_drop(handle), QStringLiteral("ALSA drop error"));
+                checkError(snd_pcm_prepare(handle), QStringLiteral("ALSA prepare error"));
+                deviceStarted  = false;
+                devicePaused   = false;
+                expectingAudio = false;
+            }
+
+            if(deviceStarted && pausable && pauseRequested != devicePaused) {
+                devicePaused   = pauseRequested;
+                expectingAudio = false;
+                checkError(snd_pcm_pause(handle, devicePaused ? 1 : 0), QStringLiteral("Couldn't (un)pause device"));
+            }
+
+            snd_pcm_sframes_t avail = snd_pcm_avail_update(handle);
+            if(avail < 0) {
+                ++underruns;
+                if(checkError(snd_pcm_recover(handle, static_cast<int>(avail), 1), QStringLiteral("Recover error"))) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds{periodMs});
+                }
+                deviceStarted  = false;
+                expectingAudio = false;
+                continue;
+            }
+
+            const auto queued = static_cast<snd_pcm_uframes_t>(queue.readAvailable() / frameSize);
+
+            if(!devicePaused && avail > 0 && queued > 0) {
+                // The device fills anything it plays with silence (see initAlsa), so once drained it's all free
+                if(deviceStarted && expectingAudio && static_cast<snd_pcm_uframes_t>(avail) >= bufferSize) {
+                    // The device played everything before the renderer caught up
+                    ++underruns;
+                }
+                writeMMap(std::min(static_cast<snd_pcm_uframes_t>(avail), queued));
+                expectingAudio = true;
+            }
+
+            if(!deviceStarted && startRequested) {
+                deviceStarted = !checkError(snd_pcm_start(handle), QStringLiteral("Start error"));
+            }
+
+            snd_pcm_sframes_t delay{0};
+            if(snd_pcm_delay(handle, &delay) == 0) {
+                deviceDelay = std::max<snd_pcm_sframes_t>(delay, 0);
+            }
+
+            // Wait on the device while there is audio to give it. While it plays out what it has, wake each
+            // period to keep the delay current. Otherwise (paused, stopped or drained) sleep until woken.
+            const bool running      = deviceStarted && !devicePaused;
+            const bool waitOnDevice = running && queue.readAvailable() > 0;
+            const bool draining     = running && !waitOnDevice && deviceDelay > 0;
+            const auto fdCount      = waitOnDevice ? fds.size() : 1;
+
+            if(::poll(fds.data(), fdCount, draining ? periodMs : -1) > 0 && (fds[0].revents & POLLIN)) {
+                uint64_t value;
+                [[maybe_unused]] const auto ret = ::read(wakeFd, &value, sizeof(value));
+            }
+
+            if(waitOnDevice) {
+                unsigned short revents{0};
+                snd_pcm_poll_descriptors_revents(handle, fds.data() + 1, static_cast<unsigned int>(pcmFdCount),
+                                                 &revents);
+            }
+        }
+    }
+
     bool initAlsa()
     {
         int err{-1};
@@ -175,7 +376,9 @@ struct AlsaOutput::Private
 
         pausable = snd_pcm_hw_params_can_pause(hwParams);
 
-        err = snd_pcm_hw_params_set_access(handle, hwParams, SND_PCM_ACCESS_RW_INTERLEAVED);
+        err = snd_pcm_hw_params_set_access(handle, hwParams,
+                                           mode == Mode::MMap ? SND_PCM_ACCESS_MMAP_INTERLEAVED
+                                                              : SND_PCM_ACCESS_RW_INTERLEAVED);
         if(checkError(err, QStringLiteral("Failed to set access mode"))) {
             return false;
         }
@@ -266,6 +469,14 @@ struct AlsaOutput::Private
             return false;
         }
 
+        if(mode == Mode::MMap) {
+            // Wake the mmap thread once a period can be written
+            err = snd_pcm_sw_params_set_avail_min(handle, swParams, periodSize);
+            if(checkError(err, QStringLiteral("Unable to set avail min"))) {
+                return false;
+            }
+        }
+
         err = snd_pcm_sw_params(handle, swParams);
         if(checkError(err, QStringLiteral("Failed to apply software parameters"))) {
             return false;
@@ -374,8 +585,8 @@ struct AlsaOutput::Private
     }
 };
 
-AlsaOutput::AlsaOutput()
-    : p{std::make_unique<Private>()}
+AlsaOutput::AlsaOutput(Mode mode, const MMapSizes& sizes)
+    : p{std::make_unique<Private>(mode, sizes)}
 { }
 
 AlsaOutput::~AlsaOutput()
@@ -387,7 +598,7 @@ bool AlsaOutput::init(const AudioFormat& format)
 {
     p->format = format;
 
-    if(!p->initAlsa()) {
+    if(!p->initAlsa() || (p->mode == Mode::MMap && !p->startMMapThread())) {
         uninit();
         return false;
     }
@@ -404,6 +615,14 @@ void AlsaOutput::uninit()
 
 void AlsaOutput::reset()
 {
+    if(p->mode == Mode::MMap) {
+        p->queue.clear();
+        p->startRequested = false;
+        ++p->resetRequests;
+        p->wakeMMapThread();
+        return;
+    }
+
     checkError(snd_pcm_drop(p->pcmHandle.get()), QStringLiteral("ALSA drop error"));
     checkError(snd_pcm_prepare(p->pcmHandle.get()), QStringLiteral("ALSA prepare error"));
 
@@ -413,6 +632,13 @@ void AlsaOutput::reset()
 void AlsaOutput::start()
 {
     p->started = true;
+
+    if(p->mode == Mode::MMap) {
+        p->startRequested = true;
+        p->wakeMMapThread();
+        return;
+    }
+
     snd_pcm_start(p->pcmHandle.get());
 }
 
@@ -433,6 +659,9 @@ bool AlsaOutput::canHandleVolume() const
 
 int AlsaOutput::bufferSize() const
 {
+    if(p->mode == Mode::MMap) {
+        return static_cast<int>(MMapQueueSize);
+    }
     return static_cast<int>(p->bufferSize);
 }
 
@@ -440,6 +669,18 @@ OutputState AlsaOutput::currentState()
 {
     OutputState state;
 
+    if(p->mode == Mode::MMap) {
+        const int frameSize = p->format.bytesPerFrame();
+        const auto queued   = static_cast<int>(p->queue.readAvailable()) / frameSize;
+        const auto frames   = static_cast<double>(queued + p->deviceDelay);
+
+        state.freeSamples   = static_cast<int>(p->queue.writeAvailable()) / frameSize;
+        state.queuedSamples = queued;
+        state.delay         = frames / static_cast<double>(p->format.sampleRate());
+        state.underruns     = p->underruns;
+        return state;
+    }
+
     p->recoverState(&state);
 
     return state;
@@ -477,6 +718,14 @@ OutputDevices AlsaOutput::getAllDevices() const
 
 int AlsaOutput::write(const AudioBuffer& buffer)
 {
+    if(p->mode == Mode::MMap) {
+        const auto frameSize = static_cast<size_t>(p->format.bytesPerFrame());
+        const auto bytes     = std::min(buffer.constData().size(), p->queue.writeAvailable() / frameSize * frameSize);
+        const auto written   = p->queue.write(buffer.data(), bytes);
+        p->wakeMMapThread();
+        return static_cast<int>(written / frameSize);
+    }
+
     if(!p->pcmHandle || !p->recoverState()) {
         return 0;
     }
@@ -501,6 +750,12 @@ void AlsaOutput::setPaused(bool pause)
         return;
     }
 
+    if(p->mode == Mode::MMap) {
+        p->pauseRequested = pause;
+        p->wakeMMapThread();
+        return;
+    }
+
     p->recoverState();
 
     const auto state = snd_pcm_state(p->pcmHandle.get());
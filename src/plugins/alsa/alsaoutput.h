@@ -24,10 +24,26 @@
 #include <memory>
 
 namespace Fooyin::Alsa {
+// Size of the device buffer and its periods in MMap mode, in frames.
+// Smaller sizes lower latency at the cost of more wakeups and a higher risk of underruns.
+struct MMapSizes
+{
+    uint32_t bufferSize{2048};
+    uint32_t periodSize{256};
+};
+
 class AlsaOutput : public AudioOutput
 {
 public:
-    AlsaOutput();
+    enum class Mode
+    {
+        // Written to from the renderer with snd_pcm_writei
+        ReadWrite,
+        // Written directly into the device's buffer from a poll-driven thread
+        MMap
+    };
+
+    explicit AlsaOutput(Mode mode = Mode::ReadWrite, const MMapSizes& sizes = {});
     ~AlsaOutput() override;
 
     bool init(const AudioFormat& format) override;
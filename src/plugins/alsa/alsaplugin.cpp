@@ -21,13 +21,47 @@
 
 #include "alsaoutput.h"
 
+#include <utils/settings/settingsmanager.h>
+
+namespace {
+// Unregistered settings, so they can be tuned in the settings file for a particular device
+constexpr auto MMapBufferSize = "ALSA/MMapBufferSize";
+constexpr auto MMapPeriodSize = "ALSA/MMapPeriodSize";
+
+uint32_t sizeSetting(Fooyin::SettingsManager* settings, const char* key, uint32_t defaultSize)
+{
+    if(!settings || !settings->fileContains(QString::fromLatin1(key))) {
+        return defaultSize;
+    }
+
+    const int size = settings->fileValue(QString::fromLatin1(key)).toInt();
+    return size > 0 ? static_cast<uint32_t>(size) : defaultSize;
+}
+} // namespace
+
 namespace Fooyin::Alsa {
+void AlsaPlugin::initialise(const CorePluginContext& context)
+{
+    m_settings = context.settingsManager;
+}
+
 AudioOutputBuilder AlsaPlugin::registerOutput()
 {
     return {.name = QStringLiteral("ALSA"), .creator = []() {
                 return std::make_unique<AlsaOutput>();
             }};
 }
+
+std::vector<AudioOutputBuilder> AlsaPlugin::registerOutputs()
+{
+    return {registerOutput(), {.name = QStringLiteral("ALSA (mmap)"), .creator = [this]() {
+                                   const MMapSizes defaults;
+                                   const MMapSizes sizes{
+                                       .bufferSize = sizeSetting(m_settings, MMapBufferSize, defaults.bufferSize),
+                                       .periodSize = sizeSetting(m_settings, MMapPeriodSize, defaults.periodSize)};
+                                   return std::make_unique<AlsaOutput>(AlsaOutput::Mode::MMap, sizes);
+                               }}};
+}
 } // namespace Fooyin::Alsa
 
 #include "moc_alsaplugin.cpp"
@@ -25,6 +25,7 @@
 
 #include <core/library/musiclibrary.h>
 #include <core/library/trackfilter.h>
+#include <core/library/tracksearchindex.h>
 #include <gui/editablelayout.h>
 #include <gui/trackselectioncontroller.h>
 #include <utils/async.h>
@@ -438,8 +439,11 @@ struct FilterController::Private
         const bool reset         = !group.filteredTracks.empty() || filter->searchFilter().length() > search.length();
         TrackList tracksToFilter = reset ? library->tracks() : filter->tracks();
 
-        Utils::asyncExec([search, tracksToFilter]() {
-            return Filter::filterTracks(tracksToFilter, search);
+        const TrackSearchIndex* index = &library->searchIndex();
+
+        Utils::asyncExec([search, tracksToFilter, reset, index]() {
+            return reset ? Filter::filterIndexedTracks(*index, search, tracksToFilter)
+                         : Filter::filterTracks(tracksToFilter, search, *index);
         }).then(self, [filter](TrackList filteredTracks) { filter->reset(filteredTracks); });
     }
 };
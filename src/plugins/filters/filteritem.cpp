@@ -137,6 +137,7 @@ void FilterItem::sortChildren(int column, Qt::SortOrder order)
         return sort(collator, column, order, lhs, rhs);
     });
     m_children = sortedChildren;
+    updateChildRows();
 
     for(const auto& child : m_children) {
         child->sortTracks();
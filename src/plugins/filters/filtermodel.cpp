@@ -127,7 +127,7 @@ struct FilterModel::Private
     {
         std::set<QString> columnUniques;
 
-        const auto children = allNode.children();
+        const auto& children = allNode.children();
 
         for(FilterItem* item : children) {
             columnUniques.emplace(item->column(column));
@@ -375,7 +375,7 @@ QModelIndexList FilterModel::indexesForValues(const QStringList& values, int col
         }
     }
 
-    const auto rows = p->allNode.children();
+    const auto& rows = p->allNode.children();
     for(const auto& child : rows) {
         if(values.contains(child->column(column))) {
             indexes.append(indexOfItem(child));
@@ -0,0 +1,252 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "fileoutput.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace {
+constexpr auto BufferSize    = 4096;
+constexpr auto WavHeaderSize = 44;
+
+enum WavFormatTag : uint16_t
+{
+    Pcm       = 1,
+    IeeeFloat = 3
+};
+
+int bytesPerSampleOnDisk(const Fooyin::AudioFormat& format)
+{
+    // S24 is MSB-aligned in a 32bit int, with a padding low byte; pack the high three bytes when writing
+    return format.sampleFormat() == Fooyin::SampleFormat::S24 ? 3 : format.bytesPerSample();
+}
+
+template <typename T>
+void appendLittleEndian(QByteArray& data, T value)
+{
+    const T le = qToLittleEndian(value);
+    data.append(reinterpret_cast<const char*>(&le), sizeof(T));
+}
+
+uint32_t clampedSize(qint64 size)
+{
+    return static_cast<uint32_t>(std::min<qint64>(size, std::numeric_limits<uint32_t>::max()));
+}
+} // namespace
+
+namespace Fooyin::Headless {
+FileOutput::FileOutput()
+    : m_device{QDir::temp().filePath(QStringLiteral("fooyin-output.wav"))}
+    , m_bytesWritten{0}
+    , m_paused{false}
+{ }
+
+FileOutput::~FileOutput()
+{
+    if(m_file.isOpen()) {
+        uninit();
+    }
+}
+
+bool FileOutput::init(const AudioFormat& format)
+{
+    if(!format.isValid()) {
+        qWarning() << "[File] Invalid audio format";
+        return false;
+    }
+
+    m_format       = format;
+    m_bytesWritten = 0;
+    m_paused       = false;
+
+    m_file.setFileName(m_device);
+    if(!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "[File] Unable to open" << m_device << ":" << m_file.errorString();
+        return false;
+    }
+
+    if(isWav() && !writeWavHeader()) {
+        qWarning() << "[File] Unable to write header to" << m_device;
+        m_file.close();
+        return false;
+    }
+
+    return true;
+}
+
+void FileOutput::uninit()
+{
+    if(!m_file.isOpen()) {
+        return;
+    }
+
+    if(isWav()) {
+        // Patch the RIFF and data chunk sizes now the length is known
+        const uint32_t dataSize = clampedSize(m_bytesWritten);
+        const uint32_t riffSize = clampedSize(static_cast<qint64>(dataSize) + WavHeaderSize - 8);
+
+        QByteArray size;
+        appendLittleEndian(size, riffSize);
+        m_file.seek(4);
+        m_file.write(size);
+
+        size.clear();
+        appendLittleEndian(size, dataSize);
+        m_file.seek(WavHeaderSize - 4);
+        m_file.write(size);
+    }
+
+    m_file.close();
+}
+
+void FileOutput::reset() { }
+
+void FileOutput::start() { }
+
+bool FileOutput::initialised() const
+{
+    return m_file.isOpen();
+}
+
+QString FileOutput::device() const
+{
+    return m_device;
+}
+
+bool FileOutput::canHandleVolume() const
+{
+    return false;
+}
+
+int FileOutput::bufferSize() const
+{
+    return BufferSize;
+}
+
+OutputState FileOutput::currentState()
+{
+    OutputState state;
+
+    // Writes are synchronous, so the sink is always empty
+    state.freeSamples = m_paused ? 0 : BufferSize;
+
+    return state;
+}
+
+OutputDevices FileOutput::getAllDevices() const
+{
+    OutputDevices devices;
+    devices.emplace_back(QDir::temp().filePath(QStringLiteral("fooyin-output.wav")), QStringLiteral("WAV file"));
+    devices.emplace_back(QDir::temp().filePath(QStringLiteral("fooyin-output.raw")), QStringLiteral("Raw PCM file"));
+    return devices;
+}
+
+int FileOutput::write(const AudioBuffer& buffer)
+{
+    if(!m_file.isOpen() || m_paused || !buffer.isValid()) {
+        return 0;
+    }
+
+    const int frames = buffer.frameCount();
+    qint64 written{0};
+
+    if(isWav() && m_format.sampleFormat() == SampleFormat::S24) {
+        const auto data    = buffer.constData();
+        const auto samples = data.size() / 4;
+        QByteArray packed(static_cast<qsizetype>(samples * 3), Qt::Uninitialized);
+
+        for(size_t i{0}; i < samples; ++i) {
+            int32_t sample{0};
+            std::memcpy(&sample, data.data() + (i * 4), sizeof(sample));
+            const int32_t value = qToLittleEndian(sample >> 8);
+            std::memcpy(packed.data() + (i * 3), &value, 3);
+        }
+        written = m_file.write(packed);
+    }
+    else {
+        written = m_file.write(reinterpret_cast<const char*>(buffer.data()), buffer.byteCount());
+    }
+
+    if(written < 0) {
+        qWarning() << "[File] Write failed:" << m_file.errorString();
+        return 0;
+    }
+
+    m_bytesWritten += written;
+
+    return frames;
+}
+
+void FileOutput::setPaused(bool pause)
+{
+    m_paused = pause;
+}
+
+void FileOutput::setDevice(const QString& device)
+{
+    if(!device.isEmpty()) {
+        m_device = device;
+    }
+}
+
+qint64 FileOutput::bytesWritten() const
+{
+    return m_bytesWritten;
+}
+
+bool FileOutput::isWav() const
+{
+    return m_device.endsWith(QStringLiteral(".wav"), Qt::CaseInsensitive);
+}
+
+bool FileOutput::writeWavHeader()
+{
+    const int sampleBytes = bytesPerSampleOnDisk(m_format);
+    const int channels    = m_format.channelCount();
+    const int blockAlign  = sampleBytes * channels;
+    const auto formatTag  = m_format.sampleFormat() == SampleFormat::Float ? IeeeFloat : Pcm;
+
+    QByteArray header;
+    header.reserve(WavHeaderSize);
+
+    header.append("RIFF");
+    appendLittleEndian<uint32_t>(header, WavHeaderSize - 8);
+    header.append("WAVE");
+
+    header.append("fmt ");
+    appendLittleEndian<uint32_t>(header, 16);
+    appendLittleEndian<uint16_t>(header, formatTag);
+    appendLittleEndian<uint16_t>(header, static_cast<uint16_t>(channels));
+    appendLittleEndian<uint32_t>(header, static_cast<uint32_t>(m_format.sampleRate()));
+    appendLittleEndian<uint32_t>(header, static_cast<uint32_t>(m_format.sampleRate() * blockAlign));
+    appendLittleEndian<uint16_t>(header, static_cast<uint16_t>(blockAlign));
+    appendLittleEndian<uint16_t>(header, static_cast<uint16_t>(sampleBytes * 8));
+
+    header.append("data");
+    appendLittleEndian<uint32_t>(header, 0);
+
+    return m_file.write(header) == WavHeaderSize;
+}
+} // namespace Fooyin::Headless
@@ -0,0 +1,66 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <core/engine/audiooutput.h>
+
+#include <QFile>
+
+namespace Fooyin::Headless {
+/*!
+ * An output which writes all audio to a file. The device is the path of the file;
+ * paths ending in '.wav' get a RIFF/WAVE header, anything else is written as raw PCM.
+ */
+class FileOutput : public AudioOutput
+{
+public:
+    FileOutput();
+    ~FileOutput() override;
+
+    bool init(const AudioFormat& format) override;
+    void uninit() override;
+    void reset() override;
+    void start() override;
+
+    [[nodiscard]] bool initialised() const override;
+    [[nodiscard]] QString device() const override;
+    [[nodiscard]] bool canHandleVolume() const override;
+    int bufferSize() const override;
+    OutputState currentState() override;
+    [[nodiscard]] OutputDevices getAllDevices() const override;
+
+    int write(const AudioBuffer& buffer) override;
+    void setPaused(bool pause) override;
+    void setDevice(const QString& device) override;
+
+    /** Returns the number of bytes of audio written since @fn init. */
+    [[nodiscard]] qint64 bytesWritten() const;
+
+private:
+    [[nodiscard]] bool isWav() const;
+    bool writeWavHeader();
+
+    AudioFormat m_format;
+    QString m_device;
+    QFile m_file;
+    qint64 m_bytesWritten;
+    bool m_paused;
+};
+} // namespace Fooyin::Headless
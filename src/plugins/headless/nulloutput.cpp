@@ -0,0 +1,216 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "nulloutput.h"
+
+#include <QDebug>
+
+#include <algorithm>
+#include <utility>
+
+using namespace std::chrono_literals;
+
+namespace {
+constexpr auto BufferSize = 4096;
+
+QString clockDevice(Fooyin::Headless::NullOutput::Clock clock)
+{
+    return clock == Fooyin::Headless::NullOutput::Clock::Fast ? QStringLiteral("fast") : QStringLiteral("realtime");
+}
+} // namespace
+
+namespace Fooyin::Headless {
+NullOutput::NullOutput(Clock clock)
+    : m_clock{clock}
+    , m_bufferSize{BufferSize}
+    , m_initialised{false}
+    , m_started{false}
+    , m_paused{false}
+    , m_queuedFrames{0}
+    , m_framesConsumed{0}
+    , m_underruns{0}
+    , m_starved{false}
+    , m_playTime{0ns}
+{ }
+
+bool NullOutput::init(const AudioFormat& format)
+{
+    if(!format.isValid()) {
+        qWarning() << "[Null] Invalid audio format";
+        return false;
+    }
+
+    m_format         = format;
+    m_started        = false;
+    m_paused         = false;
+    m_queuedFrames   = 0;
+    m_framesConsumed = 0;
+    m_underruns      = 0;
+    m_starved        = false;
+    m_playTime       = 0ns;
+    m_lastUpdate     = std::chrono::steady_clock::now();
+    m_initialised    = true;
+
+    return true;
+}
+
+void NullOutput::uninit()
+{
+    m_initialised  = false;
+    m_started      = false;
+    m_queuedFrames = 0;
+}
+
+void NullOutput::reset()
+{
+    advanceClock();
+
+    m_started      = false;
+    m_starved      = false;
+    m_queuedFrames = 0;
+}
+
+void NullOutput::start()
+{
+    advanceClock();
+    m_started = true;
+}
+
+bool NullOutput::initialised() const
+{
+    return m_initialised;
+}
+
+QString NullOutput::device() const
+{
+    return clockDevice(m_clock);
+}
+
+bool NullOutput::canHandleVolume() const
+{
+    return false;
+}
+
+int NullOutput::bufferSize() const
+{
+    return m_bufferSize;
+}
+
+OutputState NullOutput::currentState()
+{
+    advanceClock();
+
+    OutputState state;
+
+    state.queuedSamples = m_queuedFrames;
+    state.freeSamples   = m_bufferSize - m_queuedFrames;
+    state.delay         = static_cast<double>(m_queuedFrames) / static_cast<double>(m_format.sampleRate());
+    state.underruns     = m_underruns;
+
+    return state;
+}
+
+OutputDevices NullOutput::getAllDevices() const
+{
+    OutputDevices devices;
+    devices.emplace_back(clockDevice(Clock::RealTime), QStringLiteral("Real-time clock"));
+    devices.emplace_back(clockDevice(Clock::Fast), QStringLiteral("As fast as possible"));
+    return devices;
+}
+
+int NullOutput::write(const AudioBuffer& buffer)
+{
+    advanceClock();
+
+    const int frames = std::min(buffer.frameCount(), m_bufferSize - m_queuedFrames);
+    if(frames <= 0) {
+        return 0;
+    }
+
+    m_queuedFrames += frames;
+
+    // Only counted once more audio arrives, so running out at the end of playback isn't an underrun
+    if(std::exchange(m_starved, false)) {
+        ++m_underruns;
+    }
+
+    return frames;
+}
+
+void NullOutput::setPaused(bool pause)
+{
+    advanceClock();
+    m_paused = pause;
+
+    if(pause) {
+        m_starved = false;
+    }
+}
+
+void NullOutput::setDevice(const QString& device)
+{
+    if(device == clockDevice(Clock::Fast)) {
+        m_clock = Clock::Fast;
+    }
+    else if(device == clockDevice(Clock::RealTime)) {
+        m_clock = Clock::RealTime;
+    }
+}
+
+uint64_t NullOutput::framesConsumed() const
+{
+    return m_framesConsumed;
+}
+
+void NullOutput::advanceClock()
+{
+    const auto now = std::chrono::steady_clock::now();
+    const bool running{m_initialised && m_started && !m_paused};
+
+    if(running) {
+        m_playTime += now - m_lastUpdate;
+    }
+    m_lastUpdate = now;
+
+    if(!running) {
+        return;
+    }
+
+    if(m_clock == Clock::Fast) {
+        m_framesConsumed += static_cast<uint64_t>(m_queuedFrames);
+        m_queuedFrames = 0;
+        return;
+    }
+
+    const auto demanded = static_cast<uint64_t>(std::chrono::duration<double>(m_playTime).count()
+                                                * static_cast<double>(m_format.sampleRate()));
+    const uint64_t due  = demanded - m_framesConsumed;
+
+    if(due <= static_cast<uint64_t>(m_queuedFrames)) {
+        m_queuedFrames -= static_cast<int>(due);
+        m_framesConsumed = demanded;
+        return;
+    }
+
+    // The device wanted more than we had, so it plays silence until the next write
+    m_framesConsumed = demanded;
+    m_queuedFrames   = 0;
+    m_starved        = true;
+}
+} // namespace Fooyin::Headless
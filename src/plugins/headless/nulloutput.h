@@ -0,0 +1,79 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <core/engine/audiooutput.h>
+
+#include <chrono>
+
+namespace Fooyin::Headless {
+/*!
+ * An output which discards all audio. Playback is driven by either a simulated
+ * real-time clock or consumed as fast as it is written, selected through the device.
+ */
+class NullOutput : public AudioOutput
+{
+public:
+    enum class Clock
+    {
+        RealTime,
+        Fast
+    };
+
+    explicit NullOutput(Clock clock = Clock::RealTime);
+
+    bool init(const AudioFormat& format) override;
+    void uninit() override;
+    void reset() override;
+    void start() override;
+
+    [[nodiscard]] bool initialised() const override;
+    [[nodiscard]] QString device() const override;
+    [[nodiscard]] bool canHandleVolume() const override;
+    int bufferSize() const override;
+    OutputState currentState() override;
+    [[nodiscard]] OutputDevices getAllDevices() const override;
+
+    int write(const AudioBuffer& buffer) override;
+    void setPaused(bool pause) override;
+    void setDevice(const QString& device) override;
+
+    /** Returns the total number of frames consumed by the simulated device since @fn init. */
+    [[nodiscard]] uint64_t framesConsumed() const;
+
+private:
+    void advanceClock();
+
+    Clock m_clock;
+    AudioFormat m_format;
+    int m_bufferSize;
+    bool m_initialised;
+    bool m_started;
+    bool m_paused;
+
+    int m_queuedFrames;
+    uint64_t m_framesConsumed;
+    int m_underruns;
+    bool m_starved;
+
+    std::chrono::steady_clock::time_point m_lastUpdate;
+    std::chrono::nanoseconds m_playTime;
+};
+} // namespace Fooyin::Headless
@@ -25,6 +25,8 @@
 #include "pipewirestream.h"
 #include "pipewirethreadloop.h"
 
+#include <utils/ringbuffer.h>
+
 #include <pipewire/pipewire.h>
 #include <spa/param/audio/format-utils.h>
 #include <spa/pod/builder.h>
@@ -32,6 +34,8 @@
 
 #include <QDebug>
 
+#include <atomic>
+
 #ifdef __GNUC__
 #pragma GCC diagnostic ignored "-Wmissing-field-initializers"
 #pragma GCC diagnostic ignored "-Wold-style-cast"
@@ -132,8 +136,12 @@ struct PipeWireOutput::Private
 
     AudioFormat format;
 
-    AudioBuffer buffer;
-    uint32_t bufferPos{0};
+    // Written by the renderer thread, read by PipeWire's real-time thread
+    RingBuffer buffer;
+    std::atomic<int> underruns{0};
+    std::atomic<bool> playing{false};
+    // Set when the buffer ran dry while playing, and counted as an underrun once more data arrives
+    std::atomic<bool> starved{false};
 
     std::unique_ptr<PipewireThreadLoop> loop;
     std::unique_ptr<PipewireContext> context;
@@ -172,8 +180,10 @@ struct PipeWireOutput::Private
             registry.reset(nullptr);
         }
 
-        buffer.clear();
-        bufferPos = 0;
+        buffer.resize(0);
+        underruns = 0;
+        playing   = false;
+        starved   = false;
     }
 
     bool initCore()
@@ -260,33 +270,39 @@ struct PipeWireOutput::Private
         return stream->connect(PW_ID_ANY, PW_DIRECTION_OUTPUT, params, flags);
     }
 
+    // Runs on PipeWire's real-time thread: must not allocate, lock or log
     static void process(void* userData)
     {
         auto* self = static_cast<PipeWireOutput::Private*>(userData);
 
-        if(!self->bufferPos) {
+        if(self->buffer.readAvailable() == 0) {
+            // Running dry at the end of playback isn't an underrun, so wait to see if more data follows
+            if(self->playing.load(std::memory_order_relaxed)) {
+                self->starved.store(true, std::memory_order_relaxed);
+            }
             self->loop->signal(false);
             return;
         }
 
+        if(self->starved.exchange(false, std::memory_order_relaxed)) {
+            self->underruns.fetch_add(1, std::memory_order_relaxed);
+        }
+
         auto* pwBuffer = self->stream->dequeueBuffer();
         if(!pwBuffer) {
-            qWarning() << "PW: No available output buffers";
             return;
         }
 
         const spa_data& data = pwBuffer->buffer->datas[0];
 
-        const auto size = std::min(data.maxsize, self->bufferPos);
-        auto* dst       = data.data;
+        const auto frameSize = static_cast<uint32_t>(self->format.bytesPerFrame());
+        const uint32_t size  = data.maxsize - (data.maxsize % frameSize);
 
-        std::memcpy(dst, self->buffer.data(), self->bufferPos);
-        self->bufferPos -= size;
-        self->buffer.erase(size);
+        const auto read = static_cast<uint32_t>(self->buffer.read(static_cast<std::byte*>(data.data), size));
 
         data.chunk->offset = 0;
         data.chunk->stride = self->format.bytesPerFrame();
-        data.chunk->size   = size;
+        data.chunk->size   = read;
 
         self->stream->queueBuffer(pwBuffer);
         self->loop->signal(false);
@@ -326,7 +342,6 @@ PipeWireOutput::~PipeWireOutput() = default;
 bool PipeWireOutput::init(const AudioFormat& format)
 {
     p->format = format;
-    p->buffer = {format, 0};
 
     pw_init(nullptr, nullptr);
 
@@ -334,6 +349,10 @@ bool PipeWireOutput::init(const AudioFormat& format)
         return false;
     }
 
+    // The stream is inactive until started, so the real-time thread isn't reading yet
+    p->buffer.resize(static_cast<size_t>(p->stream->bufferSize()) * format.bytesPerFrame());
+    p->underruns = 0;
+
     if(p->pendingVolumeChange) {
         p->pendingVolumeChange = false;
         setVolume(p->volume);
@@ -351,15 +370,17 @@ void PipeWireOutput::uninit()
 
 void PipeWireOutput::reset()
 {
-    {
-        const ThreadLoopGuard guard{p->loop.get()};
-    }
+    p->buffer.clear();
+    p->starved = false;
 
+    const ThreadLoopGuard guard{p->loop.get()};
     p->stream->flush(false);
 }
 
 void PipeWireOutput::start()
 {
+    p->playing = true;
+
     const ThreadLoopGuard guard{p->loop.get()};
     p->stream->setActive(true);
 }
@@ -407,8 +428,11 @@ OutputState PipeWireOutput::currentState()
 {
     OutputState state;
 
-    state.queuedSamples = p->buffer.frameCount();
-    state.freeSamples   = p->stream->bufferSize() - state.queuedSamples;
+    const int frameSize = p->format.bytesPerFrame();
+
+    state.queuedSamples = static_cast<int>(p->buffer.readAvailable()) / frameSize;
+    state.freeSamples   = static_cast<int>(p->buffer.writeAvailable()) / frameSize;
+    state.underruns     = p->underruns.load(std::memory_order_relaxed);
 
     return state;
 }
@@ -420,16 +444,20 @@ int PipeWireOutput::bufferSize() const
 
 int PipeWireOutput::write(const AudioBuffer& buffer)
 {
-    const ThreadLoopGuard guard{p->loop.get()};
+    const auto frameSize = static_cast<size_t>(p->format.bytesPerFrame());
 
-    p->buffer.append(buffer.constData());
-    p->bufferPos += buffer.byteCount();
+    // Only whole frames, so the consumer never sees a partial frame
+    const auto bytes   = std::min(buffer.constData().size(), p->buffer.writeAvailable() / frameSize * frameSize);
+    const auto written = p->buffer.write(buffer.data(), bytes);
 
-    return buffer.sampleCount();
+    return static_cast<int>(written / frameSize);
 }
 
 void PipeWireOutput::setPaused(bool pause)
 {
+    p->playing = !pause;
+    p->starved = false;
+
     const ThreadLoopGuard guard{p->loop.get()};
     p->stream->setActive(!pause);
 }
@@ -160,7 +160,7 @@ OutputDevices SdlOutput::getAllDevices() const
 int SdlOutput::write(const AudioBuffer& buffer)
 {
     if(SDL_QueueAudio(m_audioDeviceId, buffer.constData().data(), buffer.byteCount()) == 0) {
-        return buffer.sampleCount();
+        return buffer.frameCount();
     }
 
     return 0;
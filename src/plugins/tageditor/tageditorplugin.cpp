@@ -22,6 +22,7 @@
 #include "tageditorwidget.h"
 
 #include <core/library/musiclibrary.h>
+#include <gui/metadatawriter.h>
 #include <gui/plugins/guiplugincontext.h>
 #include <gui/propertiesdialog.h>
 #include <gui/trackselectioncontroller.h>
@@ -56,7 +57,7 @@ void TagEditorPlugin::initialise(const GuiPluginContext& context)
     m_propertiesDialog->insertTab(0, QStringLiteral("Metadata"), [this]() {
         auto* tagEditor = new TagEditorWidget(m_trackSelection->selectedTracks(), m_actionManager, m_settings);
         QObject::connect(tagEditor, &TagEditorWidget::trackMetadataChanged, m_library,
-                         &MusicLibrary::updateTrackMetadata);
+                         [this](const TrackList& tracks) { Gui::writeTrackMetadata(m_library, tracks); });
         return tagEditor;
     });
 }
@@ -86,6 +86,35 @@ QDataStream& operator<<(QDataStream& stream, const std::vector<WaveformData<int1
     return stream;
 }
 
+QDataStream& operator<<(QDataStream& stream,
+                        const std::vector<std::vector<WaveformData<int16_t>::ChannelData>>& levels)
+{
+    stream << static_cast<int>(levels.size());
+
+    for(const auto& level : levels) {
+        stream << level;
+    }
+
+    return stream;
+}
+
+QDataStream& operator>>(QDataStream& stream, std::vector<std::vector<WaveformData<int16_t>::ChannelData>>& levels)
+{
+    int size;
+    stream >> size;
+
+    levels.reserve(size);
+
+    while(size > 0) {
+        --size;
+
+        std::vector<WaveformData<int16_t>::ChannelData> level;
+        stream >> level;
+        levels.emplace_back(std::move(level));
+    }
+    return stream;
+}
+
 QByteArray serialiseData(const WaveformData<int16_t>& data)
 {
     QByteArray out;
@@ -93,6 +122,7 @@ QByteArray serialiseData(const WaveformData<int16_t>& data)
     stream.setVersion(QDataStream::Qt_6_0);
 
     stream << data.channelData;
+    stream << data.levels;
 
     out = qCompress(out, 9);
 
@@ -106,6 +136,11 @@ void deserialiseData(const QByteArray& cacheData, WaveformData<int16_t>& data)
     stream.setVersion(QDataStream::Qt_6_0);
 
     stream >> data.channelData;
+
+    // Levels are missing from entries cached by older versions
+    if(!stream.atEnd()) {
+        stream >> data.levels;
+    }
 }
 } // namespace
 
@@ -24,6 +24,7 @@
 #include "settings/wavebarsettingspage.h"
 #include "wavebarconstants.h"
 #include "wavebarwidget.h"
+#include "waveformbatchbuilder.h"
 #include "waveformbuilder.h"
 
 #include <core/engine/enginecontroller.h>
@@ -78,7 +79,7 @@ struct WaveBarPlugin::Private
     FyWidget* createWavebar()
     {
         if(!waveBuilder) {
-            waveBuilder = std::make_unique<WaveformBuilder>(engine->createDecoder(), dbPool, settings);
+            waveBuilder = std::make_unique<WaveformBuilder>(engine, dbPool, settings);
         }
 
         auto* wavebar = new WaveBarWidget(waveBuilder.get(), playerController, settings);
@@ -116,19 +117,19 @@ struct WaveBarPlugin::Private
         dialog->setWindowModality(Qt::WindowModal);
         dialog->setValue(0);
 
-        auto* builder = new WaveformBuilder(engine->createDecoder(), dbPool, settings, dialog);
+        auto* builder = new WaveformBatchBuilder(engine, playerController, dbPool, dialog);
 
-        QObject::connect(builder, &WaveformBuilder::waveformGenerated, dialog, [dialog, builder]() {
-            if(dialog->wasCanceled()) {
-                delete builder;
-            }
-
-            dialog->setValue(dialog->value() + 1);
-        });
+        QObject::connect(builder, &WaveformBatchBuilder::progressChanged, dialog,
+                         [dialog, builder](int processed, double tracksPerSecond) {
+                             dialog->setLabelText(QStringLiteral("Generating waveform data using %1 threads (%2/s)…")
+                                                      .arg(builder->threadCount())
+                                                      .arg(tracksPerSecond, 0, 'f', 1));
+                             dialog->setValue(processed);
+                         });
+        QObject::connect(dialog, &QProgressDialog::canceled, builder, &WaveformBatchBuilder::cancel);
+        QObject::connect(builder, &WaveformBatchBuilder::finished, dialog, &QObject::deleteLater);
 
-        for(const Track& track : selectedTracks) {
-            builder->generate(track, !onlyMissing);
-        }
+        builder->generate(selectedTracks, !onlyMissing);
     }
 
     void removeSelection()
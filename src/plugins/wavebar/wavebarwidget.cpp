@@ -107,7 +107,8 @@ void WaveBarWidget::loadLayoutData(const QJsonObject& layout)
 void WaveBarWidget::changeTrack(const Track& track)
 {
     m_seekbar->setPosition(0);
-    m_builder->generateAndScale(track);
+    // A new track only starts decoding from the beginning if we're already playing
+    m_builder->generateAndScale(track, false, m_playerController->playState() == PlayState::Playing);
 }
 
 void WaveBarWidget::changePosition(uint64_t pos)
@@ -0,0 +1,248 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "waveformbatchbuilder.h"
+
+#include "waveformgenerator.h"
+
+#include <core/engine/enginecontroller.h>
+#include <core/player/playercontroller.h>
+
+#include <QDebug>
+
+#include <algorithm>
+#include <utility>
+
+constexpr auto BatchSize = 32;
+
+namespace Fooyin::WaveBar {
+struct WaveformBatchBuilder::GeneratorThread
+{
+    QThread thread;
+    WaveformGenerator generator;
+    bool busy{false};
+
+    GeneratorThread(std::unique_ptr<AudioDecoder> decoder, DbConnectionPoolPtr dbPool)
+        : generator{std::move(decoder), std::move(dbPool)}
+    { }
+};
+
+WaveformBatchBuilder::WaveformBatchBuilder(EngineController* engine, PlayerController* playerController,
+                                           DbConnectionPoolPtr dbPool, QObject* parent)
+    : QObject{parent}
+    , m_playerController{playerController}
+    , m_writer{dbPool}
+    , m_pendingWrites{0}
+    , m_update{false}
+    , m_paused{playerController->playState() == PlayState::Playing}
+    , m_cancelled{false}
+    , m_batch{0}
+    , m_processed{0}
+    , m_generated{0}
+    , m_generatedDuration{0}
+{
+    // Leave a core free for playback and the UI
+    const int threadCount = std::max(1, QThread::idealThreadCount() - 1);
+
+    for(int i{0}; i < threadCount; ++i) {
+        auto* worker = m_workers.emplace_back(std::make_unique<GeneratorThread>(engine->createDecoder(), dbPool)).get();
+
+        worker->generator.moveToThread(&worker->thread);
+
+        QObject::connect(&worker->generator, &WaveformGenerator::cacheDataGenerated, this,
+                         [this, worker](const Track& track, const QString& key, const WaveformData<int16_t>& data) {
+                             handleGenerated(worker, track, key, data);
+                         });
+
+        // On Linux, threads with idle priority are scheduled with SCHED_IDLE,
+        // which the kernel also places in the idle I/O class.
+        worker->thread.start(QThread::IdlePriority);
+
+        QMetaObject::invokeMethod(&worker->generator, &Worker::initialiseThread);
+    }
+
+    m_writer.moveToThread(&m_writerThread);
+
+    QObject::connect(&m_writer, &WaveformCacheWriter::entriesStored, this, [this]() {
+        --m_pendingWrites;
+        checkFinished();
+    });
+    QObject::connect(m_playerController, &PlayerController::playStateChanged, this,
+                     &WaveformBatchBuilder::playStateChanged);
+
+    m_writerThread.start(QThread::LowPriority);
+
+    QMetaObject::invokeMethod(&m_writer, &Worker::initialiseThread);
+}
+
+WaveformBatchBuilder::~WaveformBatchBuilder()
+{
+    m_queue.clear();
+
+    for(auto& worker : m_workers) {
+        worker->generator.closeThread();
+        worker->thread.quit();
+        worker->thread.wait();
+    }
+
+    if(!m_pending.empty()) {
+        QMetaObject::invokeMethod(
+            &m_writer, [this, entries = std::exchange(m_pending, {})]() { m_writer.store(entries); },
+            Qt::BlockingQueuedConnection);
+    }
+
+    m_writer.closeThread();
+    m_writerThread.quit();
+    m_writerThread.wait();
+}
+
+void WaveformBatchBuilder::generate(const TrackList& tracks, bool update)
+{
+    m_update = update;
+    m_queue.insert(m_queue.end(), tracks.cbegin(), tracks.cend());
+
+    if(!m_timer.isValid()) {
+        m_timer.start();
+    }
+
+    dispatch();
+}
+
+void WaveformBatchBuilder::cancel()
+{
+    m_cancelled = true;
+    m_queue.clear();
+    m_batch.fetch_add(1, std::memory_order_release);
+
+    for(auto& worker : m_workers) {
+        worker->generator.stopThread();
+    }
+
+    checkFinished();
+}
+
+int WaveformBatchBuilder::threadCount() const
+{
+    return static_cast<int>(m_workers.size());
+}
+
+void WaveformBatchBuilder::dispatch()
+{
+    if(m_paused) {
+        return;
+    }
+
+    for(auto& worker : m_workers) {
+        if(m_queue.empty()) {
+            break;
+        }
+        if(worker->busy) {
+            continue;
+        }
+
+        const Track track = m_queue.front();
+        m_queue.pop_front();
+
+        worker->busy = true;
+        QMetaObject::invokeMethod(&worker->generator,
+                                  [this, worker, track, update = m_update, batch = m_batch.load()]() {
+                                      // Stopping the generator doesn't remove jobs which are already queued
+                                      if(batch != m_batch.load(std::memory_order_acquire)) {
+                                          emit worker->generator.cacheDataGenerated(track, {}, {});
+                                          return;
+                                      }
+                                      worker->generator.generateForCache(track, update);
+                                  });
+    }
+}
+
+void WaveformBatchBuilder::handleGenerated(GeneratorThread* worker, const Track& track, const QString& key,
+                                           const WaveformData<int16_t>& data)
+{
+    worker->busy = false;
+    ++m_processed;
+
+    if(!key.isEmpty()) {
+        ++m_generated;
+        m_generatedDuration += track.duration();
+        m_pending.emplace_back(key, data);
+    }
+
+    if(std::cmp_greater_equal(m_pending.size(), BatchSize)) {
+        flush();
+    }
+
+    emit progressChanged(m_processed, tracksPerSecond());
+
+    dispatch();
+    checkFinished();
+}
+
+void WaveformBatchBuilder::flush()
+{
+    if(m_pending.empty()) {
+        return;
+    }
+
+    ++m_pendingWrites;
+    QMetaObject::invokeMethod(&m_writer,
+                              [this, entries = std::exchange(m_pending, {})]() { m_writer.store(entries); });
+}
+
+void WaveformBatchBuilder::checkFinished()
+{
+    if(!m_queue.empty() || std::ranges::any_of(m_workers, [](const auto& worker) { return worker->busy; })) {
+        return;
+    }
+
+    if(!m_pending.empty()) {
+        flush();
+    }
+
+    if(m_pendingWrites > 0 || !m_timer.isValid()) {
+        return;
+    }
+
+    const double elapsedSecs = static_cast<double>(m_timer.elapsed()) / 1000;
+    const double realtime    = elapsedSecs > 0 ? static_cast<double>(m_generatedDuration) / 1000 / elapsedSecs : 0;
+
+    qDebug() << "[WaveBar] Generated" << m_generated << "of" << m_processed << "waveforms in" << elapsedSecs
+             << "s using" << threadCount() << "threads (" << tracksPerSecond() << "tracks/s," << realtime
+             << "x realtime)" << (m_cancelled ? "- cancelled" : "");
+
+    m_timer.invalidate();
+
+    emit finished();
+}
+
+void WaveformBatchBuilder::playStateChanged(PlayState state)
+{
+    m_paused = state == PlayState::Playing;
+    dispatch();
+}
+
+double WaveformBatchBuilder::tracksPerSecond() const
+{
+    if(!m_timer.isValid() || m_timer.elapsed() == 0) {
+        return 0;
+    }
+
+    return static_cast<double>(m_processed) * 1000 / static_cast<double>(m_timer.elapsed());
+}
+} // namespace Fooyin::WaveBar
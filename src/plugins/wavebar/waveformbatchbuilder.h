@@ -0,0 +1,96 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "waveformcachewriter.h"
+
+#include <core/player/playerdefs.h>
+#include <core/track.h>
+#include <utils/database/dbconnectionpool.h>
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QThread>
+
+#include <atomic>
+#include <deque>
+
+namespace Fooyin {
+class EngineController;
+class PlayerController;
+
+namespace WaveBar {
+/*!
+ * Generates waveforms for a list of tracks using a pool of generators,
+ * each with their own decoder and thread.
+ * Generators run at idle priority and no new tracks are started while
+ * playback is active.
+ */
+class WaveformBatchBuilder : public QObject
+{
+    Q_OBJECT
+
+public:
+    WaveformBatchBuilder(EngineController* engine, PlayerController* playerController, DbConnectionPoolPtr dbPool,
+                         QObject* parent = nullptr);
+    ~WaveformBatchBuilder() override;
+
+    void generate(const TrackList& tracks, bool update = false);
+    void cancel();
+
+    [[nodiscard]] int threadCount() const;
+
+signals:
+    void progressChanged(int processed, double tracksPerSecond);
+    void finished();
+
+private:
+    struct GeneratorThread;
+
+    void dispatch();
+    void handleGenerated(GeneratorThread* worker, const Track& track, const QString& key,
+                         const WaveformData<int16_t>& data);
+    void flush();
+    void checkFinished();
+    void playStateChanged(PlayState state);
+    [[nodiscard]] double tracksPerSecond() const;
+
+    PlayerController* m_playerController;
+
+    QThread m_writerThread;
+    WaveformCacheWriter m_writer;
+    std::vector<std::unique_ptr<GeneratorThread>> m_workers;
+
+    std::deque<Track> m_queue;
+    WaveformCacheEntries m_pending;
+    int m_pendingWrites;
+    bool m_update;
+    bool m_paused;
+    bool m_cancelled;
+    // Incremented on cancel, so jobs already queued to a generator can tell they're stale
+    std::atomic<int> m_batch;
+
+    int m_processed;
+    int m_generated;
+    uint64_t m_generatedDuration;
+    QElapsedTimer m_timer;
+};
+} // namespace WaveBar
+} // namespace Fooyin
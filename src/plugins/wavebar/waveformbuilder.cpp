@@ -20,17 +20,19 @@
 #include "waveformbuilder.h"
 
 #include <core/engine/audiodecoder.h>
+#include <core/engine/enginecontroller.h>
 #include <core/track.h>
 #include <utils/settings/settingsmanager.h>
 
 #include <utility>
 
 namespace Fooyin::WaveBar {
-WaveformBuilder::WaveformBuilder(std::unique_ptr<AudioDecoder> decoder, DbConnectionPoolPtr dbPool,
-                                 SettingsManager* settings, QObject* parent)
+WaveformBuilder::WaveformBuilder(EngineController* engine, DbConnectionPoolPtr dbPool, SettingsManager* settings,
+                                 QObject* parent)
     : QObject{parent}
+    , m_engine{engine}
     , m_settings{settings}
-    , m_generator{std::move(decoder), std::move(dbPool)}
+    , m_generator{engine->createDecoder(), std::move(dbPool)}
     , m_width{0}
     , m_rescale{false}
 {
@@ -48,6 +50,11 @@ WaveformBuilder::WaveformBuilder(std::unique_ptr<AudioDecoder> decoder, DbConnec
     });
     QObject::connect(&m_rescaler, &WaveformRescaler::waveformRescaled, this, &WaveformBuilder::waveformRescaled);
 
+    QObject::connect(m_engine, &EngineController::pcmDecoded, &m_generator, &WaveformGenerator::processPcm);
+    QObject::connect(m_engine, &EngineController::pcmTapInterrupted, &m_generator,
+                     &WaveformGenerator::pcmInterrupted);
+    m_engine->registerPcmTap();
+
     m_settings->subscribe<Settings::WaveBar::BarWidth>(this, &WaveformBuilder::updateRescaler);
     m_settings->subscribe<Settings::WaveBar::BarGap>(this, &WaveformBuilder::updateRescaler);
     m_settings->subscribe<Settings::WaveBar::Downmix>(this, &WaveformBuilder::updateRescaler);
@@ -60,6 +67,8 @@ WaveformBuilder::WaveformBuilder(std::unique_ptr<AudioDecoder> decoder, DbConnec
 
 WaveformBuilder::~WaveformBuilder()
 {
+    m_engine->unregisterPcmTap();
+
     m_generator.closeThread();
     m_rescaler.closeThread();
 
@@ -77,13 +86,20 @@ void WaveformBuilder::generate(const Track& track, bool update)
     QMetaObject::invokeMethod(&m_generator, [this, track, update]() { m_generator.generate(track, update); });
 }
 
-void WaveformBuilder::generateAndScale(const Track& track, bool update)
+void WaveformBuilder::generateAndScale(const Track& track, bool update, bool fromPlayback)
 {
     m_generator.stopThread();
     m_rescaler.stopThread();
     m_rescale = true;
 
-    QMetaObject::invokeMethod(&m_generator, [this, track, update]() { m_generator.generateAndRender(track, update); });
+    if(fromPlayback) {
+        QMetaObject::invokeMethod(&m_generator,
+                                  [this, track, update]() { m_generator.generateFromPcm(track, update); });
+    }
+    else {
+        QMetaObject::invokeMethod(&m_generator,
+                                  [this, track, update]() { m_generator.generateAndRender(track, update); });
+    }
 }
 
 void WaveformBuilder::rescale(const int width)
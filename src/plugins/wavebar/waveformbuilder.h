@@ -32,6 +32,7 @@
 
 namespace Fooyin {
 class AudioBuffer;
+class EngineController;
 class SettingsManager;
 
 namespace WaveBar {
@@ -40,12 +41,16 @@ class WaveformBuilder : public QObject
     Q_OBJECT
 
 public:
-    explicit WaveformBuilder(std::unique_ptr<AudioDecoder> decoder, DbConnectionPoolPtr dbPool,
-                             SettingsManager* settings, QObject* parent = nullptr);
+    explicit WaveformBuilder(EngineController* engine, DbConnectionPoolPtr dbPool, SettingsManager* settings,
+                             QObject* parent = nullptr);
     ~WaveformBuilder() override;
 
     void generate(const Track& track, bool update = false);
-    void generateAndScale(const Track& track, bool update = false);
+    /*!
+     * Generates (or loads from the cache) and rescales the waveform for @p track.
+     * If @p fromPlayback is true, the audio decoded for playback is used rather than decoding the track again.
+     */
+    void generateAndScale(const Track& track, bool update = false, bool fromPlayback = false);
     void rescale(int width);
 
 signals:
@@ -56,6 +61,7 @@ signals:
 private:
     void updateRescaler();
 
+    EngineController* m_engine;
     SettingsManager* m_settings;
 
     QThread m_generatorThread;
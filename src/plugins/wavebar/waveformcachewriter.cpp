@@ -0,0 +1,69 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "waveformcachewriter.h"
+
+#include <utils/database/dbtransaction.h>
+
+#include <QDebug>
+
+namespace Fooyin::WaveBar {
+WaveformCacheWriter::WaveformCacheWriter(DbConnectionPoolPtr dbPool, QObject* parent)
+    : Worker{parent}
+    , m_dbPool{std::move(dbPool)}
+{ }
+
+void WaveformCacheWriter::initialiseThread()
+{
+    Worker::initialiseThread();
+
+    m_dbHandler = std::make_unique<DbConnectionHandler>(m_dbPool);
+    m_waveDb.initialise(DbConnectionProvider{m_dbPool});
+    m_waveDb.initialiseDatabase();
+}
+
+void WaveformCacheWriter::store(const WaveformCacheEntries& entries)
+{
+    if(closing() || entries.empty()) {
+        return;
+    }
+
+    setState(Running);
+
+    DbTransaction transaction{m_waveDb.db()};
+
+    int stored{0};
+    for(const auto& [key, data] : entries) {
+        if(m_waveDb.storeInCache(key, data)) {
+            ++stored;
+        }
+        else {
+            qWarning() << "[WaveBar] Unable to store waveform with key:" << key;
+        }
+    }
+
+    if(transaction && !transaction.commit()) {
+        qWarning() << "[WaveBar] Unable to commit waveform batch of" << entries.size() << "tracks";
+        stored = 0;
+    }
+
+    setState(Idle);
+    emit entriesStored(stored);
+}
+} // namespace Fooyin::WaveBar
@@ -0,0 +1,56 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "wavebardatabase.h"
+
+#include <utils/database/dbconnectionhandler.h>
+#include <utils/database/dbconnectionpool.h>
+#include <utils/worker.h>
+
+namespace Fooyin::WaveBar {
+using WaveformCacheEntry = std::pair<QString, WaveformData<int16_t>>;
+using WaveformCacheEntries = std::vector<WaveformCacheEntry>;
+
+/*!
+ * Writes generated waveforms to the cache in batches.
+ * Each batch is stored within a single transaction.
+ */
+class WaveformCacheWriter : public Worker
+{
+    Q_OBJECT
+
+public:
+    explicit WaveformCacheWriter(DbConnectionPoolPtr dbPool, QObject* parent = nullptr);
+
+signals:
+    void entriesStored(int count);
+
+public slots:
+    void initialiseThread() override;
+
+    void store(const Fooyin::WaveBar::WaveformCacheEntries& entries);
+
+private:
+    DbConnectionPoolPtr m_dbPool;
+    std::unique_ptr<DbConnectionHandler> m_dbHandler;
+    WaveBarDatabase m_waveDb;
+};
+} // namespace Fooyin::WaveBar
@@ -21,6 +21,8 @@
 
 #include <core/engine/audioformat.h>
 
+#include <cmath>
+#include <utility>
 #include <vector>
 
 namespace Fooyin::WaveBar {
@@ -48,6 +50,11 @@ struct WaveformData
         bool operator<=>(const ChannelData& other) const = default;
     };
     std::vector<ChannelData> channelData;
+    /*!
+     * Power-of-two reductions of channelData.
+     * Level n holds ceil(sampleCount / 2^(n + 1)) samples.
+     */
+    std::vector<std::vector<ChannelData>> levels;
 
     bool operator<=>(const WaveformData<T>& other) const = default;
 
@@ -64,5 +71,40 @@ struct WaveformData
 
         return static_cast<int>(channelData.front().max.size());
     }
+
+    /** Rebuilds levels from channelData, stopping once a level has fewer than @p minSamples samples. */
+    void buildLevels(int minSamples = 32)
+    {
+        levels.clear();
+
+        const std::vector<ChannelData>* prev = &channelData;
+
+        while(!prev->empty() && std::cmp_greater_equal(prev->front().max.size(), minSamples * 2)) {
+            std::vector<ChannelData> level(prev->size());
+
+            for(size_t ch{0}; ch < prev->size(); ++ch) {
+                const auto& [inMax, inMin, inRms] = prev->at(ch);
+                auto& [outMax, outMin, outRms]    = level.at(ch);
+
+                const size_t count = (inMax.size() + 1) / 2;
+                outMax.reserve(count);
+                outMin.reserve(count);
+                outRms.reserve(count);
+
+                for(size_t i{0}; i < inMax.size(); i += 2) {
+                    const size_t next = std::min(i + 1, inMax.size() - 1);
+                    const auto rmsA   = static_cast<double>(inRms.at(i));
+                    const auto rmsB   = static_cast<double>(inRms.at(next));
+
+                    outMax.emplace_back(std::max(inMax.at(i), inMax.at(next)));
+                    outMin.emplace_back(std::min(inMin.at(i), inMin.at(next)));
+                    outRms.emplace_back(static_cast<T>(std::sqrt((rmsA * rmsA + rmsB * rmsB) / 2)));
+                }
+            }
+
+            levels.emplace_back(std::move(level));
+            prev = &levels.back();
+        }
+    }
 };
 } // namespace Fooyin::WaveBar
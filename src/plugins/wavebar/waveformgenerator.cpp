@@ -24,11 +24,16 @@
 #include <utils/paths.h>
 
 #include <QDebug>
+#include <QTimer>
 
 #include <cfenv>
 #include <utility>
 
 constexpr auto SampleCount = 2048;
+// Maximum duration of audio decoded for playback to hold before generateFromPcm is called
+constexpr auto MaxPendingPcm = 10000;
+// How long generateFromPcm waits for more audio before decoding the track itself
+constexpr auto PcmTimeout = 10000;
 
 namespace {
 float convertSampleToFloat(const int16_t inSample)
@@ -53,46 +58,55 @@ int16_t convertSampleToInt16(const float inSample)
 }
 
 template <typename OutputType, typename InputType>
-Fooyin::WaveBar::WaveformData<OutputType> convertCache(const Fooyin::WaveBar::WaveformData<InputType>& cacheData)
+OutputType convertSample(const InputType sample)
 {
-    Fooyin::WaveBar::WaveformData<OutputType> data;
-    const size_t channels = cacheData.channelData.size();
-    data.channelData.resize(channels);
+    if constexpr(std::is_same_v<InputType, int16_t>) {
+        return convertSampleToFloat(sample);
+    }
+    else {
+        return convertSampleToInt16(sample);
+    }
+}
+
+template <typename OutputType, typename InputType>
+std::vector<typename Fooyin::WaveBar::WaveformData<OutputType>::ChannelData>
+convertChannels(const std::vector<typename Fooyin::WaveBar::WaveformData<InputType>::ChannelData>& inChannels)
+{
+    std::vector<typename Fooyin::WaveBar::WaveformData<OutputType>::ChannelData> outChannels(inChannels.size());
 
-    for(size_t channel{0}; channel < channels; ++channel) {
-        auto& inChannelData  = cacheData.channelData[channel];
-        auto& outChannelData = data.channelData[channel];
+    for(size_t channel{0}; channel < inChannels.size(); ++channel) {
+        auto& inChannelData  = inChannels[channel];
+        auto& outChannelData = outChannels[channel];
 
         outChannelData.max.reserve(inChannelData.max.size());
         outChannelData.min.reserve(inChannelData.min.size());
         outChannelData.rms.reserve(inChannelData.rms.size());
 
         for(const auto& sample : inChannelData.max) {
-            if constexpr(std::is_same_v<InputType, int16_t>) {
-                outChannelData.max.emplace_back(convertSampleToFloat(sample));
-            }
-            else {
-                outChannelData.max.emplace_back(convertSampleToInt16(sample));
-            }
+            outChannelData.max.emplace_back(convertSample<OutputType>(sample));
         }
         for(const auto& sample : inChannelData.min) {
-            if constexpr(std::is_same_v<InputType, int16_t>) {
-                outChannelData.min.emplace_back(convertSampleToFloat(sample));
-            }
-            else {
-                outChannelData.min.emplace_back(convertSampleToInt16(sample));
-            }
+            outChannelData.min.emplace_back(convertSample<OutputType>(sample));
         }
         for(const auto& sample : inChannelData.rms) {
-            if constexpr(std::is_same_v<InputType, int16_t>) {
-                outChannelData.rms.emplace_back(convertSampleToFloat(sample));
-            }
-            else {
-                outChannelData.rms.emplace_back(convertSampleToInt16(sample));
-            }
+            outChannelData.rms.emplace_back(convertSample<OutputType>(sample));
         }
     }
 
+    return outChannels;
+}
+
+template <typename OutputType, typename InputType>
+Fooyin::WaveBar::WaveformData<OutputType> convertCache(const Fooyin::WaveBar::WaveformData<InputType>& cacheData)
+{
+    Fooyin::WaveBar::WaveformData<OutputType> data;
+    data.channelData = convertChannels<OutputType, InputType>(cacheData.channelData);
+
+    data.levels.reserve(cacheData.levels.size());
+    for(const auto& level : cacheData.levels) {
+        data.levels.emplace_back(convertChannels<OutputType, InputType>(level));
+    }
+
     return data;
 }
 } // namespace
@@ -102,8 +116,21 @@ WaveformGenerator::WaveformGenerator(std::unique_ptr<AudioDecoder> decoder, DbCo
     : Worker{parent}
     , m_decoder{std::move(decoder)}
     , m_dbPool{std::move(dbPool)}
+    , m_fromPcm{false}
+    , m_pcmUpdate{false}
+    , m_pcmUnusable{false}
+    , m_pendingPcmDuration{0}
+    , m_pcmBufferSize{0}
+    , m_pcmUpdateThreshold{0}
+    , m_pcmProcessedCount{0}
+    , m_pcmTimeout{new QTimer(this)}
 {
     m_requiredFormat.setSampleFormat(SampleFormat::Float);
+
+    // Playback may stop delivering audio without an interruption (decode error, track skipped...)
+    m_pcmTimeout->setSingleShot(true);
+    m_pcmTimeout->setInterval(PcmTimeout);
+    QObject::connect(m_pcmTimeout, &QTimer::timeout, this, [this]() { pcmInterrupted(m_track); });
 }
 
 void WaveformGenerator::initialiseThread()
@@ -136,40 +163,51 @@ void WaveformGenerator::generate(const Track& track, bool update)
 
     emit generatingWaveform();
 
-    const uint64_t durationSecs = m_data.duration / 1000;
-    const int samplesPerChannel = static_cast<int>(std::floor(durationSecs * m_format.sampleRate()));
-    const int samplesPerBuffer  = static_cast<int>(std::ceil(static_cast<double>(samplesPerChannel) / SampleCount));
-    const int bufferSize        = samplesPerBuffer * m_format.bytesPerFrame();
+    if(!decode()) {
+        return;
+    }
 
-    m_decoder->start();
+    if(!m_waveDb.storeInCache(trackKey, convertCache<int16_t>(m_data))) {
+        qWarning() << "[WaveBar] Unable to store waveform for track:" << m_track.filepath();
+    }
 
-    while(true) {
-        if(!mayRun()) {
-            m_decoder->stop();
-            return;
-        }
+    if(!closing()) {
+        setState(Idle);
+    }
 
-        auto buffer = m_decoder->readBuffer(static_cast<size_t>(bufferSize));
-        if(!buffer.isValid()) {
-            m_data.complete = true;
-            break;
-        }
+    emit waveformGenerated(m_data);
+}
 
-        buffer = Audio::convert(buffer, m_requiredFormat);
-        processBuffer(buffer);
+void WaveformGenerator::generateForCache(const Track& track, bool update)
+{
+    if(closing()) {
+        return;
     }
 
-    m_decoder->stop();
+    const QString trackKey = setup(track);
+    if(trackKey.isEmpty()) {
+        emit cacheDataGenerated(track, {}, {});
+        return;
+    }
 
-    if(!m_waveDb.storeInCache(trackKey, convertCache<int16_t>(m_data))) {
-        qWarning() << "[WaveBar] Unable to store waveform for track:" << m_track.filepath();
+    setState(Running);
+
+    if(!update && m_waveDb.existsInCache(trackKey)) {
+        setState(Idle);
+        emit cacheDataGenerated(track, {}, {});
+        return;
+    }
+
+    if(!decode()) {
+        emit cacheDataGenerated(track, {}, {});
+        return;
     }
 
     if(!closing()) {
         setState(Idle);
     }
 
-    emit waveformGenerated(m_data);
+    emit cacheDataGenerated(track, trackKey, convertCache<int16_t>(m_data));
 }
 
 void WaveformGenerator::generateAndRender(const Track& track, bool update)
@@ -188,9 +226,15 @@ void WaveformGenerator::generateAndRender(const Track& track, bool update)
     if(!update && m_waveDb.existsInCache(trackKey)) {
         WaveformData<int16_t> data;
         if(m_waveDb.loadCachedData(trackKey, data)) {
-            const auto floatData = convertCache<float>(data);
-            m_data.channelData   = floatData.channelData;
-            m_data.complete      = true;
+            auto floatData     = convertCache<float>(data);
+            m_data.channelData = std::move(floatData.channelData);
+            m_data.levels      = std::move(floatData.levels);
+            m_data.complete    = true;
+
+            if(m_data.levels.empty()) {
+                // Cached before levels were stored
+                m_data.buildLevels();
+            }
 
             setState(Idle);
             emit waveformGenerated(m_data);
@@ -201,12 +245,145 @@ void WaveformGenerator::generateAndRender(const Track& track, bool update)
 
     emit generatingWaveform();
 
+    const uint64_t durationSecs = m_data.duration / 1000;
+    const int numOfUpdates      = std::max<int>(1, std::floor(static_cast<double>(durationSecs) / 30));
+    const int updateThreshold   = SampleCount / numOfUpdates;
+
+    if(!decode(updateThreshold)) {
+        return;
+    }
+
+    if(!m_waveDb.storeInCache(trackKey, convertCache<int16_t>(m_data))) {
+        qWarning() << "[WaveBar] Unable to store waveform for track:" << m_track.filepath();
+    }
+
+    if(!closing()) {
+        setState(Idle);
+    }
+
+    emit waveformGenerated(m_data);
+}
+
+void WaveformGenerator::generateFromPcm(const Track& track, bool update)
+{
+    if(closing()) {
+        return;
+    }
+
+    const bool pcmUnusable = m_pcmTrack == track && m_pcmUnusable;
+
+    if(!track.isValid() || pcmUnusable || (!update && m_waveDb.existsInCache(WaveBarDatabase::cacheKey(track)))) {
+        generateAndRender(track, update);
+        return;
+    }
+
+    m_decoder->stop();
+    m_data      = {};
+    m_track     = track;
+    m_fromPcm   = true;
+    m_pcmUpdate = update;
+    m_pcmBuffer = {};
+
+    setState(Running);
+    emit generatingWaveform();
+    m_pcmTimeout->start();
+
+    if(m_pcmTrack == track) {
+        m_pendingPcmDuration = 0;
+        const auto pending   = std::exchange(m_pendingPcm, {});
+        for(const AudioBuffer& buffer : pending) {
+            consumePcm(buffer);
+        }
+    }
+}
+
+void WaveformGenerator::processPcm(const Track& track, const AudioBuffer& buffer)
+{
+    if(closing()) {
+        return;
+    }
+
+    if(m_fromPcm && track == m_track) {
+        consumePcm(buffer);
+        return;
+    }
+
+    // generateFromPcm may not have been called yet for this track, so hold on to the start of the stream
+    if(m_pcmTrack != track) {
+        m_pcmTrack           = track;
+        m_pcmUnusable        = false;
+        m_pendingPcmDuration = 0;
+        m_pendingPcm.clear();
+    }
+
+    if(m_pcmUnusable) {
+        return;
+    }
+
+    if(m_pendingPcm.empty() && buffer.isValid() && buffer.startTime() != 0) {
+        m_pcmUnusable = true;
+        return;
+    }
+
+    m_pendingPcm.push_back(buffer);
+    m_pendingPcmDuration += buffer.duration();
+
+    if(m_pendingPcmDuration > MaxPendingPcm) {
+        m_pcmUnusable        = true;
+        m_pendingPcmDuration = 0;
+        m_pendingPcm.clear();
+    }
+}
+
+void WaveformGenerator::pcmInterrupted(const Track& track)
+{
+    if(m_pcmTrack == track) {
+        m_pcmUnusable        = true;
+        m_pendingPcmDuration = 0;
+        m_pendingPcm.clear();
+    }
+
+    if(m_fromPcm && track == m_track && !closing()) {
+        m_pcmTimeout->stop();
+        // Fall back to decoding the track ourselves
+        generateAndRender(m_track, m_pcmUpdate);
+    }
+}
+
+QString WaveformGenerator::setup(const Track& track)
+{
+    m_decoder->stop();
+    m_pcmTimeout->stop();
+    m_data    = {};
+    m_fromPcm = false;
+
+    if(!track.isValid()) {
+        return {};
+    }
+
+    if(!m_decoder->init(track.filepath())) {
+        return {};
+    }
+
+    m_track  = track;
+    m_format = m_decoder->format();
+    m_requiredFormat.setChannelCount(m_format.channelCount());
+    m_requiredFormat.setSampleRate(m_format.sampleRate());
+
+    m_data.format   = m_requiredFormat;
+    m_data.duration = track.duration();
+    m_data.channels = m_format.channelCount();
+    m_data.channelData.resize(m_data.channels);
+
+    return WaveBarDatabase::cacheKey(m_track, m_data.channels);
+}
+
+bool WaveformGenerator::decode(int updateThreshold)
+{
     const uint64_t durationSecs = m_data.duration / 1000;
     const int samplesPerChannel = static_cast<int>(std::floor(durationSecs * m_format.sampleRate()));
     const int samplesPerBuffer  = static_cast<int>(std::ceil(static_cast<double>(samplesPerChannel) / SampleCount));
     const int bufferSize        = samplesPerBuffer * m_format.bytesPerFrame();
-    const int numOfUpdates      = std::max<int>(1, std::floor(static_cast<double>(durationSecs) / 30));
-    const int updateThreshold   = SampleCount / numOfUpdates;
 
     int processedCount{0};
 
@@ -215,7 +392,7 @@ void WaveformGenerator::generateAndRender(const Track& track, bool update)
     while(true) {
         if(!mayRun()) {
             m_decoder->stop();
-            return;
+            return false;
         }
 
         auto buffer = m_decoder->readBuffer(static_cast<size_t>(bufferSize));
@@ -227,49 +404,105 @@ void WaveformGenerator::generateAndRender(const Track& track, bool update)
         buffer = Audio::convert(buffer, m_requiredFormat);
         processBuffer(buffer);
 
-        if(processedCount++ == updateThreshold) {
+        if(updateThreshold > 0 && processedCount++ == updateThreshold) {
             processedCount = 0;
             emit waveformGenerated(m_data);
         }
     }
 
     m_decoder->stop();
+    m_data.buildLevels();
 
-    if(!m_waveDb.storeInCache(trackKey, convertCache<int16_t>(m_data))) {
-        qWarning() << "[WaveBar] Unable to store waveform for track:" << m_track.filepath();
+    return true;
+}
+
+void WaveformGenerator::setupPcm(const AudioFormat& format)
+{
+    m_format = format;
+    m_requiredFormat.setChannelCount(m_format.channelCount());
+    m_requiredFormat.setSampleRate(m_format.sampleRate());
+
+    m_data.format   = m_requiredFormat;
+    m_data.duration = m_track.duration();
+    m_data.channels = m_format.channelCount();
+    m_data.channelData.resize(m_data.channels);
+
+    const uint64_t durationSecs = m_data.duration / 1000;
+    const int samplesPerChannel = static_cast<int>(std::floor(durationSecs * m_format.sampleRate()));
+    const int samplesPerBuffer  = static_cast<int>(std::ceil(static_cast<double>(samplesPerChannel) / SampleCount));
+    const int numOfUpdates      = std::max<int>(1, std::floor(static_cast<double>(durationSecs) / 30));
+
+    m_pcmBufferSize      = std::max(1, samplesPerBuffer) * m_requiredFormat.bytesPerFrame();
+    m_pcmUpdateThreshold = SampleCount / numOfUpdates;
+    m_pcmProcessedCount  = 0;
+    m_pcmBuffer          = {m_requiredFormat, 0};
+}
+
+void WaveformGenerator::consumePcm(const AudioBuffer& buffer)
+{
+    if(!mayRun()) {
+        return;
     }
 
-    if(!closing()) {
-        setState(Idle);
+    m_pcmTimeout->start();
+
+    if(!buffer.isValid()) {
+        finishPcm();
+        return;
     }
 
-    emit waveformGenerated(m_data);
+    if(!m_pcmBuffer.isValid()) {
+        if(buffer.startTime() != 0) {
+            pcmInterrupted(m_track);
+            return;
+        }
+        setupPcm(buffer.format());
+    }
+
+    const auto converted = Audio::convert(buffer, m_requiredFormat);
+    m_pcmBuffer.append(converted.constData());
+
+    while(m_pcmBuffer.byteCount() >= m_pcmBufferSize) {
+        processBuffer({m_pcmBuffer.constData().first(static_cast<size_t>(m_pcmBufferSize)), m_requiredFormat, 0});
+        m_pcmBuffer.erase(static_cast<size_t>(m_pcmBufferSize));
+
+        if(m_pcmProcessedCount++ == m_pcmUpdateThreshold) {
+            m_pcmProcessedCount = 0;
+            emit waveformGenerated(m_data);
+        }
+    }
 }
 
-QString WaveformGenerator::setup(const Track& track)
+void WaveformGenerator::finishPcm()
 {
-    m_decoder->stop();
-    m_data = {};
+    m_pcmTimeout->stop();
 
-    if(!track.isValid()) {
-        return {};
+    if(!m_pcmBuffer.isValid()) {
+        // Playback ended without any audio, so decode the track ourselves
+        pcmInterrupted(m_track);
+        return;
     }
 
-    if(!m_decoder->init(track.filepath())) {
-        return {};
+    m_fromPcm = false;
+
+    if(m_pcmBuffer.byteCount() > 0) {
+        processBuffer(m_pcmBuffer);
     }
+    m_pcmBuffer = {};
 
-    m_track  = track;
-    m_format = m_decoder->format();
-    m_requiredFormat.setChannelCount(m_format.channelCount());
-    m_requiredFormat.setSampleRate(m_format.sampleRate());
+    m_data.complete = true;
+    m_data.buildLevels();
 
-    m_data.format   = m_requiredFormat;
-    m_data.duration = track.duration();
-    m_data.channels = m_format.channelCount();
-    m_data.channelData.resize(m_data.channels);
+    const QString trackKey = WaveBarDatabase::cacheKey(m_track, m_data.channels);
+    if(!m_waveDb.storeInCache(trackKey, convertCache<int16_t>(m_data))) {
+        qWarning() << "[WaveBar] Unable to store waveform for track:" << m_track.filepath();
+    }
 
-    return WaveBarDatabase::cacheKey(m_track, m_data.channels);
+    if(!closing()) {
+        setState(Idle);
+    }
+
+    emit waveformGenerated(m_data);
 }
 
 void WaveformGenerator::processBuffer(const AudioBuffer& buffer)
@@ -27,6 +27,8 @@
 #include <utils/database/dbconnectionpool.h>
 #include <utils/worker.h>
 
+class QTimer;
+
 namespace Fooyin::WaveBar {
 class WaveformGenerator : public Worker
 {
@@ -39,15 +41,35 @@ public:
 signals:
     void generatingWaveform();
     void waveformGenerated(const WaveformData<float>& data);
+    /*!
+     * Emitted by generateForCache once a track has been processed.
+     * @note @p key will be empty if the track was skipped or couldn't be decoded.
+     */
+    void cacheDataGenerated(const Fooyin::Track& track, const QString& key,
+                            const Fooyin::WaveBar::WaveformData<int16_t>& data);
 
 public slots:
     void initialiseThread() override;
     void generate(const Fooyin::Track& track, bool update = false);
     void generateAndRender(const Fooyin::Track& track, bool update = false);
+    /** Generates waveform data without storing it, leaving the caller to write it to the cache. */
+    void generateForCache(const Fooyin::Track& track, bool update = false);
+    /*!
+     * Generates waveform data from the audio decoded for playback, passed in through processPcm.
+     * Falls back to generateAndRender if playback of @p track didn't start from the beginning,
+     * is interrupted before the end, or no audio arrives for a while.
+     */
+    void generateFromPcm(const Fooyin::Track& track, bool update = false);
+    void processPcm(const Fooyin::Track& track, const Fooyin::AudioBuffer& buffer);
+    void pcmInterrupted(const Fooyin::Track& track);
 
 private:
     QString setup(const Track& track);
+    bool decode(int updateThreshold = 0);
     void processBuffer(const AudioBuffer& buffer);
+    void setupPcm(const AudioFormat& format);
+    void consumePcm(const AudioBuffer& buffer);
+    void finishPcm();
 
     std::unique_ptr<AudioDecoder> m_decoder;
     DbConnectionPoolPtr m_dbPool;
@@ -58,5 +80,17 @@ private:
     AudioFormat m_format;
     AudioFormat m_requiredFormat;
     WaveformData<float> m_data;
+
+    bool m_fromPcm;
+    bool m_pcmUpdate;
+    Track m_pcmTrack;
+    bool m_pcmUnusable;
+    std::vector<AudioBuffer> m_pendingPcm;
+    uint64_t m_pendingPcmDuration;
+    AudioBuffer m_pcmBuffer;
+    int m_pcmBufferSize;
+    int m_pcmUpdateThreshold;
+    int m_pcmProcessedCount;
+    QTimer* m_pcmTimeout;
 };
 } // namespace Fooyin::WaveBar
@@ -24,29 +24,27 @@
 constexpr auto SampleCount = 2048;
 
 namespace {
-int buildSample(Fooyin::WaveBar::WaveformSample& sample, Fooyin::WaveBar::WaveformData<float>& data, int channel,
+using ChannelData = Fooyin::WaveBar::WaveformData<float>::ChannelData;
+
+int buildSample(Fooyin::WaveBar::WaveformSample& sample, const std::vector<ChannelData>& data, int channel,
                 double start, double end)
 {
     int sampleCount{0};
 
-    auto& [inMax, inMin, inRms] = data.channelData.at(channel);
+    const auto& [inMax, inMin, inRms] = data.at(channel);
 
-    const int lastIndex = std::floor(end);
+    const int lastIndex = std::min(static_cast<int>(std::floor(end)), static_cast<int>(inMax.size()));
 
-    for(int i = std::floor(start); i < std::ceil(end); ++i) {
-        for(int index{i}; index < lastIndex; ++index) {
-            if(std::cmp_less(index, inMax.size())) {
-                const float sampleMax = inMax.at(index);
-                const float sampleMin = inMin.at(index);
-                const float sampleRms = inRms.at(index);
+    for(int index = std::floor(start); index < lastIndex; ++index) {
+        const float sampleMax = inMax.at(index);
+        const float sampleMin = inMin.at(index);
+        const float sampleRms = inRms.at(index);
 
-                sample.max = std::max(sample.max, sampleMax);
-                sample.min = std::min(sample.min, sampleMin);
-                sample.rms += sampleRms * sampleRms;
+        sample.max = std::max(sample.max, sampleMax);
+        sample.min = std::min(sample.min, sampleMin);
+        sample.rms += sampleRms * sampleRms;
 
-                ++sampleCount;
-            }
-        }
+        ++sampleCount;
     }
 
     return sampleCount;
@@ -71,6 +69,7 @@ void WaveformRescaler::rescale()
 
     WaveformData<float> data{m_data};
     data.channelData.clear();
+    data.levels.clear();
 
     if(m_downMix == DownmixOption::Stereo) {
         data.channels = 2;
@@ -82,7 +81,16 @@ void WaveformRescaler::rescale()
     data.channelData.resize(data.channels);
 
     const double sampleSize = static_cast<double>(m_data.complete ? m_data.sampleCount() : SampleCount) * m_sampleWidth;
-    const auto samplesPerPixel = sampleSize / m_width;
+
+    // Use the coarsest level which still has at least one sample per pixel,
+    // so each pixel only ever aggregates one or two samples.
+    int level{0};
+    while(std::cmp_less(level, m_data.levels.size()) && sampleSize / m_width >= static_cast<double>(2 << level)) {
+        ++level;
+    }
+
+    const auto& source         = level == 0 ? m_data.channelData : m_data.levels.at(level - 1);
+    const auto samplesPerPixel = sampleSize / static_cast<double>(1 << level) / m_width;
 
     for(int ch{0}; ch < data.channels; ++ch) {
         auto& [outMax, outMin, outRms] = data.channelData.at(ch);
@@ -101,11 +109,11 @@ void WaveformRescaler::rescale()
 
             if(m_downMix == DownmixOption::Mono || (m_downMix == DownmixOption::Stereo && m_data.channels > 2)) {
                 for(int mixCh{0}; mixCh < m_data.channels; ++mixCh) {
-                    sampleCount += buildSample(sample, m_data, mixCh, start, end);
+                    sampleCount += buildSample(sample, source, mixCh, start, end);
                 }
             }
             else {
-                sampleCount += buildSample(sample, m_data, ch, start, end);
+                sampleCount += buildSample(sample, source, ch, start, end);
             }
 
             if(sampleCount > 0) {
@@ -19,10 +19,17 @@
 
 #include <utils/fileutils.h>
 
+#include <QCryptographicHash>
 #include <QDesktopServices>
 #include <QDir>
 #include <QFile>
 
+#ifdef Q_OS_UNIX
+#include <sys/stat.h>
+#endif
+
+constexpr auto FingerprintSize = 8192;
+
 namespace Fooyin::Utils::File {
 QString cleanPath(const QString& path)
 {
@@ -207,4 +214,52 @@ QStringList getAllSubdirectories(const QDir& dir)
 
     return directories;
 }
+
+FileId fileId(const QString& filepath)
+{
+#ifdef Q_OS_UNIX
+    struct stat info{};
+    if(::stat(QFile::encodeName(filepath).constData(), &info) == 0) {
+        return {static_cast<uint64_t>(info.st_dev), static_cast<uint64_t>(info.st_ino)};
+    }
+#else
+    Q_UNUSED(filepath)
+#endif
+    return {};
+}
+
+std::pair<int64_t, int64_t> fingerprintBlock(int64_t size)
+{
+    // Sample from the middle of the file, as headers and padding are often identical across files
+    return {std::max<int64_t>(0, (size - FingerprintSize) / 2), std::min<int64_t>(size, FingerprintSize)};
+}
+
+QString fingerprint(int64_t size, const QByteArray& block)
+{
+    if(block.isEmpty()) {
+        return {};
+    }
+
+    QCryptographicHash hash{QCryptographicHash::Md5};
+    hash.addData(QByteArray::number(static_cast<qint64>(size)));
+    hash.addData(block);
+
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+QString fingerprint(const QString& filepath)
+{
+    QFile file{filepath};
+    if(!file.open(QIODevice::ReadOnly)) {
+        return {};
+    }
+
+    const qint64 size           = file.size();
+    const auto [offset, length] = fingerprintBlock(size);
+    if(!file.seek(offset)) {
+        return {};
+    }
+
+    return fingerprint(size, file.read(length));
+}
 } // namespace Fooyin::Utils::File
@@ -40,11 +40,11 @@ void SettingsItem::sortChildren()
 {
     for(SettingsItem* child : m_children) {
         child->sortChildren();
-        child->resetRow();
     }
     std::ranges::sort(m_children, [](const SettingsItem* lhs, const SettingsItem* rhs) {
         return lhs->m_data->name < rhs->m_data->name;
     });
+    updateChildRows();
 }
 
 SettingsModel::SettingsModel(QObject* parent)
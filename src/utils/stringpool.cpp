@@ -0,0 +1,97 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <utils/stringpool.h>
+
+namespace {
+template <typename T>
+T insertOrGet(QSet<T>& set, const T& value)
+{
+    const auto it = set.constFind(value);
+    if(it != set.cend()) {
+        return *it;
+    }
+    return *set.insert(value);
+}
+
+template <typename T>
+void removeUnreferenced(QSet<T>& set)
+{
+    set.removeIf([](const T& value) { return value.isDetached(); });
+}
+} // namespace
+
+namespace Fooyin {
+StringPool& StringPool::shared()
+{
+    static StringPool pool;
+    return pool;
+}
+
+QString StringPool::intern(const QString& str)
+{
+    if(str.isEmpty()) {
+        return {};
+    }
+
+    const std::scoped_lock lock{m_mutex};
+    return insertOrGet(m_strings, str);
+}
+
+QStringList StringPool::intern(const QStringList& list)
+{
+    if(list.isEmpty()) {
+        return {};
+    }
+
+    const std::scoped_lock lock{m_mutex};
+
+    QStringList interned;
+    interned.reserve(list.size());
+
+    for(const QString& str : list) {
+        interned.push_back(str.isEmpty() ? QString{} : insertOrGet(m_strings, str));
+    }
+
+    return insertOrGet(m_lists, interned);
+}
+
+void StringPool::prune()
+{
+    const std::scoped_lock lock{m_mutex};
+
+    // Lists first, as they hold references to pooled strings
+    removeUnreferenced(m_lists);
+    removeUnreferenced(m_strings);
+}
+
+void StringPool::clear()
+{
+    const std::scoped_lock lock{m_mutex};
+
+    m_lists.clear();
+    m_strings.clear();
+}
+
+qsizetype StringPool::size() const
+{
+    const std::scoped_lock lock{m_mutex};
+    return m_strings.size() + m_lists.size();
+}
+} // namespace Fooyin
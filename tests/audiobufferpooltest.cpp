@@ -0,0 +1,198 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "core/engine/ffmpeg/ffmpegdecoder.h"
+#include "testutils.h"
+
+#include <core/engine/audiobuffer.h>
+#include <utils/threadqueue.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+namespace {
+std::atomic<bool> countAllocations{false};
+std::atomic<int> allocations{0};
+
+// Counts allocations made between the construction and destruction of a scope
+class AllocationCounter
+{
+public:
+    AllocationCounter()
+    {
+        allocations.store(0);
+        countAllocations.store(true);
+    }
+
+    ~AllocationCounter()
+    {
+        countAllocations.store(false);
+    }
+
+    AllocationCounter(const AllocationCounter&)            = delete;
+    AllocationCounter& operator=(const AllocationCounter&) = delete;
+
+    [[nodiscard]] int count() const
+    {
+        return allocations.load();
+    }
+};
+} // namespace
+
+void* operator new(std::size_t size)
+{
+    if(countAllocations.load(std::memory_order_relaxed)) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    if(void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t /*size*/) noexcept
+{
+    std::free(ptr);
+}
+
+namespace Fooyin::Testing {
+namespace {
+const AudioFormat Format{SampleFormat::S16, 44100, 2};
+
+// Mirrors the lifetime of buffers during playback: decode, copy to the renderer, detach and release
+void churnBuffers(const std::vector<std::byte>& data)
+{
+    for(int i{0}; i < 100; ++i) {
+        const size_t size = 1024 + (i % 4) * 512;
+
+        AudioBuffer buffer{std::span{data}.first(size), Format, 0};
+        AudioBuffer copy{buffer};
+        copy.detach();
+        copy.append(std::span{data}.first(256));
+
+        AudioBuffer combined{Format, 0};
+        combined.reserve(4096);
+        combined.append(buffer.constData());
+        combined.append(copy.constData());
+    }
+}
+} // namespace
+
+TEST(AudioBufferPoolTest, SteadyStateDoesNotAllocate)
+{
+    const std::vector<std::byte> data(8192, std::byte{1});
+
+    churnBuffers(data);
+
+    const AllocationCounter counter;
+    churnBuffers(data);
+
+    EXPECT_EQ(0, counter.count());
+}
+
+TEST(AudioBufferPoolTest, OversizedStorageIsNotPooled)
+{
+    const std::vector<std::byte> data(2 * 1024 * 1024, std::byte{1});
+
+    {
+        const AudioBuffer buffer{data, Format, 0};
+    }
+
+    const AllocationCounter counter;
+    const AudioBuffer buffer{data, Format, 0};
+
+    EXPECT_EQ(1, counter.count());
+}
+
+TEST(AudioBufferPoolTest, ReservedQueueDoesNotAllocate)
+{
+    const std::vector<std::byte> data(1024, std::byte{1});
+    const AudioBuffer buffer{data, Format, 0};
+
+    ThreadQueue<AudioBuffer> queue{false};
+    queue.reserve(64);
+
+    const AllocationCounter counter;
+    for(int i{0}; i < 1000; ++i) {
+        queue.enqueue(buffer);
+        if(queue.size() == 64) {
+            while(!queue.empty()) {
+                queue.dequeue();
+            }
+        }
+    }
+
+    EXPECT_EQ(0, counter.count());
+}
+
+TEST(AudioBufferPoolTest, DetachCopiesData)
+{
+    const std::vector<std::byte> data(64, std::byte{1});
+
+    const AudioBuffer buffer{data, Format, 0};
+    AudioBuffer copy{buffer};
+    copy.detach();
+    copy.fillSilence();
+
+    EXPECT_EQ(buffer.byteCount(), copy.byteCount());
+    EXPECT_EQ(std::byte{1}, buffer.constData().front());
+    EXPECT_EQ(std::byte{0}, copy.constData().front());
+}
+
+TEST(AudioBufferPoolTest, DecoderSteadyStateDoesNotAllocate)
+{
+    const TempResource file{QStringLiteral(":/audio/audiotest.flac")};
+
+    FFmpegDecoder decoder;
+    ASSERT_TRUE(decoder.init(file.fileName()));
+
+    const auto decodeAll = [&decoder]() {
+        int buffers{0};
+        decoder.start();
+        while(decoder.readBuffer(4096).isValid()) {
+            ++buffers;
+        }
+        decoder.stop();
+        return buffers;
+    };
+
+    // The first pass fills the pool
+    ASSERT_GT(decodeAll(), 0);
+
+    int buffers{0};
+    int count{0};
+    {
+        const AllocationCounter counter;
+        buffers = decodeAll();
+        count   = counter.count();
+    }
+
+    EXPECT_GT(buffers, 0);
+    EXPECT_EQ(0, count);
+}
+} // namespace Fooyin::Testing
@@ -0,0 +1,147 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "core/engine/dsp/crossfadenode.h"
+#include "core/engine/dsp/dspchain.h"
+#include "core/engine/dsp/fadenode.h"
+#include "testutils.h"
+
+#include <core/engine/audiobuffer.h>
+
+#include <QElapsedTimer>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+constexpr int SampleRate = 44100;
+constexpr int Channels   = 2;
+constexpr int BlockSize  = 1024;
+constexpr int Blocks     = 2000;
+} // namespace
+
+namespace Fooyin::Testing {
+class DspBenchmark : public ::testing::TestWithParam<SampleFormat>
+{
+protected:
+    static AudioBuffer makeBlock(const AudioFormat& format)
+    {
+        const std::vector<std::byte> data(static_cast<size_t>(format.bytesForFrames(BlockSize)), std::byte{0x10});
+        return {data, format, 0};
+    }
+};
+
+TEST_P(DspBenchmark, FadeAndCrossfade)
+{
+    const AudioFormat format{GetParam(), SampleRate, Channels};
+
+    FadeNode fade;
+    CrossfadeNode crossfade;
+    DspChain chain;
+    chain.addNode(&crossfade);
+    chain.addNode(&fade);
+    chain.prepare(format, BlockSize);
+
+    AudioBuffer block = makeBlock(format);
+
+    double totalNs{0.0};
+    QElapsedTimer timer;
+
+    for(int i{0}; i < Blocks; ++i) {
+        // Keep both stages active for the whole run
+        if(!fade.isFading()) {
+            (i % 2 == 0) ? fade.fadeOut(BlockSize * 8) : fade.fadeIn(BlockSize * 8);
+        }
+        if(!crossfade.isCrossfading()) {
+            crossfade.start(BlockSize * 8);
+        }
+
+        crossfade.beginBlock();
+        const auto input = crossfade.input(0, BlockSize);
+        ASSERT_EQ(input.size(), static_cast<size_t>(BlockSize * Channels));
+        std::ranges::fill(input, 0.25F);
+
+        timer.start();
+        chain.process(block);
+        totalNs += static_cast<double>(timer.nsecsElapsed());
+    }
+
+    const double blockUs  = totalNs / Blocks / 1000;
+    const double budgetUs = static_cast<double>(BlockSize) / SampleRate * 1000000;
+
+    recordResult("BlockMicroseconds", blockUs);
+    recordResult("PercentOfRealTime", blockUs / budgetUs * 100);
+
+    EXPECT_EQ(block.frameCount(), BlockSize);
+    EXPECT_LT(blockUs, budgetUs);
+}
+
+TEST(DspChainTest, FadeOutEndsSilent)
+{
+    const AudioFormat format{SampleFormat::Float, SampleRate, Channels};
+
+    FadeNode fade;
+    DspChain chain;
+    chain.addNode(&fade);
+    chain.prepare(format, BlockSize);
+
+    EXPECT_FALSE(chain.isActive());
+
+    fade.fadeOut(BlockSize / 2);
+    EXPECT_TRUE(chain.isActive());
+
+    std::vector<float> samples(static_cast<size_t>(BlockSize * Channels), 1.0F);
+    AudioBuffer block{std::as_bytes(std::span{samples}), format, 0};
+    chain.process(block);
+
+    const auto* data = reinterpret_cast<const float*>(block.constData().data());
+    EXPECT_GT(data[0], 0.9F);
+    EXPECT_FLOAT_EQ(data[(BlockSize * Channels) - 1], 0.0F);
+    EXPECT_TRUE(fade.isSilent());
+}
+
+TEST(DspChainTest, CrossfadeReachesNextTrack)
+{
+    const AudioFormat format{SampleFormat::Float, SampleRate, Channels};
+
+    CrossfadeNode crossfade;
+    DspChain chain;
+    chain.addNode(&crossfade);
+    chain.prepare(format, BlockSize);
+
+    crossfade.start(BlockSize);
+
+    std::vector<float> samples(static_cast<size_t>(BlockSize * Channels), 1.0F);
+    AudioBuffer block{std::as_bytes(std::span{samples}), format, 0};
+
+    crossfade.beginBlock();
+    std::ranges::fill(crossfade.input(0, BlockSize), 0.5F);
+    chain.process(block);
+
+    const auto* data = reinterpret_cast<const float*>(block.constData().data());
+    EXPECT_NEAR(data[0], 1.0F, 0.01F);
+    EXPECT_NEAR(data[(BlockSize * Channels) - 1], 0.5F, 0.01F);
+    EXPECT_FALSE(crossfade.isCrossfading());
+}
+
+INSTANTIATE_TEST_SUITE_P(Formats, DspBenchmark,
+                         ::testing::Values(SampleFormat::S16, SampleFormat::S32, SampleFormat::Float));
+} // namespace Fooyin::Testing
@@ -0,0 +1,183 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "testutils.h"
+
+#include <utils/fenwicktree.h>
+
+#include <QElapsedTimer>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+
+// clazy:excludeall=returning-void-expression
+
+namespace {
+constexpr auto RowCount    = 200000;
+constexpr auto HeaderEvery = 12;
+constexpr auto ScrollSteps = 20000;
+constexpr auto ViewHeight  = 900;
+
+// Mimics a playlist grouped by album: a header, a subheader and tracks
+std::vector<int> playlistHeights()
+{
+    std::vector<int> heights(RowCount);
+    for(int i{0}; i < RowCount; ++i) {
+        const int pos = i % HeaderEvery;
+        heights[i]    = pos == 0 ? 64 : pos == 1 ? 30 : 22;
+    }
+    return heights;
+}
+
+int linearUpperBound(const std::vector<int>& heights, int target)
+{
+    int y{0};
+    const int count = static_cast<int>(heights.size());
+    for(int i{0}; i < count; ++i) {
+        y += heights[i];
+        if(y > target) {
+            return i;
+        }
+    }
+    return count;
+}
+} // namespace
+
+namespace Fooyin::Testing {
+TEST(FenwickTreeTest, MatchesLinearSums)
+{
+    std::mt19937 rng{42};
+    std::uniform_int_distribution<int> heightDist{0, 80};
+
+    std::vector<int> heights(1000);
+    std::ranges::generate(heights, [&]() { return heightDist(rng); });
+
+    FenwickTree<int> tree;
+    tree.assign(heights);
+
+    std::uniform_int_distribution<int> indexDist{0, 999};
+    for(int step{0}; step < 500; ++step) {
+        const int index = indexDist(rng);
+        heights[index]  = heightDist(rng);
+        tree.set(index, heights[index]);
+
+        int sum{0};
+        for(int i{0}; i < index; ++i) {
+            sum += heights[i];
+        }
+        EXPECT_EQ(tree.prefixSum(index), sum);
+
+        const int target = std::uniform_int_distribution<int>{-10, tree.total() + 10}(rng);
+        EXPECT_EQ(tree.upperBound(target), linearUpperBound(heights, target));
+    }
+
+    EXPECT_EQ(tree.upperBound(tree.total()), tree.size());
+    EXPECT_EQ(tree.upperBound(-1), 0);
+}
+
+TEST(FenwickTreeTest, InsertMatchesAssign)
+{
+    std::mt19937 rng{11};
+    std::uniform_int_distribution<int> heightDist{0, 80};
+
+    std::vector<int> heights(300);
+    std::ranges::generate(heights, [&]() { return heightDist(rng); });
+
+    FenwickTree<int> tree;
+    tree.assign(heights);
+
+    for(int step{0}; step < 50; ++step) {
+        const int index = std::uniform_int_distribution<int>{0, static_cast<int>(heights.size())}(rng);
+        const int count = std::uniform_int_distribution<int>{1, 20}(rng);
+        const int value = heightDist(rng);
+
+        heights.insert(heights.begin() + index, count, value);
+        tree.insert(index, count, value);
+
+        FenwickTree<int> expected;
+        expected.assign(heights);
+
+        ASSERT_EQ(tree.size(), expected.size());
+        for(int i{0}; i <= tree.size(); ++i) {
+            EXPECT_EQ(tree.prefixSum(i), expected.prefixSum(i));
+        }
+    }
+}
+
+TEST(FenwickTreeTest, EmptyTree)
+{
+    FenwickTree<int> tree;
+    EXPECT_EQ(tree.total(), 0);
+    EXPECT_EQ(tree.upperBound(0), 0);
+
+    tree.assign({});
+    EXPECT_TRUE(tree.empty());
+}
+
+TEST(FenwickTreeTest, ScrollLargePlaylist)
+{
+    const std::vector<int> heights = playlistHeights();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    FenwickTree<int> tree;
+    tree.assign(heights);
+
+    const auto buildTime = timer.nsecsElapsed();
+    timer.restart();
+
+    const int maxScroll = tree.total() - ViewHeight;
+    std::mt19937 rng{7};
+    std::uniform_int_distribution<int> rowDist{0, RowCount - 1};
+
+    int value{0};
+    long long checksum{0};
+
+    for(int step{0}; step < ScrollSteps; ++step) {
+        // Alternate between wheel steps and large jumps (dragging the scrollbar)
+        value = step % 10 == 0 ? std::uniform_int_distribution<int>{0, maxScroll}(rng)
+                               : std::min(value + 66, maxScroll);
+
+        const int first  = tree.upperBound(value);
+        const int offset = tree.prefixSum(first) - value;
+        const int last   = std::min(tree.upperBound(value + ViewHeight), RowCount - 1);
+        const int hover  = tree.upperBound(value + ViewHeight / 2);
+
+        checksum += first + last + hover + offset;
+
+        // Row heights change as rows are re-measured after a resize or data change
+        if(step % 4 == 0) {
+            const int row = rowDist(rng);
+            tree.set(row, tree.value(row) == 22 ? 44 : 22);
+        }
+    }
+
+    const auto scrollTime = timer.nsecsElapsed();
+
+    EXPECT_GT(checksum, 0);
+    EXPECT_EQ(tree.upperBound(0), 0);
+
+    recordResult("BuildMs", static_cast<double>(buildTime) / 1e6);
+    recordResult("ScrollMs", static_cast<double>(scrollTime) / 1e6);
+    recordResult("NsPerStep", static_cast<double>(scrollTime) / ScrollSteps);
+}
+} // namespace Fooyin::Testing
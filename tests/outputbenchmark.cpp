@@ -0,0 +1,294 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "core/engine/audiorenderer.h"
+#include "core/engine/ffmpeg/ffmpegdecoder.h"
+#include "plugins/headless/fileoutput.h"
+#include "plugins/headless/nulloutput.h"
+#include "testutils.h"
+
+#include <core/engine/audiobuffer.h>
+#include <core/engine/enginemetrics.h>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QtEndian>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <span>
+#include <thread>
+#include <vector>
+
+// clazy:excludeall=returning-void-expression
+
+using namespace std::chrono_literals;
+
+namespace {
+// Limit real-time runs so the benchmark stays quick
+constexpr uint64_t RealTimeLimitMs = 500;
+// How far the decoder keeps ahead of the renderer
+constexpr uint64_t DecodeAheadMs = 1000;
+
+struct RunStats
+{
+    uint64_t frames{0};
+    uint64_t durationMs{0};
+    double decodeMs{0.0};
+    double wallMs{0.0};
+    int underruns{0};
+    uint64_t queueUnderruns{0};
+    double totalLatencyMs{0.0};
+    double maxLatencyMs{0.0};
+    int buffers{0};
+};
+} // namespace
+
+namespace Fooyin::Testing {
+class OutputBenchmark : public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        // The renderer is driven by a timer, so needs an event loop
+        static int argc{1};
+        static char name[] = "test_output_benchmark";
+        static char* argv[]{name};
+        s_app = std::make_unique<QCoreApplication>(argc, argv);
+    }
+
+    static void TearDownTestSuite()
+    {
+        s_app.reset();
+    }
+
+    void SetUp() override
+    {
+        ASSERT_TRUE(m_dir.isValid());
+        ASSERT_FALSE(m_dir.files().empty());
+    }
+
+    /*!
+     * Plays @p file through an AudioRenderer writing to @p output, keeping the decoder ahead
+     * of the renderer the same way the engine does. Latency is measured from a buffer leaving
+     * the decoder to it being written to the output, plus the delay the output reports.
+     * @p finished is called once the output has played everything, before it's closed.
+     */
+    static void play(const QString& file, std::unique_ptr<AudioOutput> output, uint64_t limitMs, RunStats& stats,
+                     const std::function<void()>& finished = {})
+    {
+        FFmpegDecoder decoder;
+        ASSERT_TRUE(decoder.init(file));
+        decoder.start();
+
+        const AudioFormat format = decoder.format();
+        const auto decodeAhead   = static_cast<uint64_t>(format.framesForDuration(DecodeAheadMs));
+        AudioOutput* sink        = output.get();
+
+        EngineMetrics metrics;
+        AudioRenderer renderer{&metrics};
+        renderer.updateOutput([&output]() { return std::move(output); });
+        ASSERT_TRUE(renderer.init(format));
+
+        std::deque<std::chrono::steady_clock::time_point> decodedAt;
+        uint64_t framesProcessed{0};
+        bool ended{false};
+
+        QObject::connect(&renderer, &AudioRenderer::bufferProcessed, [&](const AudioBuffer& buffer) {
+            if(decodedAt.empty()) {
+                return;
+            }
+
+            const std::chrono::duration<double, std::milli> queuedFor{std::chrono::steady_clock::now()
+                                                                      - decodedAt.front()};
+            decodedAt.pop_front();
+
+            const double latency = queuedFor.count() + (sink->currentState().delay * 1000);
+            stats.totalLatencyMs += latency;
+            stats.maxLatencyMs = std::max(stats.maxLatencyMs, latency);
+            framesProcessed += static_cast<uint64_t>(buffer.frameCount());
+            ++stats.buffers;
+        });
+        QObject::connect(&renderer, &AudioRenderer::finished, [&ended]() { ended = true; });
+
+        QElapsedTimer wallTimer;
+        QElapsedTimer decodeTimer;
+        wallTimer.start();
+        renderer.start();
+
+        bool decoding{true};
+
+        while(!ended) {
+            while(decoding && stats.frames - framesProcessed < decodeAhead) {
+                decodeTimer.start();
+                const AudioBuffer buffer = limitMs > 0 && stats.durationMs >= limitMs ? AudioBuffer{}
+                                                                                       : decoder.readBuffer();
+                stats.decodeMs += static_cast<double>(decodeTimer.nsecsElapsed()) / 1000000;
+
+                if(!buffer.isValid()) {
+                    // End of track marker
+                    renderer.queueBuffer({});
+                    decoding = false;
+                    break;
+                }
+
+                decodedAt.push_back(std::chrono::steady_clock::now());
+                renderer.queueBuffer(buffer);
+                stats.frames += static_cast<uint64_t>(buffer.frameCount());
+                stats.durationMs = format.durationForFrames(static_cast<int>(stats.frames));
+            }
+
+            QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents);
+        }
+
+        // Let the output play what it still holds
+        while(sink->currentState().queuedSamples > 0) {
+            std::this_thread::sleep_for(1ms);
+        }
+
+        stats.underruns      = sink->currentState().underruns;
+        stats.queueUnderruns = metrics.queueUnderruns.load();
+        stats.wallMs         = static_cast<double>(std::max<qint64>(1, wallTimer.nsecsElapsed())) / 1000000;
+
+        if(finished) {
+            finished();
+        }
+
+        renderer.stop();
+        renderer.closeOutput();
+        decoder.stop();
+    }
+
+    // Properties are keyed by file type, as each test plays every file
+    static void report(const QString& file, const RunStats& stats)
+    {
+        const auto format  = QFileInfo{file}.suffix().toStdString();
+        const auto audioMs = static_cast<double>(stats.durationMs);
+
+        recordResult(format + "Speed", audioMs / stats.wallMs);
+        recordResult(format + "DecodeFramesPerSecond",
+                     static_cast<double>(stats.frames) / std::max(stats.decodeMs, 0.001) * 1000);
+        recordResult(format + "Underruns", stats.underruns);
+        recordResult(format + "QueueUnderruns", static_cast<double>(stats.queueUnderruns));
+        recordResult(format + "AvgLatencyMs", stats.totalLatencyMs / std::max(stats.buffers, 1));
+        recordResult(format + "MaxLatencyMs", stats.maxLatencyMs);
+    }
+
+    static inline std::unique_ptr<QCoreApplication> s_app;
+    TempResourceDir m_dir;
+};
+
+TEST_F(OutputBenchmark, NullFast)
+{
+    for(const QString& file : m_dir.files()) {
+        auto output = std::make_unique<Headless::NullOutput>(Headless::NullOutput::Clock::Fast);
+        auto* sink  = output.get();
+        RunStats stats;
+        play(file, std::move(output), 0, stats, [sink, &stats]() {
+            EXPECT_EQ(sink->framesConsumed(), stats.frames);
+            EXPECT_EQ(stats.underruns, 0);
+        });
+
+        EXPECT_GT(stats.frames, 0U);
+        report(file, stats);
+    }
+}
+
+TEST_F(OutputBenchmark, NullRealTime)
+{
+    for(const QString& file : m_dir.files()) {
+        auto output = std::make_unique<Headless::NullOutput>(Headless::NullOutput::Clock::RealTime);
+        auto* sink  = output.get();
+        RunStats stats;
+        play(file, std::move(output), RealTimeLimitMs, stats,
+             // Includes the silence played while the output drained
+             [sink, &stats]() { EXPECT_GE(sink->framesConsumed(), stats.frames); });
+
+        EXPECT_GT(stats.frames, 0U);
+        report(file, stats);
+    }
+}
+
+TEST_F(OutputBenchmark, FileWav)
+{
+    for(const QString& file : m_dir.files()) {
+        const QString path = m_dir.filePath(QFileInfo{file}.completeBaseName() + QStringLiteral("-out.wav"));
+
+        auto output = std::make_unique<Headless::FileOutput>();
+        output->setDevice(path);
+        auto* sink = output.get();
+        qint64 bytesWritten{0};
+        RunStats stats;
+        play(file, std::move(output), 0, stats, [sink, &bytesWritten]() { bytesWritten = sink->bytesWritten(); });
+
+        QFile written{path};
+        ASSERT_TRUE(written.open(QIODevice::ReadOnly));
+        const QByteArray header = written.read(44);
+        ASSERT_EQ(header.size(), 44);
+
+        EXPECT_EQ(header.left(4), "RIFF");
+        EXPECT_EQ(header.mid(8, 4), "WAVE");
+        EXPECT_EQ(header.mid(36, 4), "data");
+        EXPECT_EQ(static_cast<qint64>(qFromLittleEndian<uint32_t>(header.constData() + 40)), bytesWritten);
+        EXPECT_EQ(written.size(), bytesWritten + 44);
+        report(file, stats);
+    }
+}
+
+TEST(FileOutputTest, S24RoundTrip)
+{
+    const QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString path = dir.filePath(QStringLiteral("s24.wav"));
+
+    // MSB-aligned 24bit samples, so the low byte is padding
+    const std::vector<int32_t> samples{0, 0x7FFFFF00, std::numeric_limits<int32_t>::min(), 0x12345600, -0x100, 0x100};
+    const AudioFormat format{SampleFormat::S24, 44100, 2};
+
+    Headless::FileOutput output;
+    output.setDevice(path);
+    ASSERT_TRUE(output.init(format));
+    const AudioBuffer buffer{std::as_bytes(std::span{samples}), format, 0};
+    EXPECT_EQ(output.write(buffer), static_cast<int>(samples.size()) / 2);
+    output.uninit();
+
+    QFile written{path};
+    ASSERT_TRUE(written.open(QIODevice::ReadOnly));
+    const QByteArray header = written.read(44);
+    ASSERT_EQ(header.size(), 44);
+    EXPECT_EQ(qFromLittleEndian<uint16_t>(header.constData() + 34), 24);
+
+    const QByteArray data = written.readAll();
+    ASSERT_EQ(data.size(), static_cast<qsizetype>(samples.size() * 3));
+
+    for(size_t i{0}; i < samples.size(); ++i) {
+        const auto* bytes = reinterpret_cast<const uint8_t*>(data.constData() + (i * 3));
+        const auto sample = static_cast<int32_t>((static_cast<uint32_t>(bytes[0]) << 8)
+                                                 | (static_cast<uint32_t>(bytes[1]) << 16)
+                                                 | (static_cast<uint32_t>(bytes[2]) << 24));
+        EXPECT_EQ(sample, samples.at(i));
+    }
+}
+} // namespace Fooyin::Testing
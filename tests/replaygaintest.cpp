@@ -0,0 +1,181 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "core/engine/replaygain/loudnessmeter.h"
+#include "testutils.h"
+
+#include <core/engine/replaygain.h>
+#include <core/engine/replaygainscanner.h>
+#include <core/track.h>
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QThread>
+#include <QThreadPool>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <numbers>
+#include <vector>
+
+namespace {
+constexpr int SampleRate = 48000;
+
+std::vector<float> sine(double frequency, double dbfs, int channels, int seconds)
+{
+    const double amplitude = std::pow(10.0, dbfs / 20);
+    const int frames       = SampleRate * seconds;
+
+    std::vector<float> samples(static_cast<size_t>(frames) * channels);
+    for(int frame{0}; frame < frames; ++frame) {
+        const auto value
+            = static_cast<float>(amplitude * std::sin(2 * std::numbers::pi * frequency * frame / SampleRate));
+        for(int ch{0}; ch < channels; ++ch) {
+            samples[(static_cast<size_t>(frame) * channels) + ch] = value;
+        }
+    }
+    return samples;
+}
+} // namespace
+
+namespace Fooyin::Testing {
+TEST(LoudnessMeterTest, StereoSine)
+{
+    // EBU Tech 3341: a 1kHz stereo sine at -23dBFS measures -23 LUFS
+    const auto samples = sine(1000, -23, 2, 20);
+
+    LoudnessMeter meter{SampleRate, 2};
+    meter.process(samples.data(), static_cast<int>(samples.size() / 2));
+
+    const auto loudness = meter.integratedLoudness();
+    ASSERT_TRUE(loudness.has_value());
+    EXPECT_NEAR(*loudness, -23.0, 0.1);
+    EXPECT_NEAR(meter.peak(), std::pow(10.0, -23.0 / 20), 0.001);
+}
+
+TEST(LoudnessMeterTest, SilenceIsGated)
+{
+    const std::vector<float> samples(static_cast<size_t>(SampleRate) * 2 * 5, 0.0F);
+
+    LoudnessMeter meter{SampleRate, 2};
+    meter.process(samples.data(), SampleRate * 5);
+
+    EXPECT_FALSE(meter.integratedLoudness().has_value());
+    EXPECT_FLOAT_EQ(meter.peak(), 0.0F);
+}
+
+TEST(LoudnessMeterTest, AlbumCombinesBlocks)
+{
+    const auto quiet = sine(1000, -30, 2, 10);
+    const auto loud  = sine(1000, -20, 2, 10);
+
+    LoudnessMeter quietMeter{SampleRate, 2};
+    quietMeter.process(quiet.data(), static_cast<int>(quiet.size() / 2));
+    LoudnessMeter loudMeter{SampleRate, 2};
+    loudMeter.process(loud.data(), static_cast<int>(loud.size() / 2));
+
+    std::vector<double> blocks{quietMeter.blocks()};
+    blocks.insert(blocks.end(), loudMeter.blocks().cbegin(), loudMeter.blocks().cend());
+
+    // The quiet track is within the relative gate, so the album lies between both tracks
+    const auto album = LoudnessMeter::integratedLoudness(blocks);
+    ASSERT_TRUE(album.has_value());
+    EXPECT_GT(*album, *quietMeter.integratedLoudness());
+    EXPECT_LT(*album, *loudMeter.integratedLoudness());
+}
+
+TEST(ReplayGainTest, PlaybackGain)
+{
+    Track track;
+    EXPECT_FLOAT_EQ(ReplayGain::playbackGain(track, ReplayGain::Mode::Track, 0.0, true), 1.0F);
+
+    track.addExtraTag(QString::fromLatin1(ReplayGain::TrackGainTag), QStringLiteral("-6.00 dB"));
+    track.addExtraTag(QString::fromLatin1(ReplayGain::TrackPeakTag), QStringLiteral("0.5"));
+
+    EXPECT_NEAR(ReplayGain::playbackGain(track, ReplayGain::Mode::Track, 0.0, true), 0.501, 0.001);
+    // Falls back to track gain
+    EXPECT_NEAR(ReplayGain::playbackGain(track, ReplayGain::Mode::Album, 0.0, true), 0.501, 0.001);
+    EXPECT_FLOAT_EQ(ReplayGain::playbackGain(track, ReplayGain::Mode::None, 0.0, true), 1.0F);
+
+    // +6dB keeps the 0.5 peak just under full scale, but +12dB would take it over
+    EXPECT_NEAR(ReplayGain::playbackGain(track, ReplayGain::Mode::Track, 12.0, true), 1.995, 0.001);
+    EXPECT_NEAR(ReplayGain::playbackGain(track, ReplayGain::Mode::Track, 18.0, true), 2.0, 0.001);
+    EXPECT_NEAR(ReplayGain::playbackGain(track, ReplayGain::Mode::Track, 18.0, false), 3.981, 0.001);
+}
+
+class ReplayGainScannerTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        ASSERT_TRUE(m_dir.isValid());
+
+        const QDir resources{QStringLiteral(":/audio")};
+        for(const QString& file : resources.entryList(QDir::Files)) {
+            const QString path = m_dir.filePath(file);
+            ASSERT_TRUE(QFile::copy(resources.filePath(file), path));
+            QFile::setPermissions(path, QFile::ReadOwner | QFile::WriteOwner);
+            m_tracks.emplace_back(path);
+        }
+
+        ASSERT_FALSE(m_tracks.empty());
+    }
+
+    QTemporaryDir m_dir;
+    TrackList m_tracks;
+};
+
+TEST_F(ReplayGainScannerTest, ScalesWithThreads)
+{
+    // Repeat the test files so there is enough work to spread across threads
+    TrackList tracks;
+    for(int i{0}; i < 8; ++i) {
+        tracks.insert(tracks.end(), m_tracks.cbegin(), m_tracks.cend());
+    }
+
+    const auto run = [&tracks](int threads, TrackList& scanned) {
+        QThreadPool pool;
+        pool.setMaxThreadCount(threads);
+
+        QElapsedTimer timer;
+        timer.start();
+        scanned = ReplayGainScanner::scanBlocking(tracks, &pool);
+        const auto elapsed = static_cast<double>(std::max<qint64>(1, timer.elapsed()));
+
+        const std::string key = threads == 1 ? "SingleThread" : "Parallel";
+        recordResult(key + "Ms", elapsed);
+        recordResult(key + "TracksPerSecond", static_cast<double>(tracks.size()) / elapsed * 1000);
+    };
+
+    TrackList single;
+    TrackList parallel;
+    run(1, single);
+    run(QThread::idealThreadCount(), parallel);
+
+    ASSERT_EQ(single.size(), parallel.size());
+    for(size_t i{0}; i < single.size(); ++i) {
+        const auto gain = QString::fromLatin1(ReplayGain::TrackGainTag);
+        EXPECT_FALSE(single.at(i).extraTag(gain).empty());
+        EXPECT_EQ(single.at(i).extraTag(gain), parallel.at(i).extraTag(gain));
+    }
+}
+} // namespace Fooyin::Testing
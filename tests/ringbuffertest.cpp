@@ -0,0 +1,107 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <utils/ringbuffer.h>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+// clazy:excludeall=returning-void-expression
+
+namespace {
+std::vector<std::byte> sequence(size_t size, int start = 0)
+{
+    std::vector<std::byte> bytes(size);
+    for(size_t i{0}; i < size; ++i) {
+        bytes[i] = static_cast<std::byte>((start + i) % 256);
+    }
+    return bytes;
+}
+} // namespace
+
+namespace Fooyin::Testing {
+TEST(RingBufferTest, WrapsAround)
+{
+    RingBuffer buffer{8};
+
+    const auto input = sequence(6);
+    std::vector<std::byte> output(6);
+
+    EXPECT_EQ(buffer.write(input.data(), 6), 6);
+    EXPECT_EQ(buffer.read(output.data(), 4), 4);
+    EXPECT_EQ(buffer.readAvailable(), 2);
+    EXPECT_EQ(buffer.writeAvailable(), 6);
+
+    // Crosses the end of the storage
+    EXPECT_EQ(buffer.write(input.data(), 6), 6);
+    EXPECT_EQ(buffer.write(input.data(), 6), 0);
+
+    EXPECT_EQ(buffer.read(output.data(), 2), 2);
+    EXPECT_EQ(output[0], input[4]);
+    EXPECT_EQ(output[1], input[5]);
+
+    EXPECT_EQ(buffer.read(output.data(), 6), 6);
+    EXPECT_EQ(output, input);
+    EXPECT_EQ(buffer.readAvailable(), 0);
+}
+
+TEST(RingBufferTest, ClearDropsWrittenData)
+{
+    RingBuffer buffer{16};
+
+    const auto input = sequence(10);
+    buffer.write(input.data(), 10);
+    buffer.clear();
+
+    EXPECT_EQ(buffer.readAvailable(), 0);
+
+    const auto next = sequence(4, 100);
+    buffer.write(next.data(), 4);
+
+    std::vector<std::byte> output(4);
+    EXPECT_EQ(buffer.read(output.data(), 16), 4);
+    EXPECT_EQ(output, next);
+}
+
+TEST(RingBufferTest, ProducerConsumer)
+{
+    static constexpr size_t Total = 4 * 1024 * 1024;
+
+    RingBuffer buffer{4096};
+    const auto input = sequence(Total);
+
+    std::thread producer{[&]() {
+        size_t written{0};
+        while(written < Total) {
+            written += buffer.write(input.data() + written, std::min<size_t>(Total - written, 1000));
+        }
+    }};
+
+    std::vector<std::byte> output(Total);
+    size_t read{0};
+    while(read < Total) {
+        read += buffer.read(output.data() + read, 777);
+    }
+
+    producer.join();
+
+    EXPECT_EQ(output, input);
+}
+} // namespace Fooyin::Testing
@@ -0,0 +1,172 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <core/track.h>
+#include <utils/stringpool.h>
+
+#include <QFile>
+
+#include <gtest/gtest.h>
+
+namespace {
+constexpr int TrackCount  = 100000;
+constexpr int ArtistCount = 500;
+
+// Resident set size in KiB (assuming 4 KiB pages), or -1 if unavailable
+long residentMemory()
+{
+    QFile statm{QStringLiteral("/proc/self/statm")};
+    if(!statm.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+    const QList<QByteArray> fields = statm.readAll().split(' ');
+    if(fields.size() < 2) {
+        return -1;
+    }
+    return fields.at(1).toLong() * 4;
+}
+
+// Strings are rebuilt from raw bytes for every track, as they are when read from the database
+Fooyin::TrackList makeTracks(bool intern)
+{
+    Fooyin::StringPool& pool = Fooyin::StringPool::shared();
+
+    Fooyin::TrackList tracks;
+    tracks.reserve(TrackCount);
+
+    for(int i{0}; i < TrackCount; ++i) {
+        const QByteArray artist = "Some Fairly Long Artist Name " + QByteArray::number(i % ArtistCount);
+        const QByteArray album  = artist + " - Album Title";
+
+        QStringList artists{QString::fromUtf8(artist)};
+        QString albumName = QString::fromUtf8(album);
+        QStringList genres{QString::fromUtf8("Progressive Rock"), QString::fromUtf8("Art Rock")};
+
+        if(intern) {
+            artists   = pool.intern(artists);
+            albumName = pool.intern(albumName);
+            genres    = pool.intern(genres);
+        }
+
+        Fooyin::Track track;
+        track.setArtists(artists);
+        track.setAlbumArtists(artists);
+        track.setAlbum(albumName);
+        track.setGenres(genres);
+        tracks.push_back(track);
+    }
+
+    return tracks;
+}
+} // namespace
+
+namespace Fooyin::Testing {
+class StringPoolTest : public ::testing::Test
+{
+protected:
+    StringPool m_pool;
+};
+
+TEST_F(StringPoolTest, InternSharesStorage)
+{
+    const QString first  = m_pool.intern(QString::fromUtf8("Radiohead"));
+    const QString second = m_pool.intern(QString::fromUtf8("Radiohead"));
+
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(first.constData(), second.constData());
+    EXPECT_EQ(1, m_pool.size());
+
+    EXPECT_TRUE(m_pool.intern(QString{}).isNull());
+    EXPECT_EQ(1, m_pool.size());
+}
+
+TEST_F(StringPoolTest, InternList)
+{
+    const QStringList first  = m_pool.intern(QStringList{QString::fromUtf8("Pop"), QString::fromUtf8("Rock")});
+    const QStringList second = m_pool.intern(QStringList{QString::fromUtf8("Pop"), QString::fromUtf8("Rock")});
+    const QString rock       = m_pool.intern(QString::fromUtf8("Rock"));
+
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(first.constData(), second.constData());
+    EXPECT_EQ(rock.constData(), first.at(1).constData());
+}
+
+TEST_F(StringPoolTest, Prune)
+{
+    QString kept = m_pool.intern(QString::fromUtf8("Kept"));
+    m_pool.intern(QString::fromUtf8("Dropped"));
+    m_pool.intern(QStringList{QString::fromUtf8("Dropped"), QString::fromUtf8("List")});
+
+    m_pool.prune();
+
+    EXPECT_EQ(1, m_pool.size());
+    EXPECT_EQ(kept.constData(), m_pool.intern(QString::fromUtf8("Kept")).constData());
+}
+
+TEST_F(StringPoolTest, PruneReleasedTracks)
+{
+    TrackList tracks;
+    for(const char* album : {"First", "Second", "Third"}) {
+        Track track;
+        track.setAlbum(m_pool.intern(QString::fromUtf8(album)));
+        track.setGenres(m_pool.intern(QStringList{QString::fromUtf8(album) + QStringLiteral(" Genre")}));
+        tracks.push_back(track);
+    }
+    ASSERT_EQ(9, m_pool.size());
+
+    // Tag edit replaces the values of the first track, library removal drops the last
+    tracks.front().setAlbum(m_pool.intern(QString::fromUtf8("Edited")));
+    tracks.front().setGenres({});
+    tracks.pop_back();
+
+    m_pool.prune();
+
+    EXPECT_EQ(4, m_pool.size());
+    EXPECT_EQ(tracks.front().album().constData(), m_pool.intern(QString::fromUtf8("Edited")).constData());
+    EXPECT_EQ(tracks.back().genres().constData(),
+              m_pool.intern(QStringList{QString::fromUtf8("Second Genre")}).constData());
+}
+
+TEST(StringPoolMemoryTest, ResidentMemory)
+{
+    if(residentMemory() < 0) {
+        GTEST_SKIP() << "Resident memory is not available on this platform";
+    }
+
+    StringPool::shared().clear();
+
+    // Both sets are kept alive so freed memory from one run can't hide the cost of the other
+    const long start          = residentMemory();
+    const TrackList plain     = makeTracks(false);
+    const long afterPlain     = residentMemory();
+    const TrackList interned  = makeTracks(true);
+    const long afterInterned  = residentMemory();
+    const long plainMemory    = afterPlain - start;
+    const long internedMemory = afterInterned - afterPlain;
+
+    ASSERT_EQ(plain.size(), interned.size());
+
+    RecordProperty("PlainKiB", static_cast<int>(plainMemory));
+    RecordProperty("InternedKiB", static_cast<int>(internedMemory));
+
+    EXPECT_LT(internedMemory, plainMemory);
+
+    StringPool::shared().clear();
+}
+} // namespace Fooyin::Testing
@@ -0,0 +1,83 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "core/tagging/tagreader.h"
+#include "testutils.h"
+
+#include <core/track.h>
+
+#include <QElapsedTimer>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+// clazy:excludeall=returning-void-expression
+
+namespace {
+constexpr auto Iterations = 200;
+} // namespace
+
+namespace Fooyin::Testing {
+class TagReaderBenchmark : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        ASSERT_TRUE(m_dir.isValid());
+        ASSERT_FALSE(m_dir.files().empty());
+    }
+
+    void runBenchmark(Tagging::Quality quality)
+    {
+        QElapsedTimer timer;
+        timer.start();
+
+        for(int i{0}; i < Iterations; ++i) {
+            for(const QString& file : m_dir.files()) {
+                Track track{file};
+                ASSERT_TRUE(Tagging::readMetaData(track, quality));
+                ASSERT_NE(track.type(), Track::Type::Unknown);
+            }
+        }
+
+        const auto elapsed    = static_cast<double>(std::max<qint64>(1, timer.elapsed()));
+        const auto totalReads = static_cast<double>(Iterations * m_dir.files().size());
+
+        recordResult("TracksPerSecond", totalReads / elapsed * 1000);
+    }
+
+    TempResourceDir m_dir;
+};
+
+TEST_F(TagReaderBenchmark, ReadFast)
+{
+    runBenchmark(Tagging::Quality::Fast);
+}
+
+TEST_F(TagReaderBenchmark, ReadAverage)
+{
+    runBenchmark(Tagging::Quality::Average);
+}
+
+TEST_F(TagReaderBenchmark, ReadAccurate)
+{
+    runBenchmark(Tagging::Quality::Accurate);
+}
+} // namespace Fooyin::Testing
@@ -21,6 +21,8 @@
 
 #include <QDir>
 
+#include <gtest/gtest.h>
+
 namespace Fooyin::Testing {
 TempResource::TempResource(const QString& filename, QObject* parent)
     : QTemporaryFile{parent}
@@ -35,4 +37,30 @@ TempResource::TempResource(const QString& filename, QObject* parent)
 
     reset();
 }
+
+TempResourceDir::TempResourceDir()
+{
+    if(!isValid()) {
+        return;
+    }
+
+    const QDir resources{QStringLiteral(":/audio")};
+    for(const QString& file : resources.entryList(QDir::Files)) {
+        const QString path = filePath(file);
+        if(QFile::copy(resources.filePath(file), path)) {
+            QFile::setPermissions(path, QFile::ReadOwner | QFile::WriteOwner);
+            m_files.emplace_back(path);
+        }
+    }
+}
+
+const QStringList& TempResourceDir::files() const
+{
+    return m_files;
+}
+
+void recordResult(const std::string& key, double value)
+{
+    ::testing::Test::RecordProperty(key, QString::number(value, 'f', 2).toStdString());
+}
 } // namespace Fooyin::Testing
@@ -19,12 +19,33 @@
 
 #pragma once
 
+#include <QStringList>
+#include <QTemporaryDir>
 #include <QTemporaryFile>
 
+#include <string>
+
 namespace Fooyin::Testing {
 class TempResource : public QTemporaryFile
 {
 public:
     explicit TempResource(const QString& filename, QObject* parent = nullptr);
 };
+
+/*!
+ * A temporary directory holding a writable copy of each of the test audio files.
+ */
+class TempResourceDir : public QTemporaryDir
+{
+public:
+    TempResourceDir();
+
+    [[nodiscard]] const QStringList& files() const;
+
+private:
+    QStringList m_files;
+};
+
+/** Records a benchmark result as a property of the current test, so it's reported in the test's XML output. */
+void recordResult(const std::string& key, double value);
 } // namespace Fooyin::Testing
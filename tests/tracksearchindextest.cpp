@@ -0,0 +1,207 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "testutils.h"
+
+#include <core/library/trackfilter.h>
+#include <core/library/tracksearchindex.h>
+#include <core/track.h>
+
+#include <QElapsedTimer>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+// clazy:excludeall=returning-void-expression
+
+namespace {
+Fooyin::Track makeTrack(int id, const QString& title, const QString& artist, const QString& album)
+{
+    Fooyin::Track track{QStringLiteral("/music/%1/%2.flac").arg(album, title)};
+    track.setId(id);
+    track.setTitle(title);
+    track.setArtists({artist});
+    track.setAlbumArtists({artist});
+    track.setAlbum(album);
+    return track;
+}
+
+Fooyin::TrackIds ids(const Fooyin::TrackList& tracks)
+{
+    Fooyin::TrackIds trackIds;
+    for(const auto& track : tracks) {
+        trackIds.push_back(track.id());
+    }
+    return trackIds;
+}
+
+Fooyin::TrackIds sortedIds(const Fooyin::TrackList& tracks)
+{
+    Fooyin::TrackIds trackIds = ids(tracks);
+    std::ranges::sort(trackIds);
+    return trackIds;
+}
+} // namespace
+
+namespace Fooyin::Testing {
+class TrackSearchIndexTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_tracks = {makeTrack(1, QStringLiteral("Paranoid Android"), QStringLiteral("Radiohead"),
+                              QStringLiteral("OK Computer")),
+                    makeTrack(2, QStringLiteral("Karma Police"), QStringLiteral("Radiohead"),
+                              QStringLiteral("OK Computer")),
+                    makeTrack(3, QStringLiteral("Teardrop"), QStringLiteral("Massive Attack"),
+                              QStringLiteral("Mezzanine")),
+                    makeTrack(4, QStringLiteral("Ärger"), QStringLiteral("Die Ärzte"), QStringLiteral("Geräusch"))};
+
+        m_index.build(m_tracks);
+        m_index.waitForUpdates();
+    }
+
+    TrackList m_tracks;
+    TrackSearchIndex m_index;
+};
+
+TEST_F(TrackSearchIndexTest, ShortSearchFallsBack)
+{
+    EXPECT_FALSE(m_index.candidates(QStringLiteral("ok")).has_value());
+    EXPECT_EQ(ids(Filter::filterTracks(m_tracks, QStringLiteral("ok"), m_index)), (TrackIds{1, 2}));
+}
+
+TEST_F(TrackSearchIndexTest, Candidates)
+{
+    EXPECT_EQ(m_index.candidates(QStringLiteral("radio")), (TrackIds{1, 2}));
+    EXPECT_EQ(m_index.candidates(QStringLiteral("MEZZ")), (TrackIds{3}));
+    EXPECT_EQ(m_index.candidates(QStringLiteral("ärz")), (TrackIds{4}));
+    EXPECT_EQ(m_index.candidates(QStringLiteral("xyz")), TrackIds{});
+}
+
+TEST_F(TrackSearchIndexTest, MatchesLinearFilter)
+{
+    const QStringList searches{QStringLiteral("radiohead"), QStringLiteral("police"), QStringLiteral("computer"),
+                               QStringLiteral("tear"),      QStringLiteral("flac"),   QStringLiteral("Ärger"),
+                               QStringLiteral("d a"),       QStringLiteral("zzz")};
+
+    for(const QString& search : searches) {
+        EXPECT_EQ(ids(Filter::filterTracks(m_tracks, search, m_index)), ids(Filter::filterTracks(m_tracks, search)))
+            << search.toStdString();
+    }
+}
+
+TEST_F(TrackSearchIndexTest, IncrementalUpdates)
+{
+    Track track = m_tracks.at(2);
+    track.setAlbum(QStringLiteral("Protection"));
+    m_index.updateTracks({track});
+    m_index.addTracks({makeTrack(5, QStringLiteral("Airbag"), QStringLiteral("Radiohead"),
+                                 QStringLiteral("OK Computer"))});
+    m_index.removeTracks({m_tracks.at(0)});
+    m_index.waitForUpdates();
+
+    EXPECT_EQ(m_index.candidates(QStringLiteral("mezzanine")), TrackIds{});
+    EXPECT_EQ(m_index.candidates(QStringLiteral("protection")), (TrackIds{3}));
+    EXPECT_EQ(m_index.candidates(QStringLiteral("radiohead")), (TrackIds{2, 5}));
+}
+
+TEST_F(TrackSearchIndexTest, FilterIndexedTracksMatchesLinearFilter)
+{
+    const QStringList searches{QStringLiteral("radiohead"), QStringLiteral("tear"), QStringLiteral("ok"),
+                               QStringLiteral("zzz")};
+
+    for(const QString& search : searches) {
+        EXPECT_EQ(sortedIds(Filter::filterIndexedTracks(m_index, search, m_tracks)),
+                  ids(Filter::filterTracks(m_tracks, search)))
+            << search.toStdString();
+    }
+}
+
+TEST_F(TrackSearchIndexTest, QueuedUpdatesAreSearchable)
+{
+    Track track = m_tracks.at(2);
+    track.setAlbum(QStringLiteral("Protection"));
+    m_index.updateTracks({track});
+    m_index.addTracks({makeTrack(5, QStringLiteral("Airbag"), QStringLiteral("Radiohead"),
+                                 QStringLiteral("OK Computer"))});
+    m_index.removeTracks({m_tracks.at(0)});
+
+    // Whether or not the updates have been applied yet, they must be found
+    const auto airbag = m_index.candidates(QStringLiteral("airbag"));
+    ASSERT_TRUE(airbag.has_value());
+    EXPECT_TRUE(std::ranges::binary_search(*airbag, 5));
+
+    EXPECT_EQ(sortedIds(Filter::filterIndexedTracks(m_index, QStringLiteral("radiohead"), m_tracks)),
+              (TrackIds{2, 5}));
+    EXPECT_EQ(ids(Filter::filterIndexedTracks(m_index, QStringLiteral("protection"), m_tracks)), (TrackIds{3}));
+
+    m_index.waitForUpdates();
+    EXPECT_EQ(m_index.candidates(QStringLiteral("radiohead")), (TrackIds{2, 5}));
+}
+
+TEST(TrackSearchIndexBenchmark, LargeLibrary)
+{
+    static constexpr int TrackCount = 200000;
+
+    TrackList tracks;
+    tracks.reserve(TrackCount);
+    for(int i{0}; i < TrackCount; ++i) {
+        tracks.push_back(makeTrack(i, QStringLiteral("Track %1").arg(i), QStringLiteral("Artist %1").arg(i % 5000),
+                                   QStringLiteral("Album %1").arg(i % 20000)));
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    TrackSearchIndex index;
+    index.build(tracks);
+    index.waitForUpdates();
+
+    const auto buildTime = timer.nsecsElapsed();
+
+    const QStringList searches{QStringLiteral("artist 123"), QStringLiteral("album 19999"),
+                               QStringLiteral("track 4242"), QStringLiteral("nothing")};
+
+    timer.restart();
+    for(const QString& search : searches) {
+        ASSERT_TRUE(index.candidates(search).has_value());
+    }
+    const auto queryTime = static_cast<double>(timer.nsecsElapsed()) / static_cast<double>(searches.size());
+
+    size_t matched{0};
+    timer.restart();
+    for(const QString& search : searches) {
+        matched += Filter::filterIndexedTracks(index, search, tracks).size();
+    }
+    const auto filterTime = static_cast<double>(timer.nsecsElapsed()) / static_cast<double>(searches.size());
+
+    recordResult("BuildMs", static_cast<double>(buildTime) / 1e6);
+    recordResult("QueryMs", queryTime / 1e6);
+    recordResult("FilterMs", filterTime / 1e6);
+    EXPECT_GT(matched, 0);
+
+    for(const QString& search : searches) {
+        EXPECT_EQ(ids(Filter::filterTracks(tracks, search, index)), ids(Filter::filterTracks(tracks, search)));
+        EXPECT_EQ(sortedIds(Filter::filterIndexedTracks(index, search, tracks)),
+                  sortedIds(Filter::filterTracks(tracks, search)));
+    }
+}
+} // namespace Fooyin::Testing
@@ -0,0 +1,89 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <core/library/tracksort.h>
+#include <core/track.h>
+
+#include <gtest/gtest.h>
+
+namespace {
+Fooyin::Track makeTrack(int id, const QString& title, int trackNumber)
+{
+    Fooyin::Track track{QStringLiteral("/music/%1.flac").arg(title)};
+    track.setId(id);
+    track.setTitle(title);
+    track.setTrackNumber(trackNumber);
+    return track;
+}
+
+std::vector<int> ids(const Fooyin::TrackList& tracks)
+{
+    std::vector<int> trackIds;
+    for(const auto& track : tracks) {
+        trackIds.push_back(track.id());
+    }
+    return trackIds;
+}
+} // namespace
+
+namespace Fooyin::Testing {
+TEST(TrackSortTest, SortIndexesNumericAndStable)
+{
+    const Sorting::SortKeys keys{QStringLiteral("10"), QStringLiteral("2"), QStringLiteral("b"), QStringLiteral("2"),
+                                 QStringLiteral("a")};
+
+    EXPECT_EQ((std::vector<int>{1, 3, 0, 4, 2}), Sorting::sortIndexes(keys));
+    EXPECT_EQ((std::vector<int>{2, 4, 0, 1, 3}), Sorting::sortIndexes(keys, Qt::DescendingOrder));
+}
+
+TEST(TrackSortTest, CalcSortTracksLeavesTracksUntouched)
+{
+    const TrackList tracks{makeTrack(1, QStringLiteral("C"), 3), makeTrack(2, QStringLiteral("A"), 10),
+                           makeTrack(3, QStringLiteral("B"), 2)};
+
+    const TrackList sorted = Sorting::calcSortTracks(QStringLiteral("%track%"), tracks);
+
+    EXPECT_EQ((std::vector<int>{3, 1, 2}), ids(sorted));
+    for(const Track& track : sorted) {
+        EXPECT_TRUE(track.sort().isEmpty());
+    }
+}
+
+TEST(TrackSortTest, CalcSortTracksIndexes)
+{
+    const TrackList tracks{makeTrack(1, QStringLiteral("C"), 0), makeTrack(2, QStringLiteral("Z"), 0),
+                           makeTrack(3, QStringLiteral("A"), 0), makeTrack(4, QStringLiteral("B"), 0)};
+
+    const TrackList sorted = Sorting::calcSortTracks(QStringLiteral("%title%"), tracks, {0, 2, 3});
+
+    EXPECT_EQ((std::vector<int>{3, 2, 4, 1}), ids(sorted));
+}
+
+TEST(TrackSortTest, CalcSortFieldsKeepsKeys)
+{
+    const TrackList tracks{makeTrack(1, QStringLiteral("B"), 0), makeTrack(2, QStringLiteral("A"), 0)};
+
+    const TrackList keyed  = Sorting::calcSortFields(QStringLiteral("%title%"), tracks);
+    const TrackList sorted = Sorting::sortTracks(keyed);
+
+    EXPECT_EQ((std::vector<int>{2, 1}), ids(sorted));
+    EXPECT_EQ(u"A", sorted.front().sort());
+    EXPECT_TRUE(tracks.front().sort().isEmpty());
+}
+} // namespace Fooyin::Testing
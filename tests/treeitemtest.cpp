@@ -0,0 +1,170 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "testutils.h"
+
+#include <utils/treeitem.h>
+
+#include <QElapsedTimer>
+
+#include <gtest/gtest.h>
+
+#include <deque>
+#include <utility>
+
+// clazy:excludeall=returning-void-expression
+
+namespace {
+constexpr auto ChildCount = 100000;
+
+class Node : public Fooyin::TreeItem<Node>
+{
+public:
+    using TreeItem::TreeItem;
+};
+
+void expectRows(const Node& parent)
+{
+    const auto& children = parent.children();
+    for(int i{0}; std::cmp_less(i, children.size()); ++i) {
+        ASSERT_EQ(children.at(i)->row(), i);
+        ASSERT_EQ(children.at(i)->parent(), &parent);
+        ASSERT_TRUE(parent.hasChild(children.at(i)));
+    }
+}
+} // namespace
+
+namespace Fooyin::Testing {
+TEST(TreeItemTest, RowsFollowInsertAndRemove)
+{
+    std::deque<Node> nodes(10);
+    Node root;
+
+    for(int i{0}; i < 5; ++i) {
+        root.appendChild(&nodes.at(i));
+    }
+    expectRows(root);
+
+    root.insertChild(2, &nodes.at(5));
+    root.insertChildren(0, {&nodes.at(6), &nodes.at(7)});
+    expectRows(root);
+    EXPECT_EQ(nodes.at(5).row(), 4);
+
+    root.removeChild(3);
+    root.removeChildren(0, 2);
+    expectRows(root);
+    EXPECT_EQ(root.childCount(), 5);
+    EXPECT_FALSE(root.hasChild(&nodes.at(6)));
+}
+
+TEST(TreeItemTest, RowsFollowMove)
+{
+    std::deque<Node> nodes(6);
+    Node source;
+    Node target;
+
+    for(int i{0}; i < 4; ++i) {
+        source.appendChild(&nodes.at(i));
+    }
+    target.appendChild(&nodes.at(4));
+    target.appendChild(&nodes.at(5));
+
+    // Moved the same way PlaylistModel moves dropped rows
+    Node* moved = &nodes.at(1);
+    target.insertChild(1, moved);
+    source.removeChild(1);
+
+    expectRows(source);
+    expectRows(target);
+    EXPECT_EQ(moved->row(), 1);
+    EXPECT_EQ(nodes.at(5).row(), 2);
+}
+
+TEST(TreeItemTest, MoveChildrenMatchesSingleMoves)
+{
+    std::deque<Node> nodes(10);
+    Node source;
+    Node target;
+
+    for(int i{0}; i < 6; ++i) {
+        source.appendChild(&nodes.at(i));
+    }
+    for(int i{6}; i < 10; ++i) {
+        target.appendChild(&nodes.at(i));
+    }
+
+    // Forwards under the same parent, placed before the child at row 5
+    int next = source.moveChildren(&source, {&nodes.at(1), &nodes.at(2)}, 5);
+    EXPECT_EQ(next, 5);
+    expectRows(source);
+    EXPECT_EQ(source.children(),
+              (std::vector<Node*>{&nodes.at(0), &nodes.at(3), &nodes.at(4), &nodes.at(1), &nodes.at(2), &nodes.at(5)}));
+
+    // Backwards under the same parent
+    next = source.moveChildren(&source, {&nodes.at(2), &nodes.at(5)}, 1);
+    EXPECT_EQ(next, 3);
+    expectRows(source);
+    EXPECT_EQ(source.children(),
+              (std::vector<Node*>{&nodes.at(0), &nodes.at(2), &nodes.at(5), &nodes.at(3), &nodes.at(4), &nodes.at(1)}));
+
+    // To another parent
+    next = target.moveChildren(&source, {&nodes.at(3), &nodes.at(4)}, 2);
+    EXPECT_EQ(next, 4);
+    expectRows(source);
+    expectRows(target);
+    EXPECT_EQ(source.children(), (std::vector<Node*>{&nodes.at(0), &nodes.at(2), &nodes.at(5), &nodes.at(1)}));
+    EXPECT_EQ(target.children(),
+              (std::vector<Node*>{&nodes.at(6), &nodes.at(7), &nodes.at(3), &nodes.at(4), &nodes.at(8), &nodes.at(9)}));
+}
+
+TEST(TreeItemTest, BulkOperationsUnderOneParent)
+{
+    std::deque<Node> nodes(ChildCount);
+    std::vector<Node*> children;
+    children.reserve(ChildCount);
+    for(Node& node : nodes) {
+        children.emplace_back(&node);
+    }
+
+    Node root;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    root.insertChildren(0, children);
+
+    // Walk every row, as the model does for each index it creates
+    int64_t rowSum{0};
+    for(const Node* child : root.children()) {
+        rowSum += child->row();
+    }
+
+    root.removeChildren(ChildCount / 4, ChildCount / 2);
+
+    // Move a quarter of the remaining children to the end in one go
+    const std::vector<Node*> moved{root.children().cbegin(), root.children().cbegin() + ChildCount / 8};
+    root.moveChildren(&root, moved, root.childCount());
+
+    recordResult("InsertWalkRemoveMoveMs", static_cast<double>(timer.nsecsElapsed()) / 1e6);
+
+    EXPECT_EQ(rowSum, static_cast<int64_t>(ChildCount) * (ChildCount - 1) / 2);
+    EXPECT_EQ(root.childCount(), ChildCount / 2);
+    expectRows(root);
+}
+} // namespace Fooyin::Testing